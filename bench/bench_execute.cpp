@@ -0,0 +1,96 @@
+/**
+ * @file bench_execute.cpp
+ * @brief Execute benchmark: full stable sort vs selection of the rating bands
+ * (scaling from 1 to N threads) vs the rating index
+ * @details Usage: bench_execute [records] [max threads] (default 2000000, one per core)
+ */
+
+#include "../inc/literature_store.h"
+#include "../inc/thread_pool.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+static void fillSample(LiteratureStore& store, size_t count) {
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<> yearDist(1800, 2024);
+    std::uniform_real_distribution<> ratingDist(0.0, 10.0);
+
+    store.Reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        Literature lit;
+        lit.Author.push_back("Author " + std::to_string(gen() % 1000));
+        lit.Name = "Book " + std::to_string(i);
+        lit.Year = yearDist(gen);
+        lit.Publisher = "Publisher " + std::to_string(gen() % 50);
+        lit.Rating = std::round(ratingDist(gen) * 10.0) / 10.0;
+        store.Append(lit);
+    }
+}
+
+template <typename Fn>
+static double timeMs(Fn&& fn) {
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+// The previous Execute: stable sort of all indices by rating
+static std::vector<size_t> sortBands(const LiteratureStore& store) {
+    const auto& ratings = store.Ratings();
+    std::vector<size_t> order(store.Size());
+    for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [&ratings](size_t a, size_t b) {
+        return ratings[a] < ratings[b];
+    });
+    size_t tenPercent = std::max(size_t(1), order.size() / 10);
+    std::vector<size_t> result(order.begin(), order.begin() + tenPercent);
+    result.insert(result.end(), order.begin() + std::max(order.size() - tenPercent, tenPercent), order.end());
+    return result;
+}
+
+int main(int argc, char* argv[]) {
+    size_t count = argc > 1 ? std::stoul(argv[1]) : 2000000;
+    size_t maxThreads = argc > 2 ? std::stoul(argv[2]) : std::max(1u, std::thread::hardware_concurrency());
+
+    LiteratureStore store;
+    fillSample(store, count);
+
+    std::cout << "=== Execute benchmark (" << count << " records) ===" << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+
+    std::vector<size_t> sorted, selected;
+    double sortMs = timeMs([&]() { sorted = sortBands(store); });
+    std::cout << "full stable sort:  " << sortMs << " ms" << std::endl;
+    bool ok = true;
+
+    // Selection without the rating index, doubling thread counts up to the maximum
+    store.IndexRatings(false);
+    double singleMs = 0.0;
+    for (size_t threads = 1; threads <= maxThreads; threads = threads < maxThreads ? std::min(threads * 2, maxThreads) : threads + 1) {
+        ThreadPool pool(threads);
+        double selectMs = timeMs([&]() { store.PercentileBand("Rating", 0.1, 0.1, selected, pool); });
+        if (threads == 1) singleMs = selectMs;
+        ok = ok && selected == sorted;
+        std::cout << "selection, " << std::setw(3) << threads << " threads: " << std::setw(8) << selectMs
+                  << " ms  (x" << std::setprecision(2) << singleMs / selectMs << std::setprecision(1) << ")"
+                  << std::endl;
+    }
+
+    // Rating index: built once, then each band is read in O(k)
+    double buildMs = timeMs([&]() { store.IndexRatings(true); });
+    double indexMs = timeMs([&]() { store.PercentileBand("Rating", 0.1, 0.1, selected); });
+    ok = ok && selected == sorted;
+    std::cout << "rating index:      " << indexMs << " ms  (build " << buildMs << " ms)" << std::endl;
+
+    double applyMs = timeMs([&]() { store = store.Select(selected); });
+    std::cout << "copy kept records: " << applyMs << " ms (" << store.Size() << " kept)" << std::endl;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,107 @@
+/**
+ * @file bench_formats.cpp
+ * @brief Snapshot format benchmark: file size, save and load time per format
+ * (including the memory-mapped columnar snapshot)
+ * @details Usage: bench_formats [records] (default 200000)
+ */
+
+#include "../inc/literature_store.h"
+#include "../inc/literature_loader.h"
+#include "../inc/literature_writer.h"
+#include "../inc/literature_snapshot.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+
+static void fillSample(LiteratureStore& store, size_t count) {
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<> yearDist(1800, 2024);
+    std::uniform_int_distribution<> authorCountDist(1, 3);
+    std::uniform_real_distribution<> ratingDist(0.0, 10.0);
+
+    store.Reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        Literature lit;
+        for (int k = authorCountDist(gen); k > 0; --k) {
+            lit.Author.push_back("Author " + std::to_string(gen() % 1000));
+        }
+        lit.Name = "Book title number " + std::to_string(i);
+        lit.Year = yearDist(gen);
+        lit.Publisher = "Publisher " + std::to_string(gen() % 50);
+        lit.Rating = std::round(ratingDist(gen) * 10.0) / 10.0;
+        store.Append(lit, "LIT" + std::to_string(i) + "BOO");
+    }
+}
+
+template <typename Fn>
+static double timeMs(Fn&& fn) {
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+static std::streamoff fileSize(const std::string& filename) {
+    std::ifstream file(filename, std::ios::binary | std::ios::ate);
+    return file.is_open() ? static_cast<std::streamoff>(file.tellg()) : 0;
+}
+
+int main(int argc, char* argv[]) {
+    size_t count = argc > 1 ? std::stoul(argv[1]) : 200000;
+    const std::string filename = "bench_formats.dat";
+
+    LiteratureStore store;
+    fillSample(store, count);
+
+    std::cout << "=== Format benchmark (" << count << " records) ===" << std::endl;
+    std::cout << std::left << std::setw(10) << "format" << std::right << std::setw(12) << "size MB"
+              << std::setw(12) << "save ms" << std::setw(12) << "load ms" << std::endl;
+
+    const DataFormat formats[] = {DataFormat::Json, DataFormat::NDJSON, DataFormat::Cbor,
+                                  DataFormat::MessagePack, DataFormat::Ubjson};
+    bool ok = true;
+    for (DataFormat format : formats) {
+        double saveMs = timeMs([&]() {
+            std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+            WriteLiterature(file, store, format);
+        });
+        double sizeMb = fileSize(filename) / (1024.0 * 1024.0);
+
+        // Loaded without a format hint, so detection is part of the measurement
+        LiteratureStore loaded;
+        LoadReport report;
+        double loadMs = timeMs([&]() {
+            ok = LoadLiteratureFile(filename, DataFormat::Auto, loaded, report) && ok;
+        });
+        ok = ok && report.Ok() && loaded.Size() == store.Size();
+
+        std::cout << std::fixed << std::setprecision(1) << std::left << std::setw(10) << DataFormatName(format)
+                  << std::right << std::setw(12) << sizeMb << std::setw(12) << saveMs << std::setw(12)
+                  << loadMs << std::endl;
+    }
+
+    // Columnar snapshot: opening only maps the file; the scan pages in one column
+    std::string error;
+    double saveMs = timeMs([&]() { ok = LiteratureSnapshot::Save(filename, store, error) && ok; });
+    double sizeMb = fileSize(filename) / (1024.0 * 1024.0);
+    LiteratureStore mapped;
+    double openMs = timeMs([&]() { ok = LiteratureSnapshot::Open(filename, mapped, error) && ok; });
+    double verifyMs = timeMs([&]() { ok = LiteratureSnapshot::Open(filename, mapped, error, true) && ok; });
+    double ratingSum = 0.0;
+    double scanMs = timeMs([&]() {
+        for (double rating : mapped.Ratings()) ratingSum += rating;
+    });
+    ok = ok && mapped.Size() == store.Size() && ratingSum >= 0.0;
+
+    std::cout << std::left << std::setw(10) << "snapshot" << std::right << std::setw(12) << sizeMb
+              << std::setw(12) << saveMs << std::setw(12) << openMs << "  (verified open " << verifyMs
+              << " ms, rating scan " << std::setprecision(2) << scanMs << " ms)" << std::endl;
+
+    std::remove(filename.c_str());
+    return ok ? 0 : 1;
+}
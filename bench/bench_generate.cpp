@@ -0,0 +1,94 @@
+/**
+ * @file bench_generate.cpp
+ * @brief Generation benchmark: one JSON item at a time vs the parallel
+ * chunked generator (1..N threads) and the default synthetic workload
+ * @details Usage: bench_generate [records] (default 2000000)
+ */
+
+#include "../inc/literature_generator.h"
+#include "../inc/workload_generator.h"
+#include "../inc/literature_id.h"
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+// The former per-item path: sample tables, a seeded mt19937 and a JSON object per record
+static void generatePerItem(LiteratureStore& store, IdAllocator& ids, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        std::vector<std::string> sampleAuthors = {
+            "Leo Tolstoy", "Fyodor Dostoevsky", "Anton Chekhov", "Alexander Pushkin",
+            "Nikolai Gogol", "Ivan Turgenev", "Vladimir Nabokov", "Mikhail Bulgakov"};
+        std::vector<std::string> sampleNames = {
+            "War and Peace", "Crime and Punishment", "Anna Karenina", "The Brothers Karamazov",
+            "Dead Souls", "Fathers and Sons", "The Master and Margarita", "Eugene Onegin"};
+        std::vector<std::string> samplePublishers = {
+            "Penguin Classics", "Oxford University Press", "Vintage Books",
+            "Modern Library", "Everyman's Library", "Dover Publications"};
+        std::mt19937 gen(static_cast<unsigned>(i));
+        json item;
+        std::vector<std::string> authors(std::uniform_int_distribution<>(1, 3)(gen));
+        for (auto& author : authors) {
+            author = sampleAuthors[std::uniform_int_distribution<>(0, 7)(gen)];
+        }
+        std::string name = sampleNames[std::uniform_int_distribution<>(0, 7)(gen)];
+        item["Author"] = authors;
+        item["Name"] = name;
+        item["Year"] = std::uniform_int_distribution<>(1800, 2024)(gen);
+        item["Publisher"] = samplePublishers[std::uniform_int_distribution<>(0, 5)(gen)];
+        item["Rating"] = std::round(std::uniform_real_distribution<>(0.0, 10.0)(gen) * 10.0) / 10.0;
+        item["ID"] = FormatLiteratureID(ids.Next(), name);
+        store.AppendJson(item);
+    }
+}
+
+template <typename Fn>
+static double timeMs(Fn&& fn) {
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+int main(int argc, char* argv[]) {
+    size_t count = argc > 1 ? std::stoul(argv[1]) : 2000000;
+
+    std::cout << "=== Generation benchmark (" << count << " records) ===" << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+
+    {
+        LiteratureStore store;
+        IdAllocator ids;
+        double ms = timeMs([&]() { generatePerItem(store, ids, count); });
+        std::cout << std::left << std::setw(24) << "per-item JSON" << std::right << std::setw(12) << ms << " ms"
+                  << std::setw(14) << count / ms * 1000.0 << " records/s" << std::endl;
+    }
+
+    std::vector<size_t> threadCounts = {1, 2, 4};
+    size_t cores = std::thread::hardware_concurrency();
+    if (cores > 4) threadCounts.push_back(cores);
+    for (size_t threads : threadCounts) {
+        ThreadPool pool(threads);
+        LiteratureStore store;
+        IdAllocator ids;
+        double ms = timeMs([&]() { GenerateLiterature(count, 42, ids, store, pool); });
+        std::string label = "parallel, " + std::to_string(threads) + " threads";
+        std::cout << std::left << std::setw(24) << label << std::right << std::setw(12) << ms << " ms"
+                  << std::setw(14) << count / ms * 1000.0 << " records/s" << std::endl;
+    }
+
+    // Zipf vocabularies, normal ratings, one generator per record
+    {
+        LiteratureStore store;
+        IdAllocator ids;
+        WorkloadGenerator workload{WorkloadSpec()};
+        double ms = timeMs([&]() { GenerateWorkload(workload, count, ids, store); });
+        std::cout << std::left << std::setw(24) << "workload, shared pool" << std::right << std::setw(12) << ms
+                  << " ms" << std::setw(14) << count / ms * 1000.0 << " records/s" << std::endl;
+    }
+    return 0;
+}
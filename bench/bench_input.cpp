@@ -0,0 +1,126 @@
+/**
+ * @file bench_input.cpp
+ * @brief Input benchmark: nlohmann DOM parse vs streaming SAX loader (stream and mmap)
+ * @details Usage: bench_input [records] (default 200000)
+ */
+
+#include "../inc/literature_store.h"
+#include "../inc/literature_loader.h"
+#include "../inc/mapped_file.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+// Peak resident set size of the process in megabytes (0 if unavailable)
+static double peakRssMb() {
+#ifndef _WIN32
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss / 1024.0;
+#else
+    return 0.0;
+#endif
+}
+
+static void writeSampleFile(const std::string& filename, size_t count) {
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<> yearDist(1800, 2024);
+    std::uniform_int_distribution<> authorCountDist(1, 3);
+    std::uniform_real_distribution<> ratingDist(0.0, 10.0);
+
+    LiteratureStore store;
+    store.Reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        Literature lit;
+        for (int k = authorCountDist(gen); k > 0; --k) {
+            lit.Author.push_back("Author " + std::to_string(gen() % 1000));
+        }
+        lit.Name = "Book title number " + std::to_string(i);
+        lit.Year = yearDist(gen);
+        lit.Publisher = "Publisher " + std::to_string(gen() % 50);
+        lit.Rating = std::round(ratingDist(gen) * 10.0) / 10.0;
+        store.Append(lit, "LIT" + std::to_string(i) + "BOO");
+    }
+
+    // Written record by record so the generator does not inflate the peak RSS
+    std::ofstream file(filename);
+    file << "[\n";
+    for (size_t i = 0; i < store.Size(); ++i) {
+        file << "    " << store.RecordToJson(i).dump() << (i + 1 < store.Size() ? ",\n" : "\n");
+    }
+    file << "]" << std::endl;
+}
+
+template <typename Fn>
+static double timeMs(Fn&& fn) {
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+int main(int argc, char* argv[]) {
+    size_t count = argc > 1 ? std::stoul(argv[1]) : 200000;
+    const std::string filename = "bench_input.json";
+
+    std::cout << "=== Input benchmark (" << count << " records) ===" << std::endl;
+    writeSampleFile(filename, count);
+    double baseRss = peakRssMb();
+
+    // SAX first: the peak RSS only grows, so the DOM run shows its extra cost on top
+    LiteratureStore saxStore;
+    LoadReport report;
+    double saxMs = timeMs([&]() {
+        std::ifstream file(filename);
+        report = LoadLiterature(file, saxStore);
+    });
+    double saxRss = peakRssMb();
+
+    LiteratureStore mappedStore;
+    LoadReport mappedReport;
+    double mappedMs = timeMs([&]() {
+        MappedFile file;
+        file.Open(filename);
+        mappedReport = LoadLiterature(file.Data(), file.Data() + file.Size(), mappedStore);
+    });
+
+    LiteratureStore parallelStore;
+    LoadReport parallelReport;
+    double parallelMs = timeMs([&]() {
+        MappedFile file;
+        file.Open(filename);
+        parallelReport = LoadLiteratureParallel(file.Data(), file.Data() + file.Size(), parallelStore);
+    });
+
+    LiteratureStore domStore;
+    double domMs = timeMs([&]() {
+        std::ifstream file(filename);
+        json data;
+        file >> data;
+        domStore = LiteratureStore::FromJson(data);
+    });
+    double domRss = peakRssMb();
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "DOM  (file >> json, FromJson): " << domMs << " ms, peak RSS +"
+              << (domRss - saxRss) << " MB over SAX peak" << std::endl;
+    std::cout << "SAX  (LoadLiterature):         " << saxMs << " ms, peak RSS +"
+              << (saxRss - baseRss) << " MB" << std::endl;
+    std::cout << "mmap (MappedFile + SAX):       " << mappedMs << " ms" << std::endl;
+    std::cout << "mmap + parallel chunks (" << ThreadPool::Shared().Size() << " threads): "
+              << parallelMs << " ms" << std::endl;
+    std::cout << "Speedup: " << std::setprecision(2) << domMs / saxMs << "x, records loaded: "
+              << report.Records << "/" << domStore.Size() << std::endl;
+
+    std::remove(filename.c_str());
+    return report.Ok() && mappedReport.Ok() && report.Records == domStore.Size() &&
+           mappedReport.Records == domStore.Size() && parallelReport.Records == domStore.Size() ? 0 : 1;
+}
@@ -0,0 +1,114 @@
+/**
+ * @file bench_query.cpp
+ * @brief Query benchmark: column scans vs the secondary indexes, and ID
+ * lookups by scan vs the ID hash index
+ * @details Usage: bench_query [records] (default 2000000)
+ */
+
+#include "../inc/literature_store.h"
+#include "../inc/record_predicate.h"
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+static void fillSample(LiteratureStore& store, size_t count) {
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<> yearDist(1800, 2024);
+    std::uniform_real_distribution<> ratingDist(0.0, 10.0);
+
+    store.Reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        Literature lit;
+        lit.Author.push_back("Author " + std::to_string(gen() % 1000));
+        if (gen() % 4 == 0) {
+            lit.Author.push_back("Author " + std::to_string(gen() % 100));  // Co-author
+        }
+        lit.Name = "Book " + std::to_string(i % 100000);
+        lit.Year = yearDist(gen);
+        lit.Publisher = "Publisher " + std::to_string(gen() % 5000);
+        lit.Rating = std::round(ratingDist(gen) * 10.0) / 10.0;
+        store.Append(lit, "LIT" + std::to_string(i) + "BOO");
+    }
+}
+
+template <typename Fn>
+static double timeMs(Fn&& fn) {
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+int main(int argc, char* argv[]) {
+    size_t count = argc > 1 ? std::stoul(argv[1]) : 2000000;
+
+    LiteratureStore store;
+    fillSample(store, count);
+
+    std::cout << "=== Query benchmark (" << count << " records) ===" << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+
+    const char* conditions[] = {
+        "Publisher = 'Publisher 17'",
+        "Name = 'Book 4242'",
+        "Year = 1999",
+        "Year BETWEEN 1990 AND 1991 AND Rating >= 9.9",
+        "Publisher = 'Publisher 17' AND Year > 2000",
+        "Publisher = 'Publisher 17' OR Publisher = 'Publisher 18'",
+        "Author = 'Author 7'",
+        "Author = 'Author 7' AND Author = 'Author 8'",
+    };
+    std::vector<std::vector<size_t>> scanned;
+    std::cout << std::left << std::setw(60) << "condition" << std::right << std::setw(10) << "matches"
+              << std::setw(12) << "scan ms" << std::setw(12) << "index ms" << std::endl;
+    std::vector<double> scanMs;
+    for (const char* condition : conditions) {
+        RecordPredicate predicate;
+        std::string error;
+        RecordPredicate::Compile(condition, predicate, error);
+        scanned.emplace_back();
+        scanMs.push_back(timeMs([&]() { scanned.back() = predicate.Find(store); }));
+    }
+
+    double buildMs = timeMs([&]() { store.IndexFields(LiteratureStore::kIndexableFields); });
+    bool ok = true;
+    for (size_t c = 0; c < scanned.size(); ++c) {
+        RecordPredicate predicate;
+        std::string error;
+        RecordPredicate::Compile(conditions[c], predicate, error);
+        std::vector<size_t> found;
+        double indexMs = timeMs([&]() { found = predicate.Find(store); });
+        ok = ok && found == scanned[c];
+        std::cout << std::left << std::setw(60) << conditions[c] << std::right << std::setw(10) << found.size()
+                  << std::setw(12) << scanMs[c] << std::setw(12) << indexMs << std::endl;
+    }
+    // ID lookups: a scan of the ID column vs the hash index every store keeps
+    const size_t lookups = 200;
+    std::vector<std::string> wanted;
+    for (size_t k = 0; k < lookups; ++k) {
+        wanted.push_back("LIT" + std::to_string((k * 7919) % count) + "BOO");
+    }
+    size_t scanHits = 0, indexHits = 0;
+    double idScanMs = timeMs([&]() {
+        for (const auto& id : wanted) {
+            for (size_t i = 0; i < store.Size(); ++i) {
+                if (store.ID(i) == id) { ++scanHits; break; }
+            }
+        }
+    });
+    double idIndexMs = timeMs([&]() {
+        for (const auto& id : wanted) {
+            indexHits += store.FindID(id) != IdIndex::kNotFound;
+        }
+    });
+    ok = ok && scanHits == lookups && indexHits == lookups;
+    std::cout << "ID lookup: scan " << idScanMs * 1000.0 / lookups << " us, index "
+              << idIndexMs * 1000.0 / lookups << " us per ID" << std::endl;
+    std::cout << "index build: " << buildMs << " ms, index memory: "
+              << store.IndexMemoryUsage() / (1024.0 * 1024.0) << " MB" << std::endl;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,124 @@
+/**
+ * @file checkpointer.h
+ * @brief Background snapshots of a live LiteratureStore
+ *
+ * @details A checkpoint takes a frozen version of the dataset through a
+ * caller-supplied callback (LiteratureStore::Freeze() under the owner's lock,
+ * O(1)), then writes it as a columnar snapshot to a temporary file on the
+ * checkpoint thread, fsyncs it and renames it over the target. The owner
+ * keeps mutating the live store the whole time.
+ */
+
+#ifndef CHECKPOINTER_H
+#define CHECKPOINTER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "literature_store.h"
+
+/**
+ * @struct CheckpointOptions
+ * @brief Checkpoint configuration
+ */
+struct CheckpointOptions {
+    std::string Path;                           ///< Snapshot file to replace
+    std::chrono::milliseconds Interval{60000};  ///< Time between checkpoints, 0 for on demand only
+};
+
+/**
+ * @struct CheckpointStats
+ * @brief Outcome of the checkpoints so far
+ */
+struct CheckpointStats {
+    std::uint64_t Completed = 0;    ///< Successful checkpoints
+    std::uint64_t Failed = 0;       ///< Failed checkpoints
+    double LastFreezeMs = 0.0;      ///< Time spent in the freeze callback (owner's lock held)
+    double LastDurationMs = 0.0;    ///< Time to write, sync and rename the last snapshot
+    std::uint64_t LastBytes = 0;    ///< Size of the last snapshot
+    std::uint64_t LastRecords = 0;  ///< Records in the last snapshot
+    std::uint64_t LastSequence = 0; ///< Sequence number stored in the last snapshot
+    std::string LastError;          ///< Error of the last failed checkpoint
+    bool InProgress = false;        ///< A checkpoint is being written
+};
+
+/**
+ * @class Checkpointer
+ * @brief Writes snapshots periodically or on demand on its own thread
+ */
+class Checkpointer {
+public:
+    /**
+     * @brief Frozen dataset handed to the checkpoint thread
+     */
+    struct Version {
+        LiteratureStore Store;       ///< Result of LiteratureStore::Freeze()
+        std::uint64_t Sequence = 0;  ///< Stored in the snapshot header, e.g. last log entry
+    };
+
+    using FreezeFunction = std::function<Version()>;
+    using CompleteFunction = std::function<void(std::uint64_t sequence)>;
+
+    /**
+     * @brief Configure a checkpointer; no thread runs until Start()
+     * @param options Snapshot path and interval
+     * @param freeze Returns a frozen version; called on the checkpoint thread
+     * @param complete Called after a snapshot is durable, e.g. to trim a log
+     */
+    Checkpointer(CheckpointOptions options, FreezeFunction freeze, CompleteFunction complete = nullptr);
+
+    /**
+     * @brief Stop the thread, letting a running checkpoint finish
+     */
+    ~Checkpointer();
+
+    Checkpointer(const Checkpointer&) = delete;
+    Checkpointer& operator=(const Checkpointer&) = delete;
+
+    /**
+     * @brief Start the checkpoint thread
+     */
+    void Start();
+
+    /**
+     * @brief Stop the checkpoint thread
+     */
+    void Stop();
+
+    /**
+     * @brief Ask the thread for a checkpoint now, without waiting for it
+     */
+    void Trigger();
+
+    /**
+     * @brief Write a checkpoint on the calling thread
+     * @return true if the snapshot was written
+     */
+    bool RunNow();
+
+    /**
+     * @brief Counters and timings of the checkpoints so far
+     */
+    CheckpointStats GetStats() const;
+
+private:
+    void Loop();
+
+    CheckpointOptions options;
+    FreezeFunction freeze;
+    CompleteFunction complete;
+
+    std::mutex runMutex;  ///< One checkpoint at a time
+    mutable std::mutex stateMutex;
+    std::condition_variable wake;
+    bool triggered = false;
+    bool stopping = false;
+    CheckpointStats stats;
+    std::thread worker;
+};
+
+#endif // CHECKPOINTER_H
@@ -0,0 +1,40 @@
+/**
+ * @file checksum.h
+ * @brief 64-bit checksum shared by the snapshot and log file formats
+ */
+
+#ifndef CHECKSUM_H
+#define CHECKSUM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+/**
+ * @brief Checksum of a byte range
+ * @details FNV-1a steps over 8-byte words in machine byte order (the tail is
+ * zero padded), so it runs at memory speed. Detects corruption, not tampering.
+ * @param data First byte
+ * @param size Number of bytes
+ * @return 64-bit checksum
+ */
+inline std::uint64_t Checksum64(const void* data, std::size_t size) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    std::uint64_t hash = 0xcbf29ce484222325ULL;
+    const std::uint64_t prime = 0x100000001b3ULL;
+
+    std::size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        std::uint64_t word;
+        std::memcpy(&word, bytes + i, 8);
+        hash = (hash ^ word) * prime;
+    }
+    if (i < size) {
+        std::uint64_t word = 0;
+        std::memcpy(&word, bytes + i, size - i);
+        hash = (hash ^ word) * prime;
+    }
+    return (hash ^ size) * prime;
+}
+
+#endif // CHECKSUM_H
@@ -0,0 +1,215 @@
+/**
+ * @file field_index.h
+ * @brief Secondary indexes from field values to record positions
+ */
+
+#ifndef FIELD_INDEX_H
+#define FIELD_INDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/// Highest record position a posting list holds; later records are not
+/// indexed, and lookups scan them (see LiteratureStore::IndexLookup())
+constexpr std::size_t kMaxPostingRecord = 0xffffffffu;
+
+/**
+ * @class TextIndex
+ * @brief Hash index for equality lookups on a string field
+ *
+ * @details Every distinct value owns a posting list with the positions of
+ * its records in ascending order. As with RatingIndex, records must be added
+ * in increasing position order, which is the order a store appends them in.
+ */
+class TextIndex {
+public:
+    /**
+     * @brief Index a record appended after all indexed ones
+     * @param record Position of the record; ignored past kMaxPostingRecord
+     * @param value Its field value
+     */
+    void Add(std::size_t record, std::string_view value);
+
+    /**
+     * @brief Remove the record added last
+     * @param record Position of the record
+     * @param value Its field value
+     */
+    void RemoveLast(std::size_t record, std::string_view value);
+
+    /**
+     * @brief Remove all records
+     */
+    void Clear() { postings.clear(); }
+
+    /**
+     * @brief Positions of the records holding a value, ascending
+     * @return Posting list, or null if no record holds the value
+     */
+    const std::vector<std::uint32_t>* Find(std::string_view value) const;
+
+    /**
+     * @brief Number of distinct values
+     */
+    std::size_t Keys() const { return postings.size(); }
+
+    /**
+     * @brief Approximate heap bytes held by the table, keys and posting lists
+     */
+    std::size_t MemoryUsage() const;
+
+private:
+    std::unordered_map<std::string, std::vector<std::uint32_t>> postings;
+};
+
+/**
+ * @class AuthorIndex
+ * @brief Inverted index from author names to the records listing them
+ *
+ * @details Each distinct name is interned once and numbered; the number
+ * selects a posting list with the ascending positions of the records that
+ * list the author, each record once even if it repeats the name. Records
+ * listing several given authors are found by intersecting their lists,
+ * shortest first, so the cost follows the rarest author. Records must be
+ * added in increasing position order.
+ */
+class AuthorIndex {
+public:
+    /**
+     * @brief Index one author of a record appended after all indexed ones
+     * @param record Position of the record; ignored past kMaxPostingRecord
+     * @param author One of its authors
+     */
+    void Add(std::size_t record, std::string_view author);
+
+    /**
+     * @brief Remove one author of the record added last
+     * @param record Position of that record
+     * @param author One of its authors
+     */
+    void RemoveLast(std::size_t record, std::string_view author);
+
+    /**
+     * @brief Remove all records and names
+     */
+    void Clear() {
+        terms.clear();
+        postings.clear();
+    }
+
+    /**
+     * @brief Positions of the records listing an author, ascending
+     * @return Posting list, or null if no record lists the author
+     */
+    const std::vector<std::uint32_t>* Find(std::string_view author) const;
+
+    /**
+     * @brief Positions of the records listing every one of some authors
+     * @param authors Names to intersect; none gives no positions
+     * @param positions Receives the positions in ascending order
+     */
+    void FindAll(const std::vector<std::string>& authors, std::vector<std::size_t>& positions) const;
+
+    /**
+     * @brief Number of interned names
+     */
+    std::size_t Keys() const { return terms.size(); }
+
+    /**
+     * @brief Approximate heap bytes held by the names and posting lists
+     */
+    std::size_t MemoryUsage() const;
+
+private:
+    std::unordered_map<std::string, std::uint32_t> terms;  ///< Interned name to its number
+    std::vector<std::vector<std::uint32_t>> postings;      ///< Posting list per name number
+};
+
+/**
+ * @class OrderedIndex
+ * @brief Ordered index for range lookups on a numeric field
+ *
+ * @details Distinct values are kept in a balanced tree, each with the
+ * ascending positions of its records, so a range costs O(log d + k) for d
+ * distinct values and k matches. Records must be added in increasing
+ * position order.
+ */
+template <typename Key>
+class OrderedIndex {
+public:
+    /**
+     * @brief Index a record appended after all indexed ones
+     * @details Positions past kMaxPostingRecord are ignored
+     */
+    void Add(std::size_t record, Key value) {
+        if (record <= kMaxPostingRecord) {
+            postings[value].push_back(static_cast<std::uint32_t>(record));
+        }
+    }
+
+    /**
+     * @brief Remove the record added last
+     */
+    void RemoveLast(std::size_t record, Key value) {
+        if (record > kMaxPostingRecord) {
+            return;
+        }
+        auto found = postings.find(value);
+        if (found == postings.end()) {
+            return;
+        }
+        found->second.pop_back();
+        if (found->second.empty()) {
+            postings.erase(found);
+        }
+    }
+
+    /**
+     * @brief Remove all records
+     */
+    void Clear() { postings.clear(); }
+
+    /**
+     * @brief Collect the positions of the values in [low, high] that accept() takes
+     * @details Positions are appended in value order, not position order
+     * @param low Smallest value to visit
+     * @param high Largest value to visit
+     * @param accept Called once per distinct value in range
+     * @param positions Receives the positions
+     */
+    template <typename Accept>
+    void Collect(Key low, Key high, Accept accept, std::vector<std::size_t>& positions) const {
+        for (auto it = postings.lower_bound(low); it != postings.end() && !(high < it->first); ++it) {
+            if (accept(it->first)) {
+                positions.insert(positions.end(), it->second.begin(), it->second.end());
+            }
+        }
+    }
+
+    /**
+     * @brief Number of distinct values
+     */
+    std::size_t Keys() const { return postings.size(); }
+
+    /**
+     * @brief Approximate heap bytes held by the tree and posting lists
+     */
+    std::size_t MemoryUsage() const {
+        // A red-black tree node carries three pointers and a colour next to the value
+        std::size_t bytes = postings.size() * (sizeof(Key) + sizeof(std::vector<std::uint32_t>) + 4 * sizeof(void*));
+        for (const auto& entry : postings) {
+            bytes += entry.second.capacity() * sizeof(std::uint32_t);
+        }
+        return bytes;
+    }
+
+private:
+    std::map<Key, std::vector<std::uint32_t>> postings;
+};
+
+#endif // FIELD_INDEX_H
@@ -0,0 +1,37 @@
+/**
+ * @file file_sync.h
+ * @brief Helpers for crash-safe file replacement
+ */
+
+#ifndef FILE_SYNC_H
+#define FILE_SYNC_H
+
+#include <string>
+
+/**
+ * @brief Force the contents of a file to stable storage (fsync)
+ * @param path File to sync
+ * @return false if the file cannot be opened or synced
+ */
+bool SyncFileData(const std::string& path);
+
+/**
+ * @brief Force a directory entry change (create, rename) to stable storage
+ * @details Syncs the directory containing path; a no-op on Windows, where
+ * renames are not synced through directory handles
+ * @param path File whose parent directory is synced
+ * @return false if the directory cannot be opened or synced
+ */
+bool SyncParentDirectory(const std::string& path);
+
+/**
+ * @brief Atomically replace target with a fully written temporary file
+ * @details Syncs the temporary file, renames it over target and syncs the
+ * directory, so after a crash target holds either the old or the new content
+ * @param temporary Fully written file in the same directory as target
+ * @param target File to replace
+ * @return false if a step fails; the temporary file is then removed
+ */
+bool DurableReplace(const std::string& temporary, const std::string& target);
+
+#endif // FILE_SYNC_H
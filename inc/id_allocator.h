@@ -0,0 +1,116 @@
+/**
+ * @file id_allocator.h
+ * @brief Thread-safe allocation of record ID numbers
+ */
+
+#ifndef ID_ALLOCATOR_H
+#define ID_ALLOCATOR_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include "literature_store.h"
+
+/**
+ * @class IdAllocator
+ * @brief Hands out increasing ID numbers that are never given twice
+ *
+ * @details Numbers come from one atomic counter: Next() is a single
+ * fetch_add, and a thread that needs many numbers, e.g. a worker of a bulk
+ * generation, leases a whole block with one Lease() and formats IDs from it
+ * without touching shared state again.
+ *
+ * Numbers already used by records are skipped: Observe() raises the counter
+ * past every loaded or replayed ID. With Persist(), the counter also
+ * survives restarts when the records carrying the highest numbers were
+ * deleted: the file holds a high-water mark above every number handed out,
+ * advanced in steps of kReserveStep, so only the allocation that crosses
+ * the mark takes a lock and writes the file.
+ */
+class IdAllocator {
+public:
+    /**
+     * @struct Block
+     * @brief Numbers leased to one caller: [Next, End)
+     */
+    struct Block {
+        std::uint64_t Next = 0;
+        std::uint64_t End = 0;
+
+        bool Empty() const { return Next == End; }
+        std::uint64_t Take() { return Next++; }
+    };
+
+    static constexpr std::uint64_t kReserveStep = 4096;  ///< Numbers covered per write of the mark
+
+    IdAllocator() = default;
+    IdAllocator(const IdAllocator&) = delete;
+    IdAllocator& operator=(const IdAllocator&) = delete;
+
+    /**
+     * @brief Keep the high-water mark in a file
+     * @details Reads the mark left by an earlier run, if any, and continues
+     * above it. The file is replaced atomically (DurableReplace()) whenever
+     * allocation crosses the mark.
+     * @param path State file
+     * @param error Receives a description of the failure
+     * @return false if an existing file cannot be read or holds no mark
+     * in the ID number range
+     */
+    bool Persist(const std::string& path, std::string& error);
+
+    /**
+     * @brief Allocate one number
+     */
+    std::uint64_t Next();
+
+    /**
+     * @brief Allocate a contiguous block of numbers
+     * @param count Numbers in the block
+     */
+    Block Lease(std::uint64_t count);
+
+    /**
+     * @brief Make sure a number in use is never handed out
+     * @details kMaxIdNumber is ignored: no formattable number follows it,
+     * and skipping past it would make every later ID malformed
+     * @param number Number carried by an existing record
+     */
+    void Observe(std::uint64_t number);
+
+    /**
+     * @brief Observe the number of an ID; malformed IDs are ignored
+     */
+    void Observe(std::string_view id);
+
+    /**
+     * @brief Observe the IDs of all records in a store
+     */
+    void Observe(const LiteratureStore& store);
+
+    /**
+     * @brief Number the next allocation returns
+     */
+    std::uint64_t Peek() const { return next.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Description of the last failure to write the state file
+     * @details Allocation continues after a failed write; the numbers
+     * stay unique within the process
+     */
+    std::string LastError() const;
+
+private:
+    void Reserve(std::uint64_t end);
+
+    std::atomic<std::uint64_t> next{1};
+    std::atomic<std::uint64_t> limit{UINT64_MAX};  ///< Numbers below it are covered by the persisted mark
+    mutable std::mutex persistMutex;  ///< Serializes writes of the state file
+    std::string statePath;
+    std::string lastError;
+};
+
+#endif // ID_ALLOCATOR_H
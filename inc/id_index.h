@@ -0,0 +1,127 @@
+/**
+ * @file id_index.h
+ * @brief Open-addressing hash index from record IDs to record positions
+ */
+
+#ifndef ID_INDEX_H
+#define ID_INDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+/**
+ * @class IdIndex
+ * @brief Linear-probing hash table of record positions keyed by ID
+ *
+ * @details Slots hold a 32-bit hash and a position, 8 bytes each, and the
+ * table stays at most half full, so a lookup usually inspects one or two
+ * adjacent slots. The IDs themselves are not copied: lookups compare
+ * against the caller's ID column through a key function. The slot of a
+ * hash is taken from the same 32 bits that are stored, so growing the table
+ * never needs the keys.
+ *
+ * Records must be added in increasing position order. Equal IDs then sit
+ * along a probe chain in position order, so Find() returns the first
+ * record carrying an ID, as a scan would. Positions above kMaxRecord do
+ * not fit a slot; they are not hashed, and lookups that miss the table
+ * scan them instead.
+ */
+class IdIndex {
+public:
+    static constexpr std::size_t kNotFound = static_cast<std::size_t>(-1);
+    static constexpr std::size_t kMaxRecord = 0xfffffffeu;  ///< Highest position a slot holds
+
+    /**
+     * @brief Hash of an ID as stored in the table
+     */
+    static std::uint32_t Hash(std::string_view id);
+
+    /**
+     * @brief Remove all records
+     */
+    void Clear();
+
+    /**
+     * @brief Make room for a number of records without rehashing
+     */
+    void Reserve(std::size_t records);
+
+    /**
+     * @brief Index a record appended after all indexed ones
+     * @param record Position of the record
+     * @param id Its ID
+     */
+    void Add(std::size_t record, std::string_view id);
+
+    /**
+     * @brief Remove the record added last
+     * @param record Position of the record
+     * @param id Its ID
+     */
+    void RemoveLast(std::size_t record, std::string_view id);
+
+    /**
+     * @brief Position of the first record with an ID
+     * @param id ID to look up
+     * @param key Returns the ID of a position, to confirm hash matches
+     * @return Position, or kNotFound
+     */
+    template <typename Key>
+    std::size_t Find(std::string_view id, Key key) const {
+        return FindIf(id, [&key, id](std::size_t position) { return key(position) == id; });
+    }
+
+    /**
+     * @brief Position of the first record with an ID's hash that passes a test
+     * @param id ID to look up
+     * @param matches Returns whether a position holds the wanted record,
+     * e.g. one with this ID that is not deleted; it must compare the ID,
+     * since positions above kMaxRecord are tested without a hash match
+     * @return Position, or kNotFound
+     */
+    template <typename Matches>
+    std::size_t FindIf(std::string_view id, Matches matches) const {
+        if (!slots.empty()) {
+            const std::uint32_t hash = Hash(id);
+            for (std::size_t i = hash & mask; slots[i].Position != 0; i = (i + 1) & mask) {
+                if (slots[i].Hash == hash && matches(slots[i].Position - 1)) {
+                    return slots[i].Position - 1;
+                }
+            }
+        }
+        for (std::size_t position = kMaxRecord + 1; position < unhashedEnd; ++position) {
+            if (matches(position)) {
+                return position;
+            }
+        }
+        return kNotFound;
+    }
+
+    /**
+     * @brief Number of indexed records
+     */
+    std::size_t Size() const { return count; }
+
+    /**
+     * @brief Heap bytes held by the slot array
+     */
+    std::size_t MemoryUsage() const { return slots.capacity() * sizeof(Slot); }
+
+private:
+    struct Slot {
+        std::uint32_t Hash;
+        std::uint32_t Position;  ///< Record position + 1, 0 for an empty slot
+    };
+
+    void Rehash(std::size_t capacity);
+    void Place(Slot slot);
+
+    std::vector<Slot> slots;
+    std::size_t mask = 0;
+    std::size_t count = 0;
+    std::size_t unhashedEnd = 0;  ///< Past the last added position above kMaxRecord, 0 if none
+};
+
+#endif // ID_INDEX_H
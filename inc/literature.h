@@ -0,0 +1,27 @@
+/**
+ * @file literature.h
+ * @brief Literature record definition shared by the handler, library and storage
+ */
+
+#ifndef LITERATURE_H
+#define LITERATURE_H
+
+#include <string>
+#include <vector>
+
+/**
+ * @struct Literature
+ * @brief Data structure for literature items
+ *
+ * @details Task 1 data structure containing information about books/literature
+ * with author, title, year, publisher, and rating fields
+ */
+struct Literature {
+    std::vector<std::string> Author;  ///< List of authors
+    std::string Name;                  ///< Title of the book
+    int Year;                          ///< Publication year
+    std::string Publisher;             ///< Publisher name
+    double Rating;                     ///< Rating value (0.0-10.0)
+};
+
+#endif // LITERATURE_H
@@ -0,0 +1,58 @@
+/**
+ * @file literature_format.h
+ * @brief On-disk formats understood by Input() and SaveToFile()
+ */
+
+#ifndef LITERATURE_FORMAT_H
+#define LITERATURE_FORMAT_H
+
+#include <string>
+#include <string_view>
+
+/**
+ * @enum DataFormat
+ * @brief Serialization format of a Literature data file
+ */
+enum class DataFormat {
+    Auto,         ///< Detect from the extension, then from the leading bytes
+    Json,         ///< One JSON array, pretty-printed with 4-space indentation
+    NDJSON,       ///< Newline-delimited JSON: one compact record per line
+    Cbor,         ///< RFC 8949 CBOR array of records
+    MessagePack,  ///< MessagePack array of records
+    Ubjson        ///< UBJSON array of records (size-annotated containers)
+};
+
+/**
+ * @brief Pick a format from the file extension
+ * @param filename File path
+ * @return Format registered for the extension, Auto if it is not known
+ */
+DataFormat FormatFromExtension(const std::string& filename);
+
+/**
+ * @brief Detect the format of a file from its name and leading bytes
+ * @details A known extension wins. Otherwise the leading bytes decide:
+ * '[' followed by '#' or '$' is UBJSON, other text starting with '[' is JSON,
+ * text whose first two lines start with '{' is NDJSON, and CBOR and
+ * MessagePack arrays are told apart by their array and map markers.
+ * @param filename File path
+ * @param head First bytes of the file; NDJSON detection needs the whole
+ * first line
+ * @return Detected format, Json if nothing matches
+ */
+DataFormat DetectDataFormat(const std::string& filename, std::string_view head);
+
+/**
+ * @brief Parse a format name as used in commands ("json", "ndjson", "cbor", ...)
+ * @param name Format name, case-insensitive
+ * @param format Receives the parsed format
+ * @return false if the name is unknown
+ */
+bool ParseDataFormat(const std::string& name, DataFormat& format);
+
+/**
+ * @brief Lower-case name of a format
+ */
+const char* DataFormatName(DataFormat format);
+
+#endif // LITERATURE_FORMAT_H
@@ -0,0 +1,163 @@
+/**
+ * @file literature_generator.h
+ * @brief Random Literature records for Generate(), Generate_ex() and benchmarks
+ */
+
+#ifndef LITERATURE_GENERATOR_H
+#define LITERATURE_GENERATOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include "literature.h"
+#include "literature_format.h"
+#include "literature_store.h"
+#include "id_allocator.h"
+#include "thread_pool.h"
+
+/**
+ * @class FastRandom
+ * @brief Small, fast pseudo-random generator (xoshiro256**)
+ *
+ * @details 32 bytes of state seeded through splitmix64, so neighbouring
+ * seeds give unrelated streams. Not for cryptography; one instance per
+ * thread, never shared.
+ */
+class FastRandom {
+public:
+    /**
+     * @brief Seed the generator
+     * @param seed Any value, 0 included
+     */
+    explicit FastRandom(std::uint64_t seed);
+
+    /**
+     * @brief Seed one of many independent streams of a seed
+     * @details Used to give every record its own generator, so a record
+     * depends only on (seed, stream), not on the order of generation
+     * @param seed Seed shared by the streams
+     * @param stream Stream number, e.g. a record index
+     */
+    FastRandom(std::uint64_t seed, std::uint64_t stream);
+
+    /**
+     * @brief Next 64 random bits
+     */
+    std::uint64_t Next();
+
+    /**
+     * @brief Uniform integer in [0, bound)
+     * @details Multiply-shift reduction of the upper 32 bits, no division
+     * @param bound Exclusive upper limit, above 0
+     */
+    std::uint32_t Below(std::uint32_t bound) {
+        return static_cast<std::uint32_t>(((Next() >> 32) * bound) >> 32);
+    }
+
+    /**
+     * @brief Uniform double in [0, 1)
+     */
+    double Unit() { return static_cast<double>(Next() >> 11) * 0x1.0p-53; }
+
+private:
+    std::uint64_t state[4];
+};
+
+/**
+ * @brief Fill a record with random sample data
+ * @details One to three authors, a name and a publisher from fixed tables
+ * of Russian classics, a year in 1800..2024 and a rating in 0.0..10.0 on
+ * the 0.1 grid. The strings of lit are reused, so a caller filling many
+ * records with one Literature does not allocate per record.
+ * @param random Generator to draw from
+ * @param lit Receives the record
+ */
+void SampleLiterature(FastRandom& random, Literature& lit);
+
+/**
+ * @brief Fills record index of a batch
+ * @details Called concurrently from the pool threads; random is private to
+ * the chunk holding the record and seeded from the batch seed
+ */
+using LiteratureFiller = std::function<void(std::size_t index, FastRandom& random, Literature& lit)>;
+
+/**
+ * @brief Generate records into a store in parallel
+ * @details The records are split into fixed chunks generated on the pool,
+ * each with its own FastRandom and its own pre-reserved store, and appended
+ * to the target in chunk order as they complete. IDs are numbered from one
+ * block leased from ids for the whole batch, so they ascend with the
+ * position; a number whose ID the target already holds (checked only while
+ * its ID index is kept) is replaced by a fresh one from ids.
+ * @param count Number of records
+ * @param seed Seed of the first chunk; chunk k uses seed + k
+ * @param fill Produces the records
+ * @param ids Allocator numbering the IDs
+ * @param store Target
+ * @param pool Pool running the chunks
+ */
+void GenerateLiterature(std::size_t count, std::uint64_t seed, const LiteratureFiller& fill, IdAllocator& ids,
+                        LiteratureStore& store, ThreadPool& pool = ThreadPool::Shared());
+
+/**
+ * @brief Generate random sample records (SampleLiterature()) into a store in parallel
+ * @details See the overload taking a LiteratureFiller; chunks are fixed,
+ * so equal seeds give equal records whatever the number of threads
+ * @param count Number of records
+ * @param seed Seed of the first chunk; chunk k uses seed + k
+ * @param ids Allocator numbering the IDs
+ * @param store Target
+ * @param pool Pool running the chunks
+ */
+void GenerateLiterature(std::size_t count, std::uint64_t seed, IdAllocator& ids, LiteratureStore& store,
+                        ThreadPool& pool = ThreadPool::Shared());
+
+/**
+ * @struct StreamStats
+ * @brief Progress of StreamLiterature()
+ */
+struct StreamStats {
+    std::uint64_t Records = 0;   ///< Records written so far
+    std::uint64_t Bytes = 0;     ///< Bytes written so far, header included
+    double Seconds = 0.0;        ///< Time since the stream started
+    std::size_t PeakChunks = 0;  ///< Most encoded chunks waiting for the writer at once
+
+    double RecordsPerSecond() const { return Seconds > 0.0 ? Records / Seconds : 0.0; }
+    double MegabytesPerSecond() const { return Seconds > 0.0 ? Bytes / Seconds / (1 << 20) : 0.0; }
+};
+
+/**
+ * @struct StreamOptions
+ * @brief Tuning of StreamLiterature()
+ */
+struct StreamOptions {
+    std::size_t ChunkRecords = 1 << 14;  ///< Records per chunk; equal sizes give equal seeds per chunk
+    std::size_t Depth = 0;               ///< Chunks in flight, 0 for twice the pool size
+    std::uint64_t FirstNumber = 1;       ///< ID number of the first record; record i gets FirstNumber + i
+    std::function<void(const StreamStats&)> Progress;  ///< Called after every chunk written, if set
+};
+
+/**
+ * @brief Generate records straight into a file, in bounded memory
+ * @details A two-stage pipeline: the pool generates chunks of records and
+ * encodes each one in the target format, while the calling thread writes
+ * the encoded chunks in order. At most Depth chunks exist at a time, so
+ * memory stays at a few chunks whatever count is. Chunk k is generated
+ * with FastRandom(seed + k) like in GenerateLiterature(), so for the same
+ * chunk size both produce the same records. Stops early if out fails;
+ * compare the returned Records with count.
+ * @param out Destination stream, opened in binary mode for binary formats
+ * @param format Format other than DataFormat::Auto
+ * @param count Number of records
+ * @param seed Seed of the first chunk; chunk k uses seed + k
+ * @param fill Produces the records
+ * @param options Chunk size, pipeline depth, ID numbers and progress callback
+ * @param pool Pool running the generation stage
+ * @return What was written and how fast
+ */
+StreamStats StreamLiterature(std::ostream& out, DataFormat format, std::uint64_t count, std::uint64_t seed,
+                             const LiteratureFiller& fill, const StreamOptions& options = StreamOptions(),
+                             ThreadPool& pool = ThreadPool::Shared());
+
+#endif // LITERATURE_GENERATOR_H
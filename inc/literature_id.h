@@ -0,0 +1,122 @@
+/**
+ * @file literature_id.h
+ * @brief Format of literature record IDs
+ *
+ * @details An ID is "LIT", a number and a suffix of one to three capital
+ * letters taken from the record's name: LIT007WAR, LIT1234ANN. The number
+ * is zero-padded to three digits; longer numbers carry no leading zero, so
+ * every number has exactly one spelling and equal numbers give equal IDs.
+ */
+
+#ifndef LITERATURE_ID_H
+#define LITERATURE_ID_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+/// Most digits an ID number may have; every such number fits in 64 bits
+constexpr std::size_t kMaxIdDigits = 19;
+
+/// Largest ID number, the largest with kMaxIdDigits digits
+constexpr std::uint64_t kMaxIdNumber = 9999999999999999999ULL;
+
+/// Longest well-formed ID: prefix, digits and suffix
+constexpr std::size_t kMaxIdLength = 3 + kMaxIdDigits + 3;
+
+/**
+ * @brief Check an ID and extract its number
+ * @details Hand-written matcher: no allocation, one pass over the ID,
+ * usable in constant expressions
+ * @param id ID to check
+ * @param number Receives the number if the ID is well-formed
+ * @return true if the ID matches LIT, 3 to 19 digits (no leading zero
+ * beyond three) and 1 to 3 capital letters
+ */
+constexpr bool ParseLiteratureID(std::string_view id, std::uint64_t& number) noexcept {
+    if (id.size() < 7 || id.size() > kMaxIdLength || id[0] != 'L' || id[1] != 'I' || id[2] != 'T') {
+        return false;
+    }
+    std::size_t end = 3;
+    std::uint64_t value = 0;
+    while (end < id.size() && id[end] >= '0' && id[end] <= '9') {
+        value = value * 10 + static_cast<std::uint64_t>(id[end] - '0');
+        ++end;
+    }
+    const std::size_t digits = end - 3;
+    const std::size_t letters = id.size() - end;
+    if (digits < 3 || digits > kMaxIdDigits || (digits > 3 && id[3] == '0') || letters < 1 || letters > 3) {
+        return false;
+    }
+    for (std::size_t i = end; i < id.size(); ++i) {
+        if (id[i] < 'A' || id[i] > 'Z') {
+            return false;
+        }
+    }
+    number = value;
+    return true;
+}
+
+/**
+ * @brief Check an ID against the format (see file details)
+ * @param id ID to check
+ * @return true if the ID is well-formed
+ */
+constexpr bool IsLiteratureID(std::string_view id) noexcept {
+    std::uint64_t number = 0;
+    return ParseLiteratureID(id, number);
+}
+
+/**
+ * @brief Write the ID for a number and a record name, without streams
+ * @details The suffix is the first three ASCII letters of the name in
+ * upper case, "X" if it has none
+ * @param number ID number, at most kMaxIdNumber
+ * @param name Record name
+ * @param out Receives the ID; room for kMaxIdLength characters
+ * @return Length of the ID
+ */
+inline std::size_t FormatLiteratureID(std::uint64_t number, std::string_view name, char* out) noexcept {
+    char digits[kMaxIdDigits];
+    std::size_t count = 0;
+    do {
+        digits[count++] = static_cast<char>('0' + number % 10);
+        number /= 10;
+    } while (number != 0 && count < kMaxIdDigits);
+
+    std::size_t length = 0;
+    out[length++] = 'L';
+    out[length++] = 'I';
+    out[length++] = 'T';
+    for (std::size_t pad = count; pad < 3; ++pad) {
+        out[length++] = '0';
+    }
+    while (count > 0) {
+        out[length++] = digits[--count];
+    }
+    const std::size_t suffix = length;
+    for (std::size_t i = 0; i < name.size() && length - suffix < 3; ++i) {
+        char c = name[i];
+        if (c >= 'a' && c <= 'z') {
+            out[length++] = static_cast<char>(c - 'a' + 'A');
+        } else if (c >= 'A' && c <= 'Z') {
+            out[length++] = c;
+        }
+    }
+    if (length == suffix) {
+        out[length++] = 'X';
+    }
+    return length;
+}
+
+/**
+ * @brief ID for a number and a record name as a string
+ * @see FormatLiteratureID(std::uint64_t, std::string_view, char*)
+ */
+inline std::string FormatLiteratureID(std::uint64_t number, std::string_view name) {
+    char buffer[kMaxIdLength];
+    return std::string(buffer, FormatLiteratureID(number, name, buffer));
+}
+
+#endif // LITERATURE_ID_H
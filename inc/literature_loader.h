@@ -0,0 +1,223 @@
+/**
+ * @file literature_loader.h
+ * @brief Streaming (SAX) loader that fills a LiteratureStore without a DOM
+ *
+ * @details The loader receives nlohmann::json SAX events and writes each
+ * record straight into the columns of a LiteratureStore, so loading a file
+ * never materializes the nlohmann::json tree. Records that do not match the
+ * Literature schema are skipped and reported individually.
+ */
+
+#ifndef LITERATURE_LOADER_H
+#define LITERATURE_LOADER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <string>
+#include <vector>
+#include "literature_store.h"
+#include "literature_format.h"
+#include "thread_pool.h"
+#include "../ext/nlohmann/json.hpp"
+
+using json = nlohmann::json;
+
+/**
+ * @struct LoadError
+ * @brief Schema error for one rejected record
+ */
+struct LoadError {
+    std::size_t Record;   ///< Position of the record in the source array
+    std::string Message;  ///< Description of the problem
+};
+
+/**
+ * @struct LoadReport
+ * @brief Outcome of a load operation
+ */
+struct LoadReport {
+    std::size_t Records = 0;        ///< Records appended to the store
+    std::size_t Rejected = 0;       ///< Records skipped because of schema errors
+    std::vector<LoadError> Errors;  ///< First schema errors (at most kMaxReportedErrors)
+    std::string ParseError;         ///< Syntax error, empty if the input was well formed
+
+    static constexpr std::size_t kMaxReportedErrors = 100;
+
+    /**
+     * @brief Check whether the input was syntactically valid
+     */
+    bool Ok() const { return ParseError.empty(); }
+};
+
+/**
+ * @class LiteratureSaxLoader
+ * @brief SAX consumer translating JSON events into LiteratureStore records
+ *
+ * @details Accepts a top-level array of Literature objects or a single
+ * object. Unknown keys are skipped together with their (possibly nested)
+ * values. "Author" may be a string or an array of strings, "Year" and
+ * "Rating" any JSON number.
+ */
+class LiteratureSaxLoader final : public nlohmann::json_sax<json> {
+public:
+    /**
+     * @brief Create a loader appending to a store
+     * @param target Store receiving the parsed records
+     * @param report Report receiving counters and errors
+     */
+    LiteratureSaxLoader(LiteratureStore& target, LoadReport& report);
+
+    bool null() override;
+    bool boolean(bool val) override;
+    bool number_integer(number_integer_t val) override;
+    bool number_unsigned(number_unsigned_t val) override;
+    bool number_float(number_float_t val, const string_t& s) override;
+    bool string(string_t& val) override;
+    bool binary(binary_t& val) override;
+    bool start_object(std::size_t elements) override;
+    bool key(string_t& val) override;
+    bool end_object() override;
+    bool start_array(std::size_t elements) override;
+    bool end_array() override;
+    bool parse_error(std::size_t position, const std::string& last_token,
+                     const nlohmann::detail::exception& ex) override;
+
+private:
+    enum class Slot : std::uint8_t { None, Author, Name, Year, Publisher, Rating, ID, Unknown };
+
+    bool Number(double value);
+    bool Text(std::string& value);
+    bool Other(const char* typeName);
+    void Reject(const std::string& message);
+
+    LiteratureStore& store;
+    LoadReport& report;
+
+    std::size_t depth = 0;        ///< Current nesting depth
+    std::size_t recordDepth = 0;  ///< Depth at which record fields live, 0 outside records
+    std::size_t recordIndex = 0;  ///< Position of the current record in the source
+    bool recordValid = false;
+    bool inAuthorList = false;
+    Slot slot = Slot::None;
+
+    Literature current;
+    std::string currentId;
+    std::uint8_t currentMask = 0;
+};
+
+/**
+ * @class LiteratureLineReader
+ * @brief Incremental reader for newline-delimited JSON (one record per line)
+ *
+ * @details Memory use is bounded by the longest line plus whatever the caller
+ * keeps of the batches, so files larger than RAM can be streamed through a
+ * small batch store. Blank lines are skipped; a line that is not a valid
+ * Literature object is rejected on its own without stopping the stream.
+ * Error positions are 0-based line numbers.
+ */
+class LiteratureLineReader {
+public:
+    /**
+     * @brief Create a reader over a stream
+     * @param source Stream positioned at the start of a line
+     */
+    explicit LiteratureLineReader(std::istream& source);
+
+    /**
+     * @brief Append up to maxRecords records to a batch
+     * @param batch Store receiving the records
+     * @param maxRecords Upper bound on appended records
+     * @return Number of records appended, 0 once the input is exhausted
+     */
+    std::size_t ReadBatch(LiteratureStore& batch, std::size_t maxRecords);
+
+    /**
+     * @brief Check whether the whole input has been consumed
+     */
+    bool Done() const { return done; }
+
+    /**
+     * @brief Counters and errors accumulated so far
+     */
+    const LoadReport& Report() const { return report; }
+
+private:
+    std::istream& input;
+    std::string line;
+    std::size_t lineNumber = 0;
+    LoadReport report;
+    bool done = false;
+};
+
+/**
+ * @brief Read a whole NDJSON stream into a store
+ * @param input Stream positioned at the start of a line
+ * @param store Store receiving the records (appended)
+ * @return Load report; ParseError is set only if the stream fails
+ */
+LoadReport LoadLiteratureLines(std::istream& input, LiteratureStore& store);
+
+/**
+ * @brief Parse JSON from a stream directly into a store
+ * @param input Stream positioned at the start of the JSON document
+ * @param store Store receiving the records (appended)
+ * @return Load report; on a syntax error the store may hold a partial load
+ */
+LoadReport LoadLiterature(std::istream& input, LiteratureStore& store);
+
+/**
+ * @brief Parse JSON from a contiguous buffer (e.g. a MappedFile) into a store
+ * @details Reads the buffer in place; string values are decoded once into
+ * the store's column heaps, so the buffer may be released after the call
+ * @param begin First byte of the JSON document
+ * @param end One past the last byte
+ * @param store Store receiving the records (appended)
+ * @return Load report; on a syntax error the store may hold a partial load
+ */
+LoadReport LoadLiterature(const char* begin, const char* end, LiteratureStore& store);
+
+/**
+ * @brief Parse a top-level JSON array on several threads
+ * @details A quick serial pre-scan splits the array into chunks of whole
+ * elements; the chunks are parsed concurrently into private stores on the
+ * pool and appended to the target in source order. Inputs that are small,
+ * not a top-level array, or structurally broken go through the serial
+ * LoadLiterature() path, which also produces the precise error message.
+ * @param begin First byte of the JSON document
+ * @param end One past the last byte
+ * @param store Store receiving the records (appended)
+ * @param pool Pool running the chunk parsers
+ * @return Load report with record positions relative to the whole array
+ */
+LoadReport LoadLiteratureParallel(const char* begin, const char* end, LiteratureStore& store,
+                                  ThreadPool& pool = ThreadPool::Shared());
+
+/**
+ * @brief Parse a CBOR, MessagePack or UBJSON document into a store
+ * @details The binary readers emit the same SAX events as the JSON parser,
+ * so the document must have the same shape: an array of record maps or a
+ * single map. CBOR tags are rejected.
+ * @param begin First byte of the document
+ * @param end One past the last byte
+ * @param format DataFormat::Cbor, DataFormat::MessagePack or DataFormat::Ubjson
+ * @param store Store receiving the records (appended)
+ * @return Load report; on a syntax error the store may hold a partial load
+ */
+LoadReport LoadLiteratureBinary(const char* begin, const char* end, DataFormat format, LiteratureStore& store);
+
+/**
+ * @brief Load a data file in any supported format
+ * @details DataFormat::Auto picks the format with DetectDataFormat(). JSON
+ * goes through LoadLiteratureParallel() on a MappedFile, NDJSON through the
+ * line reader, binary formats through LoadLiteratureBinary().
+ * @param filename Path to the file
+ * @param format Format of the file, or DataFormat::Auto
+ * @param store Store receiving the records (appended)
+ * @param report Receives the load report
+ * @return false if the file could not be opened
+ */
+bool LoadLiteratureFile(const std::string& filename, DataFormat format, LiteratureStore& store,
+                        LoadReport& report);
+
+#endif // LITERATURE_LOADER_H
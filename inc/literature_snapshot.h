@@ -0,0 +1,127 @@
+/**
+ * @file literature_snapshot.h
+ * @brief Columnar on-disk snapshot of a LiteratureStore that is opened with mmap
+ *
+ * @details The file mirrors the in-memory columns of LiteratureStore:
+ *
+ *     header (SnapshotHeader, 8-byte aligned)
+ *     masks          uint8  x records
+ *     years          int32  x records
+ *     ratings        double x records
+ *     name, publisher and ID columns: uint64 offsets x (records + 1), then the character heap
+ *     author starts  uint64 x (records + 1)   (CSR row index into the author column)
+ *     author column: uint64 offsets x (authors + 1), then the character heap
+ *
+ * Every section starts on an 8-byte boundary and carries its own checksum.
+ * Numbers are stored in the byte order of the writing machine, which the
+ * header records; opening a snapshot written with the other byte order fails.
+ * Opening maps the file and points the store's columns into the mapping, so
+ * the cost does not depend on the number of records; columns are copied
+ * into memory only when the store is modified.
+ */
+
+#ifndef LITERATURE_SNAPSHOT_H
+#define LITERATURE_SNAPSHOT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include "literature_store.h"
+
+/**
+ * @class LiteratureSnapshot
+ * @brief Writes and opens columnar snapshot files
+ */
+class LiteratureSnapshot {
+public:
+    /**
+     * @brief Sections of a snapshot, in file order
+     */
+    enum Section : std::uint32_t {
+        kMasks,
+        kYears,
+        kRatings,
+        kNameOffsets,
+        kNameHeap,
+        kPublisherOffsets,
+        kPublisherHeap,
+        kIDOffsets,
+        kIDHeap,
+        kAuthorStarts,
+        kAuthorOffsets,
+        kAuthorHeap,
+        kSectionCount
+    };
+
+    /**
+     * @brief Location and checksum of one section
+     */
+    struct SectionEntry {
+        std::uint64_t Offset;    ///< Byte offset from the start of the file
+        std::uint64_t Size;      ///< Length in bytes, without padding
+        std::uint64_t Checksum;  ///< Checksum() of the section bytes
+    };
+
+    /**
+     * @brief Fixed-size file header
+     */
+    struct SnapshotHeader {
+        char Magic[8];                          ///< "LITSNAP" followed by a zero byte
+        std::uint32_t Version;                  ///< Format version, kVersion
+        std::uint32_t ByteOrder;                ///< kByteOrderTag as written by the producer
+        std::uint64_t Records;                  ///< Number of records
+        std::uint64_t Authors;                  ///< Number of author entries over all records
+        std::uint64_t Sequence;                 ///< Caller-defined position, e.g. the last log entry included
+        SectionEntry Sections[kSectionCount];   ///< Section table
+        std::uint64_t HeaderChecksum;           ///< Checksum() of all preceding header bytes
+    };
+
+    static constexpr std::uint32_t kVersion = 2;
+    static constexpr std::uint32_t kByteOrderTag = 0x01020304;
+
+    /**
+     * @brief Write a store as a snapshot
+     * @param out Destination stream, opened in binary mode
+     * @param store Records to write
+     * @param sequence Value stored in SnapshotHeader::Sequence
+     * @return true if every byte was written
+     */
+    static bool Write(std::ostream& out, const LiteratureStore& store, std::uint64_t sequence = 0);
+
+    /**
+     * @brief Write a snapshot file
+     * @details The data goes to filename + ".tmp" first, is fsynced and
+     * renamed over the target (see DurableReplace()), so a store still mapped
+     * from the old file stays valid and a crash never leaves a partial snapshot.
+     * @param filename Path of the snapshot
+     * @param store Records to write
+     * @param error Receives a description of the failure
+     * @param sequence Value stored in SnapshotHeader::Sequence
+     * @return true on success
+     */
+    static bool Save(const std::string& filename, const LiteratureStore& store, std::string& error,
+                     std::uint64_t sequence = 0);
+
+    /**
+     * @brief Map a snapshot file and serve a store from it
+     * @details Checks the header, its checksum and the section bounds, which
+     * takes constant time. With verify the section checksums and all offset
+     * arrays are checked as well, which reads the whole file once.
+     * @param filename Path of the snapshot
+     * @param store Receives the records; replaced only on success
+     * @param error Receives a description of the failure
+     * @param verify Also verify the section contents
+     * @param sequence Receives SnapshotHeader::Sequence if not null
+     * @return true on success
+     */
+    static bool Open(const std::string& filename, LiteratureStore& store, std::string& error,
+                     bool verify = false, std::uint64_t* sequence = nullptr);
+
+    /**
+     * @brief 64-bit checksum used for the header and the sections (Checksum64())
+     */
+    static std::uint64_t Checksum(const void* data, std::size_t size);
+};
+
+#endif // LITERATURE_SNAPSHOT_H
@@ -0,0 +1,741 @@
+/**
+ * @file literature_store.h
+ * @brief Columnar (struct-of-arrays) storage for Literature records
+ *
+ * @details Every field of the Literature schema lives in its own contiguous
+ * column instead of one nlohmann::json object per record. Numeric fields are
+ * plain arrays, string fields share one character heap per column and are
+ * addressed through offsets, and the author lists are flattened into a single
+ * string column indexed by per-record start offsets.
+ */
+
+#ifndef LITERATURE_STORE_H
+#define LITERATURE_STORE_H
+
+#include <cstddef>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "literature.h"
+#include "thread_pool.h"
+#include "rating_index.h"
+#include "field_index.h"
+#include "id_index.h"
+#include "../ext/nlohmann/json.hpp"
+
+using json = nlohmann::json;
+
+class MappedFile;
+
+/**
+ * @class ColumnBuffer
+ * @brief Contiguous column with copy-on-write storage
+ *
+ * @details A column owns a vector, or borrows read-only memory owned by
+ * someone else (e.g. a memory-mapped snapshot) and copies it on the first
+ * mutation, so read-only use never deserializes anything.
+ *
+ * Share() returns a frozen version in O(1) that keeps reading the elements
+ * present at that moment. The column it was taken from stays the writer:
+ * appends go in place past the frozen range as long as the capacity lasts,
+ * and move to a new buffer (leaving the old one to the frozen version) when
+ * it is exhausted, which costs no more than the vector growth it replaces.
+ * Only mutations of existing elements copy while a frozen version is alive.
+ * A frozen version may be read on another thread while the writer mutates,
+ * provided the writer itself is not accessed concurrently.
+ *
+ * Plain copies are deep and independent.
+ */
+template <typename T>
+class ColumnBuffer {
+public:
+    ColumnBuffer() = default;
+    ColumnBuffer(std::size_t n, const T& value) : storage(std::make_shared<std::vector<T>>(n, value)) { Sync(); }
+    ColumnBuffer(const ColumnBuffer& other) { *this = other; }
+    ColumnBuffer(ColumnBuffer&& other) noexcept { *this = std::move(other); }
+
+    ColumnBuffer& operator=(const ColumnBuffer& other) {
+        if (this != &other) {
+            borrowed = other.borrowed;
+            frozen = false;
+            shared = false;
+            if (borrowed) {
+                storage.reset();
+                first = other.first;
+                count = other.count;
+            } else {
+                storage = std::make_shared<std::vector<T>>(other.begin(), other.end());
+                Sync();
+            }
+        }
+        return *this;
+    }
+
+    ColumnBuffer& operator=(ColumnBuffer&& other) noexcept {
+        if (this != &other) {
+            storage = std::move(other.storage);
+            first = other.first;
+            count = other.count;
+            borrowed = other.borrowed;
+            frozen = other.frozen;
+            shared = other.shared;
+            other.first = nullptr;
+            other.count = 0;
+            other.borrowed = other.frozen = other.shared = false;
+        }
+        return *this;
+    }
+
+    std::size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    const T* data() const { return first; }
+    const T* begin() const { return first; }
+    const T* end() const { return first + count; }
+    const T& operator[](std::size_t i) const { return first[i]; }
+    const T& back() const { return first[count - 1]; }
+
+    /**
+     * @brief Heap capacity in elements, 0 while borrowed
+     */
+    std::size_t capacity() const { return storage && !borrowed ? storage->capacity() : 0; }
+
+    /**
+     * @brief Check whether the elements live in foreign memory
+     */
+    bool Borrowed() const { return borrowed; }
+
+    /**
+     * @brief Read n elements from foreign memory without copying them
+     * @details The memory must stay valid and unchanged while borrowed
+     */
+    void Borrow(const T* values, std::size_t n) {
+        storage.reset();
+        borrowed = true;
+        frozen = shared = false;
+        first = values;
+        count = n;
+    }
+
+    /**
+     * @brief Frozen O(1) version of the current elements (see class details)
+     */
+    ColumnBuffer Share() const {
+        ColumnBuffer version;
+        version.storage = storage;
+        version.first = first;
+        version.count = count;
+        version.borrowed = borrowed;
+        version.frozen = !borrowed;
+        shared = !borrowed;
+        return version;
+    }
+
+    T& operator[](std::size_t i) { Own(); return (*storage)[i]; }
+    void push_back(const T& value) { Grow(1); storage->push_back(value); Sync(); }
+    void pop_back() { Own(); storage->pop_back(); Sync(); }
+    void resize(std::size_t n) { Own(); storage->resize(n); Sync(); }
+
+    void reserve(std::size_t n) {
+        if (n > count) {
+            Grow(n - count);
+            storage->reserve(n);
+            Sync();
+        }
+    }
+
+    void append(const T* values, std::size_t n) {
+        Grow(n);
+        storage->insert(storage->end(), values, values + n);
+        Sync();
+    }
+
+    void assign(std::size_t n, const T& value) {
+        Fresh();
+        storage->assign(n, value);
+        Sync();
+    }
+
+    void clear() {
+        Fresh();
+        Sync();
+    }
+
+private:
+    bool SharedNow() const {
+        if (!shared) return false;
+        if (storage.use_count() > 1) return true;
+        // Pairs with the release in the last version's destructor: its reads
+        // happen before the writer reuses the storage in place
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return false;
+    }
+
+    // Exclusive storage holding the current elements
+    void Own() {
+        if (borrowed || frozen || SharedNow() || !storage) {
+            storage = std::make_shared<std::vector<T>>(first, first + count);
+            borrowed = frozen = false;
+            Sync();
+        }
+        shared = false;
+    }
+
+    // Room for extra elements at the end without touching a frozen range
+    void Grow(std::size_t extra) {
+        if (borrowed || frozen || !storage) {
+            Own();
+        } else if (SharedNow()) {
+            if (storage->size() + extra > storage->capacity()) {
+                auto larger = std::make_shared<std::vector<T>>();
+                larger->reserve(std::max(count + extra, 2 * count));
+                larger->assign(first, first + count);
+                storage = std::move(larger);
+                shared = false;
+                Sync();
+            }
+        } else {
+            shared = false;
+        }
+    }
+
+    // Exclusive empty storage
+    void Fresh() {
+        if (borrowed || frozen || SharedNow() || !storage) {
+            storage = std::make_shared<std::vector<T>>();
+            borrowed = frozen = false;
+        } else {
+            storage->clear();
+        }
+        shared = false;
+    }
+
+    void Sync() {
+        first = storage->data();
+        count = storage->size();
+    }
+
+    std::shared_ptr<std::vector<T>> storage;
+    const T* first = nullptr;
+    std::size_t count = 0;
+    bool borrowed = false;       ///< Elements live in foreign memory
+    bool frozen = false;         ///< Read-only version created by Share()
+    mutable bool shared = false; ///< A frozen version may still reference storage
+};
+
+/**
+ * @class StringColumn
+ * @brief Column of strings stored back to back in one character heap
+ *
+ * @details Entry i occupies heap[offsets[i], offsets[i + 1]), so a column of
+ * n strings costs one allocation for the characters and n + 1 offsets.
+ */
+class StringColumn {
+public:
+    StringColumn() : offsets(1, 0) {}
+
+    /**
+     * @brief Read a column from foreign memory without copying it
+     * @param heapData Characters of all entries
+     * @param heapBytes Number of characters
+     * @param offsetData entries + 1 offsets into heapData, starting at 0
+     * @param entries Number of strings
+     */
+    void Borrow(const char* heapData, std::size_t heapBytes, const std::uint64_t* offsetData,
+                std::size_t entries) {
+        heap.Borrow(heapData, heapBytes);
+        offsets.Borrow(offsetData, entries + 1);
+    }
+
+    /**
+     * @brief Frozen O(1) version of the column (see ColumnBuffer::Share())
+     */
+    StringColumn Share() const {
+        StringColumn version;
+        version.heap = heap.Share();
+        version.offsets = offsets.Share();
+        return version;
+    }
+
+    /**
+     * @brief Number of strings in the column
+     */
+    std::size_t Size() const { return offsets.size() - 1; }
+
+    /**
+     * @brief Get entry i as a view into the heap
+     * @details The view is invalidated by any mutation of the column
+     */
+    std::string_view Get(std::size_t i) const {
+        return std::string_view(heap.data() + offsets[i], offsets[i + 1] - offsets[i]);
+    }
+
+    /**
+     * @brief Append a string to the end of the column
+     */
+    void Append(std::string_view value) {
+        heap.append(value.data(), value.size());
+        offsets.push_back(heap.size());
+    }
+
+    /**
+     * @brief Reserve room for entries and characters
+     * @param entries Expected number of strings
+     * @param bytes Expected total number of characters
+     */
+    void Reserve(std::size_t entries, std::size_t bytes);
+
+    /**
+     * @brief Remove all entries
+     */
+    void Clear();
+
+    /**
+     * @brief Remove the last entry
+     */
+    void PopBack() {
+        offsets.pop_back();
+        heap.resize(offsets.back());
+    }
+
+    /**
+     * @brief Remove flagged entries in place, keeping the order of the rest
+     * @param remove One flag per entry, true to drop the entry
+     */
+    void Erase(const std::vector<bool>& remove);
+
+    /**
+     * @brief Bytes held by the heap and the offset array (borrowed memory excluded)
+     */
+    std::size_t MemoryUsage() const;
+
+    const ColumnBuffer<char>& Heap() const { return heap; }                ///< Character heap
+    const ColumnBuffer<std::uint64_t>& Offsets() const { return offsets; } ///< Size() + 1 offsets
+
+private:
+    ColumnBuffer<char> heap;
+    ColumnBuffer<std::uint64_t> offsets;
+};
+
+/**
+ * @class LiteratureStore
+ * @brief Struct-of-arrays container for Literature records
+ *
+ * @details Records are addressed by their slot index. A per-record field mask
+ * remembers which fields were present in the source JSON, so records that
+ * lack a field round-trip without it. Keys outside the Literature schema
+ * (plus "ID") are not kept.
+ *
+ * Delete() only marks records with a tombstone bit in the mask, in
+ * O(positions). Deleted records keep their slot until Compact() (or
+ * Erase()) closes the gaps: ToJson(), the writers, RecordPredicate,
+ * FindID(), the index lookups and PercentileBand() skip them, while the
+ * indexes themselves keep their entries until the compaction rebuilds them.
+ * Size() counts slots, Count() the records that are not deleted.
+ */
+class LiteratureStore {
+public:
+    /**
+     * @brief Bits of the per-record field mask
+     */
+    enum Field : std::uint8_t {
+        kAuthor = 1 << 0,
+        kName = 1 << 1,
+        kYear = 1 << 2,
+        kPublisher = 1 << 3,
+        kRating = 1 << 4,
+        kID = 1 << 5,
+        kDeleted = 1 << 7,  ///< Not a field: tombstone of a deleted record
+        kLiteratureFields = kAuthor | kName | kYear | kPublisher | kRating,
+        kIndexableFields = kAuthor | kName | kYear | kPublisher | kRating  ///< Fields IndexFields() accepts
+    };
+
+    /**
+     * @brief Field bit for a field name ("Author", "Name", "Year", "Publisher", "Rating", "ID")
+     * @return The bit, or 0 if the name is unknown
+     */
+    static std::uint8_t FieldBit(const std::string& name);
+
+    /**
+     * @brief Number of record slots, including deleted records not yet compacted
+     */
+    std::size_t Size() const { return masks.size(); }
+
+    /**
+     * @brief Number of records that are not deleted
+     */
+    std::size_t Count() const { return masks.size() - deleted; }
+
+    /**
+     * @brief Number of deleted records waiting for Compact()
+     */
+    std::size_t Deleted() const { return deleted; }
+
+    /**
+     * @brief Check whether the store holds no live records
+     */
+    bool Empty() const { return Count() == 0; }
+
+    /**
+     * @brief Check whether record i is not deleted
+     */
+    bool Live(std::size_t i) const { return (masks[i] & kDeleted) == 0; }
+
+    /**
+     * @brief Remove all records
+     */
+    void Clear();
+
+    /**
+     * @brief Reserve room for a number of records
+     * @param records Expected number of records
+     */
+    void Reserve(std::size_t records);
+
+    /**
+     * @brief Append a record with all Literature fields present
+     * @param lit Record to append
+     * @param id Record ID, omitted from the record when empty
+     * @return Slot index of the new record
+     */
+    std::size_t Append(const Literature& lit, std::string_view id = std::string_view());
+
+    /**
+     * @brief Append a record holding only the fields set in mask
+     * @param lit Record to append
+     * @param id Record ID, used when mask contains kID
+     * @param mask Combination of Field bits
+     * @return Slot index of the new record
+     */
+    std::size_t Append(const Literature& lit, std::string_view id, std::uint8_t mask);
+
+    /**
+     * @brief Append a record from a JSON object
+     * @param item JSON object with Literature fields
+     * @return Slot index of the new record
+     * @throws json::type_error if item is not an object or a field has the wrong type
+     */
+    std::size_t AppendJson(const json& item);
+
+    /**
+     * @brief Remove the last record
+     */
+    void PopBack();
+
+    /**
+     * @brief Append every record of another store, keeping their order
+     * @param other Store to copy records from
+     */
+    void AppendAll(const LiteratureStore& other);
+
+    /**
+     * @brief Check whether record i has a field
+     * @param i Slot index
+     * @param field Field bit to test
+     */
+    bool Has(std::size_t i, Field field) const { return (masks[i] & field) != 0; }
+
+    /**
+     * @brief Field mask of record i
+     */
+    std::uint8_t Mask(std::size_t i) const { return masks[i]; }
+
+    int Year(std::size_t i) const { return years[i]; }                        ///< Year of record i
+    double Rating(std::size_t i) const { return ratings[i]; }                 ///< Rating of record i
+    std::string_view Name(std::size_t i) const { return names.Get(i); }       ///< Name of record i
+    std::string_view Publisher(std::size_t i) const { return publishers.Get(i); } ///< Publisher of record i
+    std::string_view ID(std::size_t i) const { return ids.Get(i); }           ///< ID of record i
+
+    /**
+     * @brief Number of authors of record i
+     */
+    std::size_t AuthorCount(std::size_t i) const {
+        return static_cast<std::size_t>(authorStarts[i + 1] - authorStarts[i]);
+    }
+
+    /**
+     * @brief Author k of record i
+     */
+    std::string_view Author(std::size_t i, std::size_t k) const {
+        return authors.Get(static_cast<std::size_t>(authorStarts[i]) + k);
+    }
+
+    /**
+     * @brief Contiguous Year column
+     */
+    const ColumnBuffer<int>& Years() const { return years; }
+
+    /**
+     * @brief Contiguous Rating column
+     */
+    const ColumnBuffer<double>& Ratings() const { return ratings; }
+
+    /**
+     * @brief Check whether some columns are still read from a memory-mapped snapshot
+     */
+    bool Mapped() const { return backing != nullptr; }
+
+    /**
+     * @brief Consistent read-only version of the store in O(1)
+     * @details The version shares the columns with this store and keeps
+     * showing the records as they are now while this store goes on being
+     * modified (see ColumnBuffer). It can be read on another thread, e.g. to
+     * write a snapshot, while this store is mutated under the owner's lock.
+     * Modifying the version itself first copies it.
+     * @return Frozen version
+     */
+    LiteratureStore Freeze() const;
+
+    /**
+     * @brief Materialize record i as a Literature structure
+     */
+    Literature Get(std::size_t i) const;
+
+    /**
+     * @brief Convert record i to a JSON object with its present fields
+     */
+    json RecordToJson(std::size_t i) const;
+
+    /**
+     * @brief Convert the records that are not deleted to a JSON array
+     */
+    json ToJson() const;
+
+    /**
+     * @brief Build a store from a JSON array (or a single JSON object)
+     * @param data JSON array of Literature objects
+     * @return New store with one record per array element
+     * @throws json::type_error on records that do not match the schema
+     */
+    static LiteratureStore FromJson(const json& data);
+
+    /**
+     * @brief Build a new store from selected records
+     * @param indices Slot indices to copy, in output order
+     * @return Store holding copies of the selected records
+     */
+    LiteratureStore Select(const std::vector<std::size_t>& indices) const;
+
+    /**
+     * @brief Indices of the records in the lower and upper tails of a numeric field
+     * @details Records are ranked by (field value, index), so ties keep file
+     * order and the result is deterministic. The lower band is the first
+     * max(1, n * lower) ranks, the upper band the last max(1, n * upper)
+     * ranks not already in the lower band (a fraction of 0 selects nothing).
+     * Found with selection rather than a full sort: O(n) plus sorting the
+     * selected records. Each band comes out in ascending rank order, the
+     * lower band first.
+     *
+     * With the rating index, every rating on the 0.1 grid and no deleted
+     * records, Rating bands are read from the index in O(k + 101). Deleted
+     * records are not ranked; with any present, the values of the others
+     * are gathered first.
+     *
+     * Otherwise large stores are split into one chunk per pool thread; each chunk
+     * selects and sorts its own bottom and top candidates, and the bands
+     * are merged from the sorted candidate lists. The result does not
+     * depend on the number of threads.
+     * @param field "Rating" or "Year"
+     * @param lower Fraction of records to keep from the bottom, 0..1
+     * @param upper Fraction of records to keep from the top, 0..1
+     * @param indices Receives the selected record indices
+     * @param pool Pool running the chunks
+     * @return false if the field is not numeric or a fraction is out of range
+     */
+    bool PercentileBand(const std::string& field, double lower, double upper, std::vector<std::size_t>& indices,
+                        ThreadPool& pool = ThreadPool::Shared()) const;
+
+    /**
+     * @brief Build or drop the rating index used by PercentileBand()
+     * @details The index (see RatingIndex) is kept up to date by every
+     * mutation once built. New stores start with it; stores opened from a
+     * snapshot and frozen versions start without it. Dropping it saves its
+     * memory and the per-append upkeep, e.g. during a bulk load.
+     * @param enabled Build the index if missing, or drop it
+     */
+    void IndexRatings(bool enabled = true);
+
+    /**
+     * @brief Check whether the rating index is maintained
+     */
+    bool RatingsIndexed() const { return ratingsIndexed; }
+
+    /**
+     * @brief Choose the fields that keep a secondary index
+     * @details Name and Publisher get a hash index (TextIndex) for equality,
+     * Year and Rating an ordered index (OrderedIndex) for ranges, Author an
+     * inverted index (AuthorIndex) for membership. Newly
+     * chosen fields are indexed here, the others are dropped, and every
+     * mutation keeps the indexes current from then on. Select() results
+     * keep the choice; frozen versions and opened snapshots start without
+     * indexes. RecordPredicate answers comparisons on these fields from them.
+     * @param fields Combination of kAuthor, kName, kPublisher, kYear and kRating
+     */
+    void IndexFields(std::uint8_t fields);
+
+    /**
+     * @brief Fields with a secondary index
+     */
+    std::uint8_t IndexedFields() const { return indexedFields; }
+
+    /**
+     * @brief Records whose string field equals a value, from its hash index
+     * @details For kAuthor, the records listing the value among their authors
+     * @param field kName, kPublisher or kAuthor
+     * @param value Value to look up
+     * @param positions Receives the matching positions in ascending order
+     * @return false if the field has no index (positions is left alone)
+     */
+    bool IndexLookup(Field field, std::string_view value, std::vector<std::size_t>& positions) const;
+
+    /**
+     * @brief Records listing every one of some authors, from the author index
+     * @details Intersects the posting lists, shortest first (AuthorIndex::FindAll())
+     * @param authors Names that must all be listed
+     * @param positions Receives the matching positions in ascending order
+     * @return false if Author has no index (positions is left alone)
+     */
+    bool AuthorLookup(const std::vector<std::string>& authors, std::vector<std::size_t>& positions) const;
+
+    /**
+     * @brief Records whose numeric field lies in a range, from its ordered index
+     * @param field kYear or kRating
+     * @param low Smallest value to visit
+     * @param high Largest value to visit
+     * @param accept Called once per distinct value in [low, high]; its records match if it returns true
+     * @param positions Receives the matching positions in ascending order
+     * @return false if the field has no index (positions is left alone)
+     */
+    bool IndexRange(Field field, double low, double high, const std::function<bool(double)>& accept,
+                    std::vector<std::size_t>& positions) const;
+
+    /**
+     * @brief Position of the first record with an ID
+     * @details O(1) through the ID hash index (see IdIndex), which new
+     * stores keep; stores opened from a snapshot and frozen versions build
+     * it on their first modification or on IndexIDs(), and scan until then
+     * @param id ID to look up
+     * @return Position, or IdIndex::kNotFound
+     */
+    std::size_t FindID(std::string_view id) const;
+
+    /**
+     * @brief Build the ID index now if it is missing, or drop it
+     * @details A dropped index stays off, e.g. for a temporary store filled
+     * in bulk and merged into another one, until IndexIDs() is called again
+     * @param enabled Build the index, or drop it
+     */
+    void IndexIDs(bool enabled = true);
+
+    /**
+     * @brief Check whether ID lookups go through the hash index
+     */
+    bool IDsIndexed() const { return idsIndexed; }
+
+    /**
+     * @brief Approximate heap bytes held by the secondary indexes
+     */
+    std::size_t IndexMemoryUsage() const;
+
+    /**
+     * @brief Flag records whose field equals a value
+     * @details Shorthand for RecordPredicate::Equals(field, value): string
+     * fields compare exactly, Author matches any of the authors, Year is
+     * parsed as an integer and Rating as a double compared with a 0.001
+     * tolerance. Unknown fields and unparsable values match nothing.
+     * @param field Field name to compare
+     * @param value Value to compare against
+     * @return One flag per record, true where the field matches
+     */
+    std::vector<bool> Match(const std::string& field, const std::string& value) const;
+
+    /**
+     * @brief Mark records as deleted, leaving their slots in place
+     * @details O(positions): only the masks change, nothing moves and no
+     * index is rebuilt. Positions of deleted records are ignored.
+     * @param positions Slot indices to delete
+     * @return Number of records deleted
+     */
+    std::size_t Delete(const std::vector<std::size_t>& positions);
+
+    /**
+     * @brief Remove the slots of deleted records, keeping the order of the rest
+     * @details O(n) plus rebuilding the indexes; positions after the first
+     * deleted record change
+     * @return Number of slots reclaimed
+     */
+    std::size_t Compact();
+
+    /**
+     * @brief Remove flagged and deleted records in place, keeping the order of the rest
+     * @param flagged One flag per slot, true to drop the record
+     * @return Number of removed slots
+     */
+    std::size_t Erase(const std::vector<bool>& flagged);
+
+    /**
+     * @brief Approximate number of heap bytes held by all columns and indexes
+     * @details Columns borrowed from a mapped snapshot are not counted
+     */
+    std::size_t MemoryUsage() const;
+
+private:
+    friend class LiteratureSnapshot;
+
+    void IndexRecord(std::size_t i);  // Add the last record to every maintained index
+    void UnindexLast();               // Remove the last record from every maintained index
+    void RebuildIndexes();
+    void DropDeleted(std::vector<std::size_t>& positions) const;  // Filter out deleted records
+
+    // Whether record i lists an author; scans its authors
+    bool ListsAuthor(std::size_t i, std::string_view author) const {
+        for (std::size_t k = 0; k < AuthorCount(i); ++k) {
+            if (Author(i, k) == author) return true;
+        }
+        return false;
+    }
+
+    // Append the positions past kMaxPostingRecord, which the field indexes leave out, that pass test
+    template <typename Test>
+    void ScanUnindexed(std::vector<std::size_t>& positions, Test test) const {
+        if (Size() <= kMaxPostingRecord) {
+            return;
+        }
+        for (std::size_t i = kMaxPostingRecord + 1; i < Size(); ++i) {
+            if (test(i)) positions.push_back(i);
+        }
+    }
+
+    ColumnBuffer<std::uint8_t> masks;
+    ColumnBuffer<int> years;
+    ColumnBuffer<double> ratings;
+    StringColumn names;
+    StringColumn publishers;
+    StringColumn ids;
+    StringColumn authors;
+    ColumnBuffer<std::uint64_t> authorStarts{1, 0};
+    std::size_t deleted = 0;  ///< Slots whose mask has kDeleted
+
+    RatingIndex ratingIndex;     ///< Positions by rating, valid while ratingsIndexed
+    bool ratingsIndexed = true;
+
+    IdIndex idIndex;         ///< Positions by ID, valid while idsIndexed
+    bool idsIndexed = true;
+    bool idsWanted = true;   ///< Build the ID index on the next modification if it is missing
+
+    std::uint8_t indexedFields = 0;  ///< Fields with a secondary index
+    TextIndex nameIndex;
+    TextIndex publisherIndex;
+    AuthorIndex authorIndex;
+    OrderedIndex<int> yearIndex;
+    OrderedIndex<double> ratingOrder;
+
+    /// Snapshot mapping the borrowed columns point into, null when all columns are owned
+    std::shared_ptr<const MappedFile> backing;
+};
+
+#endif // LITERATURE_STORE_H
@@ -0,0 +1,80 @@
+/**
+ * @file literature_writer.h
+ * @brief Streaming serializers for LiteratureStore
+ *
+ * @details Records are written one at a time, so saving never builds a JSON
+ * DOM of the whole dataset.
+ */
+
+#ifndef LITERATURE_WRITER_H
+#define LITERATURE_WRITER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include "literature_store.h"
+#include "literature_format.h"
+
+/**
+ * @brief Write the store as one pretty-printed JSON array
+ * @details The output is byte-identical to `out << std::setw(4) << store.ToJson()`
+ * @param out Destination stream
+ * @param store Records to write
+ */
+void WriteLiteratureJson(std::ostream& out, const LiteratureStore& store);
+
+/**
+ * @brief Write records as newline-delimited JSON, one compact record per line
+ * @param out Destination stream (open it in append mode to extend a file)
+ * @param store Records to write
+ * @param first Slot index of the first record to write
+ */
+void WriteLiteratureLines(std::ostream& out, const LiteratureStore& store, std::size_t first = 0);
+
+/**
+ * @brief Write the store as a CBOR, MessagePack or UBJSON array
+ * @details The array header is written from the record count and each
+ * record is encoded on its own; the bytes equal json::to_cbor /
+ * json::to_msgpack / json::to_ubjson(use_size = true) of store.ToJson()
+ * @param out Destination stream, opened in binary mode
+ * @param store Records to write
+ * @param format DataFormat::Cbor, DataFormat::MessagePack or DataFormat::Ubjson
+ */
+void WriteLiteratureBinary(std::ostream& out, const LiteratureStore& store, DataFormat format);
+
+/**
+ * @brief Write the store in any concrete format
+ * @param out Destination stream, opened in binary mode for binary formats
+ * @param store Records to write
+ * @param format Format other than DataFormat::Auto
+ */
+void WriteLiterature(std::ostream& out, const LiteratureStore& store, DataFormat format);
+
+/**
+ * @brief Write what precedes the records of a file holding count records
+ * @details With WriteLiteratureRecords() and WriteLiteratureFooter() a file
+ * is written piece by piece from several stores, e.g. while the records are
+ * still being generated. The three parts together give the bytes of
+ * WriteLiterature() for one store holding all the records.
+ * @param out Destination stream
+ * @param count Number of records the file will hold
+ * @param format Format other than DataFormat::Auto
+ */
+void WriteLiteratureHeader(std::ostream& out, std::uint64_t count, DataFormat format);
+
+/**
+ * @brief Write the live records of a store as the next part of a file
+ * @param out Destination stream
+ * @param store Records to write
+ * @param format Format other than DataFormat::Auto
+ * @param first true if no record precedes these in the file (no JSON separator)
+ */
+void WriteLiteratureRecords(std::ostream& out, const LiteratureStore& store, DataFormat format, bool first);
+
+/**
+ * @brief Write what follows the records of a file holding count records
+ * @see WriteLiteratureHeader()
+ */
+void WriteLiteratureFooter(std::ostream& out, std::uint64_t count, DataFormat format);
+
+#endif // LITERATURE_WRITER_H
@@ -0,0 +1,219 @@
+/**
+ * @file logger.h
+ * @brief Asynchronous logger: lock-free ring buffer, levels, rate limit, flush thread
+ *
+ * @details Callers format a message straight into a fixed-size slot of a
+ * bounded ring buffer and return; a background thread drains the slots in
+ * order, writes them in batches and flushes the console once per batch
+ * instead of once per line. Claiming a slot is a single compare-and-swap,
+ * so logging threads never wait for each other or for the console. When
+ * the buffer is full or the rate limit is exceeded the message is dropped
+ * and counted; the writer reports the counts in its next batch.
+ */
+
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+
+/**
+ * @enum LogLevel
+ * @brief Severity of a log message, in increasing order
+ */
+enum class LogLevel { Debug, Info, Warning, Error, Off };
+
+/**
+ * @brief Parse a level name ("debug", "info", "warning", "error", "off")
+ * @param name Level name, case-insensitive
+ * @param level Receives the parsed level
+ * @return false if the name is unknown
+ */
+bool ParseLogLevel(const std::string& name, LogLevel& level);
+
+/**
+ * @brief Upper-case name of a level
+ */
+const char* LogLevelName(LogLevel level);
+
+/**
+ * @class Logger
+ * @brief Multi-producer, single-consumer asynchronous logger
+ *
+ * @details Debug and Info lines go to the output stream, Warning and Error
+ * lines to the error stream, in the order they were logged. Messages
+ * longer than a slot are cut and end in "...".
+ */
+class Logger {
+public:
+    static constexpr std::size_t kDefaultCapacity = 8192;  ///< Slots of the shared logger
+    static constexpr std::size_t kMessageBytes = 232;      ///< Longest message kept whole
+
+    /**
+     * @brief Start the flush thread
+     * @param out Destination of Debug and Info lines
+     * @param err Destination of Warning and Error lines
+     * @param capacity Number of slots, rounded up to a power of two
+     * @param interval Period of the flush thread
+     */
+    explicit Logger(std::ostream& out = std::cout, std::ostream& err = std::cerr,
+                    std::size_t capacity = kDefaultCapacity,
+                    std::chrono::milliseconds interval = std::chrono::milliseconds(20));
+
+    /**
+     * @brief Write what is queued and join the flush thread
+     */
+    ~Logger();
+
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+
+    /**
+     * @brief Drop messages below a level
+     * @param level Lowest level written; LogLevel::Off silences the logger
+     */
+    void SetLevel(LogLevel level) { threshold.store(level, std::memory_order_relaxed); }
+
+    /**
+     * @brief Lowest level written
+     */
+    LogLevel Level() const { return threshold.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Limit the messages below Error written per second
+     * @param perSecond Most messages per second, 0 for no limit
+     */
+    void SetRateLimit(std::size_t perSecond) { rateLimit.store(perSecond, std::memory_order_relaxed); }
+
+    /**
+     * @brief Prefix every line with a UTC timestamp and the level
+     * @param enabled false writes the bare message (the default)
+     */
+    void SetDecorate(bool enabled) { decorate.store(enabled, std::memory_order_relaxed); }
+
+    /**
+     * @brief Check whether a level is written, before building costly arguments
+     */
+    bool Enabled(LogLevel level) const { return level != LogLevel::Off && level >= Level(); }
+
+    /**
+     * @brief Log the concatenation of parts
+     * @details Strings, characters, integers and floating-point numbers
+     * (printed like an ostream does by default) are accepted. Never blocks.
+     * @param level Severity
+     * @param parts Pieces of the message
+     */
+    template <typename... Parts>
+    void Write(LogLevel level, const Parts&... parts) {
+        Slot* slot = Claim(level);
+        if (slot == nullptr) {
+            return;
+        }
+        Text text{slot->Text, 0, false};
+        (text.Append(parts), ...);
+        slot->Length = static_cast<std::uint16_t>(text.Length);
+        if (text.Truncated) {
+            std::memcpy(slot->Text + kMessageBytes - 3, "...", 3);
+        }
+        Publish(slot);
+    }
+
+    template <typename... Parts> void Debug(const Parts&... parts) { Write(LogLevel::Debug, parts...); }
+    template <typename... Parts> void Info(const Parts&... parts) { Write(LogLevel::Info, parts...); }
+    template <typename... Parts> void Warning(const Parts&... parts) { Write(LogLevel::Warning, parts...); }
+    template <typename... Parts> void Error(const Parts&... parts) { Write(LogLevel::Error, parts...); }
+
+    /**
+     * @brief Write every message logged before the call, then return
+     * @details Used before reading from the console, so that the output of
+     * a command appears before the next prompt
+     */
+    void Flush();
+
+    /**
+     * @brief Messages lost because the ring buffer was full
+     */
+    std::uint64_t Dropped() const { return dropped.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Messages lost to the rate limit
+     */
+    std::uint64_t Suppressed() const { return suppressed.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Process-wide logger writing to std::cout and std::cerr
+     * @details Lives until the process ends and is flushed by exit()
+     */
+    static Logger& Shared();
+
+private:
+    struct Slot {
+        std::atomic<std::uint64_t> Sequence{0};  // Position + 1 when filled, position + capacity when free
+        std::int64_t Time = 0;                   // Milliseconds since the epoch
+        LogLevel Level = LogLevel::Info;
+        std::uint16_t Length = 0;
+        char Text[kMessageBytes];
+    };
+
+    // Appends message parts into a slot, cutting at kMessageBytes
+    struct Text {
+        char* Data;
+        std::size_t Length;
+        bool Truncated;
+
+        void Append(std::string_view part);
+        void Append(const char* part) { Append(std::string_view(part)); }
+        void Append(const std::string& part) { Append(std::string_view(part)); }
+        void Append(char part) { Append(std::string_view(&part, 1)); }
+        void Append(double part);
+        template <typename Integer, typename = std::enable_if_t<std::is_integral_v<Integer>>>
+        void Append(Integer part) {
+            char digits[24];
+            Append(std::string_view(digits, std::to_chars(digits, digits + sizeof(digits), part).ptr - digits));
+        }
+    };
+
+    Slot* Claim(LogLevel level);
+    void Publish(Slot* slot);
+    bool Admit(LogLevel level);
+    void Drain();
+    void FlushLoop();
+
+    std::ostream& out;
+    std::ostream& err;
+    std::unique_ptr<Slot[]> slots;
+    std::size_t mask;
+    alignas(64) std::atomic<std::uint64_t> tail{0};  // Next position to claim
+    alignas(64) std::uint64_t head = 0;              // Next position to write; guarded by drainMutex
+
+    std::atomic<LogLevel> threshold{LogLevel::Info};
+    std::atomic<std::size_t> rateLimit{0};
+    std::atomic<bool> decorate{false};
+    std::atomic<std::int64_t> windowSecond{0};
+    std::atomic<std::size_t> windowCount{0};
+    std::atomic<std::uint64_t> dropped{0};
+    std::atomic<std::uint64_t> suppressed{0};
+    std::uint64_t reportedDropped = 0;     // Guarded by drainMutex
+    std::uint64_t reportedSuppressed = 0;  // Guarded by drainMutex
+
+    std::mutex drainMutex;
+    std::mutex wakeMutex;
+    std::condition_variable wake;
+    bool stopping = false;
+    std::chrono::milliseconds interval;
+    std::thread flusher;
+};
+
+#endif // LOGGER_H
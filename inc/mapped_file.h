@@ -0,0 +1,84 @@
+/**
+ * @file mapped_file.h
+ * @brief Read-only memory mapping of a file
+ *
+ * @details Maps a whole file into the address space so parsers can read it
+ * in place instead of copying it through stream buffers. Files that cannot be
+ * mapped (pipes, special files) are read into an owned buffer instead, so a
+ * successful Open() always provides a contiguous view of the content.
+ */
+
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @class MappedFile
+ * @brief RAII wrapper around mmap (POSIX) or MapViewOfFile (Windows)
+ */
+class MappedFile {
+public:
+    /**
+     * @brief Expected access pattern, forwarded to the kernel as a hint
+     */
+    enum class Access {
+        Sequential,  ///< Read once front to back (madvise MADV_SEQUENTIAL, huge pages)
+        Random       ///< Random reads over the lifetime of the mapping (MADV_RANDOM)
+    };
+
+    MappedFile() = default;
+
+    /**
+     * @brief Destructor - unmaps the file
+     */
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    /**
+     * @brief Map a file read-only
+     * @param filename Path of the file to map
+     * @param access Access pattern hint
+     * @return true if the content is available through Data()/Size()
+     */
+    bool Open(const std::string& filename, Access access = Access::Sequential);
+
+    /**
+     * @brief Unmap the file; views into it become invalid
+     */
+    void Close();
+
+    /**
+     * @brief Check whether a file is open
+     */
+    bool IsOpen() const { return isOpen; }
+
+    /**
+     * @brief Check whether the content is memory mapped (not buffered)
+     */
+    bool IsMapped() const { return mapping != nullptr; }
+
+    const char* Data() const { return data; }   ///< First byte of the content
+    std::size_t Size() const { return size; }   ///< Content size in bytes
+
+    /**
+     * @brief Whole content as a view, valid while the file stays open
+     */
+    std::string_view View() const { return std::string_view(data, size); }
+
+private:
+    const char* data = nullptr;
+    std::size_t size = 0;
+    void* mapping = nullptr;     ///< Base address returned by the OS, null when buffered
+    std::vector<char> buffer;    ///< Fallback storage for files that cannot be mapped
+    bool isOpen = false;
+};
+
+#endif // MAPPED_FILE_H
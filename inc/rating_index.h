@@ -0,0 +1,99 @@
+/**
+ * @file rating_index.h
+ * @brief Order statistics over ratings on the 0.1 grid
+ */
+
+#ifndef RATING_INDEX_H
+#define RATING_INDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @class RatingIndex
+ * @brief Counting index of record positions by rating
+ *
+ * @details Ratings 0.0, 0.1, ..., 10.0 (the values Generate() produces and
+ * the scale users enter) each own a bucket holding the positions of their
+ * records in ascending order, so walking the buckets visits the records in
+ * (rating, position) order without sorting anything. A rating off that
+ * grid (e.g. 7.25) cannot be placed; it is only counted, and callers fall
+ * back to a general selection while any such record exists.
+ *
+ * Records must be added in increasing position order, which is the order a
+ * store appends them in.
+ */
+class RatingIndex {
+public:
+    static constexpr int kBuckets = 101;  ///< One bucket per tenth from 0.0 to 10.0
+
+    /**
+     * @brief Bucket of a rating
+     * @return 0..kBuckets-1, or -1 if the rating is not exactly a tenth in range
+     */
+    static int Bucket(double rating);
+
+    /**
+     * @brief Remove all records
+     */
+    void Clear();
+
+    /**
+     * @brief Index a record appended after all indexed ones
+     * @param record Position of the record
+     * @param rating Its rating
+     */
+    void Add(std::size_t record, double rating);
+
+    /**
+     * @brief Remove the record added last
+     * @param rating Its rating
+     */
+    void RemoveLast(double rating);
+
+    /**
+     * @brief Index a whole rating column from scratch
+     * @param ratings One rating per record
+     * @param count Number of records
+     */
+    void Build(const double* ratings, std::size_t count);
+
+    /**
+     * @brief Number of indexed records, placed or not
+     */
+    std::size_t Size() const { return records; }
+
+    /**
+     * @brief Check whether every record is placed in a bucket
+     */
+    bool Exact() const { return offGrid == 0; }
+
+    /**
+     * @brief Positions of the lowest and highest ranked records, in O(k)
+     * @details Ranks are (rating, position) as in LiteratureStore::PercentileBand();
+     * requires Exact(). Both bands come out in ascending rank order, the
+     * lower band first; they must not overlap (lowCount + topCount <= Size()).
+     * @param lowCount Number of records from the bottom
+     * @param topCount Number of records from the top
+     * @param indices Receives the positions
+     */
+    void Band(std::size_t lowCount, std::size_t topCount, std::vector<std::size_t>& indices) const;
+
+    /**
+     * @brief Records per bucket
+     */
+    std::size_t Count(int bucket) const { return buckets[bucket].size(); }
+
+    /**
+     * @brief Heap bytes held by the buckets
+     */
+    std::size_t MemoryUsage() const;
+
+private:
+    std::vector<std::uint32_t> buckets[kBuckets];
+    std::size_t offGrid = 0;  ///< Records that are not in a bucket
+    std::size_t records = 0;
+};
+
+#endif // RATING_INDEX_H
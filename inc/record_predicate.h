@@ -0,0 +1,134 @@
+/**
+ * @file record_predicate.h
+ * @brief Conditions on LiteratureStore records, compiled once and evaluated column by column
+ *
+ * @details A condition is written as comparisons joined with AND / OR
+ * (AND binds tighter, parentheses group):
+ *
+ *     Year >= 1990 AND Rating < 5
+ *     Publisher = "Dover Publications" OR (Year BETWEEN 1800 AND 1850 AND Rating != 0)
+ *     Author = "Leo Tolstoy"
+ *
+ * Operators are =, !=, <, <=, >, >= and BETWEEN low AND high (inclusive).
+ * Values are bare words or quoted with " or '. Year compares as an integer,
+ * Rating as a double with a 0.001 tolerance, Name, Publisher and ID as
+ * strings (byte order), and Author tests membership: = matches a record with
+ * that author among its authors, != a record without it. A record that lacks
+ * the field never matches a comparison on it.
+ *
+ * Literals are parsed into typed values while compiling, so evaluation only
+ * compares columns against constants. Comparisons on fields with a
+ * secondary index (LiteratureStore::IndexFields()) are answered from the
+ * index instead: equality on Name and Publisher, membership (=) on Author,
+ * everything but != on Year and Rating. An AND needs one such operand, whose
+ * matches are then tested against the rest; several Author operands under
+ * one AND are answered together by intersecting their posting lists. An OR
+ * needs all of its operands indexed.
+ */
+
+#ifndef RECORD_PREDICATE_H
+#define RECORD_PREDICATE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "literature_store.h"
+
+/**
+ * @class RecordPredicate
+ * @brief Compiled condition over the fields of a LiteratureStore
+ */
+class RecordPredicate {
+public:
+    /**
+     * @brief Comparison operators
+     */
+    enum class Op : std::uint8_t { Equal, NotEqual, Less, LessEqual, Greater, GreaterEqual, Between };
+
+    static constexpr std::size_t kMaxNesting = 256;  ///< Deepest parenthesis nesting Compile() accepts
+
+    /**
+     * @brief Create a predicate that matches nothing
+     */
+    RecordPredicate();
+
+    /**
+     * @brief Compile a condition
+     * @param condition Condition text (see file details)
+     * @param predicate Receives the compiled condition; unchanged on failure
+     * @param error Receives a description of the failure
+     * @return false on a syntax error, an unknown field, a value of the wrong
+     * type or parentheses nested deeper than kMaxNesting
+     */
+    static bool Compile(const std::string& condition, RecordPredicate& predicate, std::string& error);
+
+    /**
+     * @brief Single field = value comparison, as used by Delete(field, value)
+     * @details Unknown fields and values that do not parse as the field's
+     * type give a predicate that matches nothing
+     * @param field Field name
+     * @param value Value as text
+     */
+    static RecordPredicate Equals(const std::string& field, const std::string& value);
+
+    /**
+     * @brief Records listing every one of some authors
+     * @details Same as Author = a AND Author = b ..., without quoting the
+     * names; no authors gives a predicate that matches nothing
+     * @param authors Author names
+     */
+    static RecordPredicate Authors(const std::vector<std::string>& authors);
+
+    /**
+     * @brief Flag the records that satisfy the condition
+     * @details Each comparison scans one column; under AND, later
+     * comparisons skip records already rejected
+     * @param store Records to test
+     * @return One flag per record, true where the condition holds
+     */
+    std::vector<bool> Evaluate(const LiteratureStore& store) const;
+
+    /**
+     * @brief Positions of the records that satisfy the condition
+     * @details Costs O(k) in the number of candidates when the indexes can
+     * answer the condition, a scan otherwise
+     * @param store Records to test
+     * @return Matching positions in ascending order
+     */
+    std::vector<std::size_t> Find(const LiteratureStore& store) const;
+
+    /**
+     * @brief Test one record
+     * @param store Store holding the record
+     * @param i Slot index
+     */
+    bool Matches(const LiteratureStore& store, std::size_t i) const;
+
+private:
+    enum class Kind : std::uint8_t { None, And, Or, Compare };
+    enum class Column : std::uint8_t { Author, Name, Year, Publisher, Rating, ID };
+
+    // One node of the expression tree; children are listed in order
+    struct Node {
+        Kind Type = Kind::None;
+        std::vector<std::size_t> Children;
+        Column Field = Column::Name;
+        Op Operator = Op::Equal;
+        int IntLow = 0, IntHigh = 0;
+        double RealLow = 0.0, RealHigh = 0.0;
+        std::string TextLow, TextHigh;
+    };
+
+    class Parser;
+
+    static bool MakeCompare(const std::string& field, Op op, const std::string& low, const std::string& high,
+                            Node& node, std::string& error);
+    bool Test(const Node& node, const LiteratureStore& store, std::size_t i) const;
+    bool Candidates(std::size_t node, const LiteratureStore& store, std::vector<std::size_t>& positions) const;
+    void Apply(std::size_t node, const LiteratureStore& store, std::vector<std::uint8_t>& flags, bool narrow) const;
+
+    std::vector<Node> nodes;  ///< Expression tree, root last
+};
+
+#endif // RECORD_PREDICATE_H
@@ -13,24 +13,30 @@
 
 #include <string>
 #include <vector>
+#include <cstdint>
 #include <memory>
+#include <mutex>
+#include <algorithm>
+#include "literature.h"
+#include "literature_store.h"
+#include "id_allocator.h"
+#include "thread_pool.h"
+#include "literature_format.h"
+#include "workload_generator.h"
 #include "../ext/nlohmann/json.hpp"
 
 using json = nlohmann::json;
 
 /**
- * @struct Literature
- * @brief Data structure for literature items
- *
- * @details Task 1 data structure containing information about books/literature
- * with author, title, year, publisher, and rating fields
+ * @struct BandView
+ * @brief Records Execute() would keep, as positions into the record store
  */
-struct Literature {
-    std::vector<std::string> Author;  ///< List of authors
-    std::string Name;                  ///< Title of the book
-    int Year;                          ///< Publication year
-    std::string Publisher;             ///< Publisher name
-    double Rating;                     ///< Rating value (0.0-10.0)
+struct BandView {
+    std::uint64_t Version = 0;         ///< Dataset version the positions refer to
+    std::string Field;                 ///< Field the records are ranked by
+    double Lower = 0.0;                ///< Fraction kept from the bottom
+    double Upper = 0.0;                ///< Fraction kept from the top
+    std::vector<std::size_t> Indices;  ///< Lower band, then upper band, each in ascending rank order
 };
 
 /**
@@ -45,11 +51,27 @@ struct Literature {
  */
 class JSONHandler {
 private:
-    json data;
+    LiteratureStore store;
+    std::shared_ptr<ThreadPool> pool;  ///< Workers for Execute(), null for ThreadPool::Shared()
     std::string dataFilePath;
-    int idCounter;
+    IdAllocator ids;  ///< Numbers for generated IDs, above every ID seen
+    std::uint64_t version;  ///< Increased by every change to the records
+    std::uint8_t indexedFields;  ///< Secondary indexes kept on every store this handler serves
+    double compactionRatio;      ///< Fraction of deleted slots that triggers Compact()
+    mutable std::string appendFile;   ///< File already holding the first appendMark slots
+    mutable std::size_t appendMark;   ///< Slots written to appendFile (see SaveToFile())
+
+    std::string NextID(const std::string& name);
+    std::size_t DeleteRecords(const std::vector<std::size_t>& positions);
+    std::size_t CompactStore();
+
+    static constexpr std::size_t kMaxCachedViews = 8;
+    mutable std::mutex viewMutex;
+    mutable std::vector<std::shared_ptr<const BandView>> views;  ///< ExecuteView() results for version
 
 public:
+    static constexpr double kDefaultCompactionRatio = 0.25;
+
     /**
      * @brief Default constructor
      */
@@ -63,10 +85,17 @@ public:
     // Part A: Input/Output functions
     /**
      * @brief Load JSON data from file (Part A)
-     * @param filename Path to the JSON file to load
+     * @details Memory-maps the file and parses it in place straight into the
+     * record store without building a JSON DOM; large arrays are parsed in
+     * chunks on the shared thread pool. Records that do not match the schema
+     * are skipped and reported. NDJSON files are read line by line; CBOR,
+     * MessagePack and UBJSON files are decoded through the same SAX loader.
+     * @param filename Path to the file to load
+     * @param format File format, DataFormat::Auto to detect it from the
+     * extension or the leading bytes
      * @throws None (prints error message on failure)
      */
-    void Input(const std::string& filename);
+    void Input(const std::string& filename, DataFormat format = DataFormat::Auto);
 
     /**
      * @brief Print JSON data to console (Part A)
@@ -77,9 +106,38 @@ public:
     // Part B: Data processing functions
     /**
      * @brief Execute task-specific function (Part B)
-     * @details Filters data keeping 10% top and 10% bottom rated items
+     * @details Filters data keeping 10% top and 10% bottom rated items by
+     * default (see LiteratureStore::PercentileBand())
+     * @param field Numeric field to rank by ("Rating" or "Year")
+     * @param lower Fraction of records to keep from the bottom
+     * @param upper Fraction of records to keep from the top
      */
-    void Execute();
+    void Execute(const std::string& field = "Rating", double lower = 0.1, double upper = 0.1);
+
+    /**
+     * @brief Records Execute() would keep, without changing the data
+     * @details The view holds record positions, not copies. Views are cached
+     * per arguments until the records change, so repeating a query between
+     * writes returns the same view. Safe to call concurrently with other
+     * const calls.
+     * @param field Numeric field to rank by ("Rating" or "Year")
+     * @param lower Fraction of records from the bottom
+     * @param upper Fraction of records from the top
+     * @return View of GetStore() at Version(), or null if the arguments are invalid
+     */
+    std::shared_ptr<const BandView> ExecuteView(const std::string& field = "Rating", double lower = 0.1,
+                                                double upper = 0.1) const;
+
+    /**
+     * @brief Dataset version, increased by every change to the records
+     */
+    std::uint64_t Version() const { return version; }
+
+    /**
+     * @brief Set the number of threads used by Execute()
+     * @param threads Worker count, 0 for the process-wide pool (one per core)
+     */
+    void SetThreads(std::size_t threads);
 
     /**
      * @brief Interactively add new Literature item (Part B)
@@ -89,69 +147,238 @@ public:
 
     /**
      * @brief Delete items by field value (Part B)
+     * @details Matching records are marked deleted in O(matches) and
+     * compacted away in bulk (see SetCompactionRatio())
      * @param field Field name to match
      * @param value Value to match for deletion
      */
     void Delete(const std::string& field, const std::string& value);
 
+    /**
+     * @brief Delete items matching a condition
+     * @details The condition is compiled once (see RecordPredicate), e.g.
+     * "Year < 1900 OR (Publisher = 'Dover Publications' AND Rating <= 3)"
+     * @param condition Condition text
+     * @return false if the condition does not compile (nothing is deleted)
+     */
+    bool DeleteWhere(const std::string& condition);
+
+    /**
+     * @brief Delete the items listing every one of some authors
+     * @details With Author indexed (IndexField("Author")) the matches come
+     * from intersecting the authors' posting lists instead of a scan
+     * @param authors Author names; none deletes nothing
+     * @return Number of items deleted
+     */
+    std::size_t DeleteByAuthors(const std::vector<std::string>& authors);
+
+    /**
+     * @brief Set when deletes compact the store
+     * @details Deletes only mark records (LiteratureStore::Delete()); once
+     * the deleted records make up this fraction of the slots, the store is
+     * compacted. 0 compacts on every delete, 1 only when all slots are deleted.
+     * @param ratio Fraction of deleted slots, clamped to 0..1
+     */
+    void SetCompactionRatio(double ratio) { compactionRatio = std::min(1.0, std::max(0.0, ratio)); }
+
+    /**
+     * @brief Fraction of deleted slots that triggers a compaction
+     */
+    double CompactionRatio() const { return compactionRatio; }
+
+    /**
+     * @brief Reclaim the slots of deleted records now
+     * @return Number of slots reclaimed
+     */
+    std::size_t Compact();
+
+    /**
+     * @brief Find the items matching a condition without changing anything
+     * @details Uses the secondary indexes where they cover the condition
+     * (see RecordPredicate::Find())
+     * @param condition Condition text
+     * @param positions Receives the positions of the matches in GetStore(), ascending
+     * @return false if the condition does not compile
+     */
+    bool Query(const std::string& condition, std::vector<std::size_t>& positions) const;
+
+    /**
+     * @brief Find the items listing every one of some authors without changing anything
+     * @param authors Author names (see DeleteByAuthors())
+     * @return Positions of the matches in GetStore(), ascending
+     */
+    std::vector<std::size_t> QueryAuthors(const std::vector<std::string>& authors) const;
+
+    /**
+     * @brief Keep or drop a secondary index (see LiteratureStore::IndexFields())
+     * @details The choice also applies to data loaded later
+     * @param field "Author", "Name", "Publisher", "Year" or "Rating"
+     * @param enabled Build the index, or drop it
+     * @return false if the field cannot be indexed
+     */
+    bool IndexField(const std::string& field, bool enabled = true);
+
     /**
      * @brief Generate random Literature item (Part B)
      * @details Creates item with random data from predefined lists
+     * (see SampleLiterature())
      */
     void Generate();
 
     // Part E: Extended functions
     /**
      * @brief Generate unique ID for item (Part E)
+     * @details The number comes from the ID allocator and lies above
+     * every ID loaded, added or replayed so far; the suffix is the first
+     * three letters of the name (see FormatLiteratureID())
      * @param name Name to use for ID suffix
-     * @return Generated ID in format LIT###XXX
+     * @return Generated ID in format LIT###XXX, wider past 999
      */
     std::string GenerateID(const std::string& name);
 
     /**
      * @brief Validate ID format (Part E)
      * @param id ID string to validate
-     * @return true if ID matches pattern LIT[0-9]{3}[A-Z]{1,3}
+     * @return true if ID matches LIT, 3 to 19 digits and 1 to 3 capital
+     * letters (see ParseLiteratureID())
      */
     bool ValidateID(const std::string& id) const;
 
     /**
      * @brief Get item by ID (Part E)
+     * @details Looked up in the ID hash index (LiteratureStore::FindID())
      * @param id ID to search for
      * @return JSON object if found, empty JSON otherwise
      */
     json GetByID(const std::string& id) const;
 
+    /**
+     * @brief Get many items by ID in one call
+     * @param ids IDs to look up
+     * @return JSON array with one entry per ID, in order: the item, or null
+     * if the ID is invalid or unknown
+     */
+    json GetByIDs(const std::vector<std::string>& ids) const;
+
+    /**
+     * @brief Validate and look up many IDs in one call
+     * @details No JSON is built per ID, for reconciliation of large ID sets
+     * @param ids IDs to check
+     * @param positions Receives one entry per ID: the record position, or
+     * IdIndex::kNotFound if the ID is malformed or unknown
+     * @return Number of well-formed IDs
+     */
+    std::size_t ResolveIDs(const std::vector<std::string>& ids, std::vector<std::size_t>& positions) const;
+
     // Part F: Batch generation
     /**
      * @brief Generate multiple random items (Part F)
+     * @details Generated in parallel chunks on the thread pool (see
+     * GenerateLiterature()) and appended in bulk; the IDs come from one
+     * block leased from the ID allocator
      * @param count Number of items to generate
      */
     void Generate_ex(int count);
 
+    /**
+     * @brief Generate a reproducible synthetic dataset
+     * @details Records 0 .. count-1 of the workload (see WorkloadSpec),
+     * generated in parallel like Generate_ex(); equal specs give equal
+     * records, and equal IDs on handlers with equal ID state
+     * @param spec Distributions and seed
+     * @param count Number of items to generate
+     */
+    void GenerateWorkload(const WorkloadSpec& spec, std::size_t count);
+
+    /**
+     * @brief Keep the ID high-water mark in a file across restarts
+     * @details See IdAllocator::Persist(); IDs of deleted records are then
+     * not handed out again after a restart either
+     * @param path State file
+     * @return false if an existing file cannot be read
+     */
+    bool PersistIDs(const std::string& path);
+
     // Helper functions
     /**
      * @brief Save current data to file
+     * @details Records are serialized one at a time, no JSON DOM is built
      * @param filename Output file path
+     * @param format File format, DataFormat::Auto to choose it from the
+     * extension (JSON if the extension is not recognized)
+     * @param append Append to an existing file instead of replacing it
+     * (NDJSON only). Only the records added since the file was last loaded
+     * or saved by this handler are written; a file this handler has not
+     * read or written since its records were replaced gets every record
      */
-    void SaveToFile(const std::string& filename) const;
+    void SaveToFile(const std::string& filename, DataFormat format = DataFormat::Auto,
+                    bool append = false) const;
+
+    /**
+     * @brief Save current data as a columnar snapshot (see LiteratureSnapshot)
+     * @param filename Output file path
+     */
+    void SaveSnapshot(const std::string& filename) const;
+
+    /**
+     * @brief Open a columnar snapshot
+     * @details The file is memory-mapped and read in place, so opening takes
+     * the same time for any number of records; columns are copied into
+     * memory only when the data is modified. The ID index is built from the
+     * mapped IDs in one pass, so lookups by ID stay O(1)
+     * @param filename Path to the snapshot
+     * @param verify Also check the section checksums (reads the whole file)
+     */
+    void LoadSnapshot(const std::string& filename, bool verify = false);
+
+    /**
+     * @brief Append an already built item (used by the server)
+     * @param item JSON object with Literature fields
+     * @throws json::type_error if a field has the wrong type
+     */
+    void AddItem(const json& item);
 
     /**
      * @brief Get current JSON data
-     * @return Copy of internal JSON data
+     * @return JSON array built from the record store
      */
-    json GetData() const { return data; }
+    json GetData() const { return store.ToJson(); }
 
     /**
      * @brief Set JSON data
      * @param newData New JSON data to replace current
+     * @throws json::type_error on records that do not match the schema
+     */
+    void SetData(const json& newData) {
+        store = LiteratureStore::FromJson(newData);
+        store.IndexFields(indexedFields);
+        ids.Observe(store);
+        appendFile.clear();
+        ++version;
+    }
+
+    /**
+     * @brief Read-only access to the record store
+     */
+    const LiteratureStore& GetStore() const { return store; }
+
+    /**
+     * @brief Replace the record store, e.g. with one opened from a snapshot
+     * @param newStore Records to serve
      */
-    void SetData(const json& newData) { data = newData; }
+    void SetStore(LiteratureStore newStore) {
+        store = std::move(newStore);
+        store.IndexIDs();
+        store.IndexFields(indexedFields);
+        ids.Observe(store);
+        appendFile.clear();
+        ++version;
+    }
 
     /**
      * @brief Clear all data
      */
-    void Clear() { data.clear(); }
+    void Clear() { store.Clear(); appendFile.clear(); ++version; }
 
     // Conversion functions
     /**
@@ -0,0 +1,82 @@
+/**
+ * @file thread_pool.h
+ * @brief Fixed-size worker thread pool
+ */
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @class ThreadPool
+ * @brief Runs submitted tasks on a fixed set of worker threads
+ *
+ * @details Tasks are executed in submission order by whichever worker is
+ * free. Submit() returns a future for the task's result; exceptions thrown by
+ * a task are delivered through that future.
+ */
+class ThreadPool {
+public:
+    /**
+     * @brief Start the workers
+     * @param threads Number of workers, 0 for std::thread::hardware_concurrency()
+     */
+    explicit ThreadPool(std::size_t threads = 0);
+
+    /**
+     * @brief Finish queued tasks and join the workers
+     */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @brief Number of worker threads
+     */
+    std::size_t Size() const { return workers.size(); }
+
+    /**
+     * @brief Queue a task
+     * @param task Callable without arguments
+     * @return Future receiving the task's result or exception
+     */
+    template <typename Task>
+    std::future<std::invoke_result_t<Task>> Submit(Task&& task) {
+        using Result = std::invoke_result_t<Task>;
+        auto packaged = std::make_shared<std::packaged_task<Result()>>(std::forward<Task>(task));
+        std::future<Result> result = packaged->get_future();
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            tasks.emplace([packaged]() { (*packaged)(); });
+        }
+        queueReady.notify_one();
+        return result;
+    }
+
+    /**
+     * @brief Process-wide pool sized to the hardware concurrency
+     */
+    static ThreadPool& Shared();
+
+private:
+    void WorkerLoop();
+
+    std::vector<std::thread> workers;
+    std::queue<std::function<void()>> tasks;
+    std::mutex queueMutex;
+    std::condition_variable queueReady;
+    bool stopping = false;
+};
+
+#endif // THREAD_POOL_H
@@ -0,0 +1,181 @@
+/**
+ * @file workload_generator.h
+ * @brief Seeded synthetic datasets with configurable, production-like distributions
+ *
+ * @details A WorkloadSpec describes the dataset; written as JSON (all keys
+ * optional, defaults shown):
+ *
+ *     {
+ *       "Seed": 1,
+ *       "Authors":    {"Count": 10000, "Skew": 1.0, "Prefix": "Author", "File": ""},
+ *       "Publishers": {"Count": 500, "Skew": 1.0, "Prefix": "Publisher", "File": ""},
+ *       "Names":      {"Count": 100000, "Skew": 0.0, "Prefix": "Title", "File": ""},
+ *       "AuthorsPerRecord": [0.75, 0.2, 0.05],
+ *       "Years": [{"Min": 1800, "Max": 2024, "Weight": 1}],
+ *       "Rating": {"Shape": "normal", "Mean": 6.5, "StdDev": 1.5,
+ *                  "Mean2": 2.5, "StdDev2": 1.0, "Weight2": 0.25}
+ *     }
+ *
+ * A vocabulary draws its words from File (one per line, blank lines
+ * skipped) or, without one, from Count synthetic words "Prefix 1" ...
+ * Word k has Zipf weight 1 / k^Skew: Skew 0 is uniform, 1 the classic
+ * long tail. AuthorsPerRecord weighs 1, 2, 3 ... authors; Years picks a
+ * range by weight and a year uniformly inside it; Rating is "uniform" on
+ * 0..10, "normal" (Mean, StdDev) or "bimodal" (a second normal, Mean2 and
+ * StdDev2, drawn with probability Weight2), clamped to 0..10 and rounded
+ * to the 0.1 grid.
+ *
+ * Every record is drawn from its own generator seeded with (Seed, record
+ * index), and the draws use only FastRandom and <cmath> (no std::
+ * distributions, whose output differs between standard libraries), so a
+ * spec reproduces the same records bit for bit whatever the number of
+ * threads or the order of generation. That holds on one platform and
+ * math library: normal ratings go through std::log and std::cos, whose
+ * last bits may differ elsewhere and move a rating to a neighbouring tenth.
+ */
+
+#ifndef WORKLOAD_GENERATOR_H
+#define WORKLOAD_GENERATOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "literature.h"
+#include "literature_generator.h"
+#include "../ext/nlohmann/json.hpp"
+
+using json = nlohmann::json;
+
+/**
+ * @struct WorkloadSpec
+ * @brief Distributions of a synthetic dataset (see file details)
+ */
+struct WorkloadSpec {
+    /**
+     * @struct Vocabulary
+     * @brief Words of one string field and their popularity
+     */
+    struct Vocabulary {
+        std::vector<std::string> Words;  ///< Loaded words; empty for synthetic ones
+        std::size_t Count = 0;           ///< Number of synthetic words
+        double Skew = 0.0;               ///< Zipf exponent, 0 for uniform
+        std::string Prefix;              ///< Synthetic words are "Prefix N"
+    };
+
+    /**
+     * @struct YearRange
+     * @brief Years [Min, Max] chosen with a relative weight
+     */
+    struct YearRange {
+        int Min = 1800;
+        int Max = 2024;
+        double Weight = 1.0;
+    };
+
+    /**
+     * @enum RatingShape
+     * @brief Distribution of the Rating field
+     */
+    enum class RatingShape { Uniform, Normal, Bimodal };
+
+    static constexpr std::size_t kMaxWords = 0xffffffffu;                 ///< Largest vocabulary, drawn with 32 bits
+    static constexpr std::size_t kMaxSkewedWords = std::size_t(1) << 22;  ///< Largest with Skew > 0, one weight per word
+
+    std::uint64_t Seed = 1;
+    Vocabulary Authors{{}, 10000, 1.0, "Author"};
+    Vocabulary Publishers{{}, 500, 1.0, "Publisher"};
+    Vocabulary Names{{}, 100000, 0.0, "Title"};
+    std::vector<double> AuthorsPerRecord = {0.75, 0.2, 0.05};  ///< Weight of 1, 2, 3 ... authors
+    std::vector<YearRange> Years = {YearRange()};
+    RatingShape Rating = RatingShape::Normal;
+    double RatingMean = 6.5;
+    double RatingStdDev = 1.5;
+    double RatingMean2 = 2.5;    ///< Second mode of a bimodal rating
+    double RatingStdDev2 = 1.0;
+    double RatingWeight2 = 0.25; ///< Share of the second mode
+
+    /**
+     * @brief Read a spec from JSON (see file details)
+     * @details Vocabulary files are loaded here
+     * @param config Spec object; missing keys keep their defaults
+     * @param spec Receives the spec; unchanged on failure
+     * @param error Receives a description of the failure
+     * @return false on an unknown shape, a bad value or an unreadable file
+     */
+    static bool FromJson(const json& config, WorkloadSpec& spec, std::string& error);
+
+    /**
+     * @brief Read a spec from a JSON file
+     * @see FromJson()
+     */
+    static bool Load(const std::string& filename, WorkloadSpec& spec, std::string& error);
+
+    /**
+     * @brief Read a vocabulary file, one word per line
+     * @param filename File to read
+     * @param words Receives the words; blank lines and trailing CRs are dropped
+     * @return false if the file cannot be opened or holds no word
+     */
+    static bool LoadWords(const std::string& filename, std::vector<std::string>& words);
+};
+
+/**
+ * @class WorkloadGenerator
+ * @brief Draws records following a WorkloadSpec
+ *
+ * @details The Zipf and weight tables are built once by the constructor;
+ * Record() is const and safe to call from many threads.
+ */
+class WorkloadGenerator {
+public:
+    /**
+     * @brief Prepare the tables of a spec
+     * @param spec Distributions as FromJson() accepts them; copied
+     */
+    explicit WorkloadGenerator(const WorkloadSpec& spec);
+
+    /**
+     * @brief Draw one record
+     * @details Depends only on the spec and index; the strings of lit are reused
+     * @param index Record index within the dataset
+     * @param lit Receives the record
+     */
+    void Record(std::uint64_t index, Literature& lit) const;
+
+    /**
+     * @brief The spec being followed
+     */
+    const WorkloadSpec& Spec() const { return spec; }
+
+private:
+    // Cumulative weights; a draw is the first entry above a uniform value.
+    // Without weights the Size entries are equally likely
+    struct Table {
+        std::vector<double> Cumulative;
+        std::size_t Size = 0;
+        std::size_t Pick(FastRandom& random) const;
+    };
+
+    void Word(const WorkloadSpec::Vocabulary& vocabulary, const Table& table, FastRandom& random,
+              std::string& out) const;
+    double Normal(FastRandom& random, double mean, double deviation) const;
+
+    WorkloadSpec spec;
+    Table authors, publishers, names, authorCounts, years;
+};
+
+/**
+ * @brief Generate records of a workload into a store in parallel
+ * @details Records 0 .. count-1 of the workload, appended through
+ * GenerateLiterature() with IDs leased from ids
+ * @param workload Generator to draw from
+ * @param count Number of records
+ * @param ids Allocator numbering the IDs
+ * @param store Target
+ * @param pool Pool running the chunks
+ */
+void GenerateWorkload(const WorkloadGenerator& workload, std::size_t count, IdAllocator& ids, LiteratureStore& store,
+                      ThreadPool& pool = ThreadPool::Shared());
+
+#endif // WORKLOAD_GENERATOR_H
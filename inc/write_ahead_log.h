@@ -0,0 +1,200 @@
+/**
+ * @file write_ahead_log.h
+ * @brief Append-only write-ahead log with group commit
+ *
+ * @details Each entry is a JSON object stored as one frame:
+ *
+ *     uint32 payload length | uint64 sequence | uint64 checksum | MessagePack payload
+ *
+ * (header fields little-endian; the checksum is Checksum64(payload) mixed
+ * with the sequence number). Sequence numbers keep increasing across
+ * restarts, so a snapshot can record the last entry it contains and the log
+ * can be trimmed up to it. Appends only copy the frame into a buffer;
+ * a background thread writes everything buffered with one write() and one
+ * fsync, so concurrent committers share a single sync (group commit). A
+ * torn or corrupt tail left by a crash ends the replay and is cut off.
+ */
+
+#ifndef WRITE_AHEAD_LOG_H
+#define WRITE_AHEAD_LOG_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../ext/nlohmann/json.hpp"
+
+using json = nlohmann::json;
+
+/**
+ * @enum WalSyncPolicy
+ * @brief When appended entries are forced to stable storage
+ */
+enum class WalSyncPolicy {
+    Always,    ///< WaitDurable() returns after the entry is fsynced (batched across writers)
+    Interval,  ///< fsync every WalOptions::Interval; a crash may lose the last interval
+    Never      ///< Written to the OS without fsync; survives a process crash, not a power loss
+};
+
+/**
+ * @struct WalOptions
+ * @brief Write-ahead log configuration
+ */
+struct WalOptions {
+    WalSyncPolicy Sync = WalSyncPolicy::Always;           ///< Sync policy
+    std::chrono::milliseconds Interval{100};              ///< fsync period for WalSyncPolicy::Interval
+    std::uint64_t MaxEntryBytes = 0xffffffffu;            ///< Largest payload, at most WriteAheadLog::kMaxEntryBytes
+};
+
+/**
+ * @brief Parse a sync policy name ("always", "interval", "never"/"none")
+ * @param name Policy name
+ * @param policy Receives the policy
+ * @return false if the name is unknown
+ */
+bool ParseWalSyncPolicy(const std::string& name, WalSyncPolicy& policy);
+
+/**
+ * @class WriteAheadLog
+ * @brief Durable, ordered log of JSON entries
+ *
+ * @details Append() is thread-safe and assigns increasing sequence numbers
+ * in call order, so callers that append under their own lock get the log
+ * order of their mutations.
+ */
+class WriteAheadLog {
+public:
+    static constexpr std::size_t kMaxEntryBytes = 0xffffffffu;  ///< Largest payload a frame length holds
+
+    /**
+     * @brief Counters since Open()
+     */
+    struct Stats {
+        std::uint64_t Entries = 0;  ///< Entries appended
+        std::uint64_t Bytes = 0;    ///< Bytes written, frame headers included
+        std::uint64_t Syncs = 0;    ///< fsync calls (fewer than Entries under group commit)
+    };
+
+    /**
+     * @brief Create a closed log
+     * @param options Sync configuration
+     */
+    explicit WriteAheadLog(WalOptions options = WalOptions());
+
+    /**
+     * @brief Flush, sync and close
+     */
+    ~WriteAheadLog();
+
+    WriteAheadLog(const WriteAheadLog&) = delete;
+    WriteAheadLog& operator=(const WriteAheadLog&) = delete;
+
+    /**
+     * @brief Replay an existing log and open it for appending
+     * @details Valid entries newer than after are passed to apply in log
+     * order. Reading stops at the first incomplete or corrupt frame, and the
+     * file is truncated there so new entries follow the last valid one. A
+     * missing file is created. New entries are numbered after both the last
+     * entry found and after.
+     * @param filename Log file path
+     * @param apply Called once per replayed entry
+     * @param error Receives a description of the failure
+     * @param after Sequence number already covered elsewhere (e.g. by a snapshot)
+     * @return false if the file cannot be read or opened
+     */
+    bool Open(const std::string& filename, const std::function<void(const json&)>& apply, std::string& error,
+              std::uint64_t after = 0);
+
+    /**
+     * @brief Check whether the log is open
+     */
+    bool IsOpen() const { return fd >= 0; }
+
+    /**
+     * @brief Queue an entry
+     * @param entry JSON object to log
+     * @return Sequence number of the entry, to be passed to WaitDurable();
+     * 0 if its payload is larger than WalOptions::MaxEntryBytes. The entry is
+     * then not logged and the log fails (see Failed()): the caller's state
+     * already differs from what the log describes
+     */
+    std::uint64_t Append(const json& entry);
+
+    /**
+     * @brief Wait until an entry is as durable as the sync policy promises
+     * @details Blocks only under WalSyncPolicy::Always; entries appended
+     * while a sync is in flight are synced together by the next one
+     * @param sequence Value returned by Append()
+     * @return false if writing the log failed
+     */
+    bool WaitDurable(std::uint64_t sequence);
+
+    /**
+     * @brief Write and fsync everything appended so far, regardless of policy
+     * @return false if writing the log failed
+     */
+    bool Flush();
+
+    /**
+     * @brief Drop the entries up to a sequence number, e.g. once a snapshot holds them
+     * @details Later entries are copied to a new file that atomically
+     * replaces the log; appends wait meanwhile, which takes as long as
+     * copying the entries made since that sequence number
+     * @param sequence Last entry to drop
+     * @param error Receives a description of the failure
+     * @return false if the log could not be rewritten (it is then unchanged)
+     */
+    bool TrimThrough(std::uint64_t sequence, std::string& error);
+
+    /**
+     * @brief Check whether writing the log failed
+     * @details Sticky: once set, no later entry reaches the file, so
+     * callers must stop changing what the log describes
+     */
+    bool Failed() const;
+
+    /**
+     * @brief Sequence number of the last appended entry
+     */
+    std::uint64_t LastSequence() const;
+
+    /**
+     * @brief Counters since Open()
+     */
+    Stats GetStats() const;
+
+    /**
+     * @brief Entries found by the last Open()
+     */
+    std::uint64_t Replayed() const { return replayed; }
+
+private:
+    void FlushLoop();
+    bool WriteBatch(std::unique_lock<std::mutex>& lock, bool sync);
+    void Close();
+
+    WalOptions options;
+    std::string path;
+    int fd = -1;
+    std::uint64_t replayed = 0;
+
+    mutable std::mutex mutex;
+    std::condition_variable work;     ///< Wakes the flusher
+    std::condition_variable durable;  ///< Wakes WaitDurable() callers
+    std::vector<char> pending;        ///< Frames not yet written
+    std::uint64_t appended = 0;       ///< Sequence number of the last appended entry
+    std::uint64_t written = 0;        ///< Last entry handed to the OS
+    std::uint64_t synced = 0;         ///< Last entry on stable storage
+    bool writing = false;             ///< A batch is being written outside the lock
+    bool failed = false;
+    bool stopping = false;
+    Stats stats;
+    std::thread flusher;
+};
+
+#endif // WRITE_AHEAD_LOG_H
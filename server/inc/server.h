@@ -4,7 +4,11 @@
 #include <string>
 #include <memory>
 #include <atomic>
+#include <mutex>
+#include <shared_mutex>
 #include "../../inc/task.h"
+#include "../../inc/write_ahead_log.h"
+#include "../../inc/checkpointer.h"
 #include "../../ext/httplib.h"
 #include "../../ext/nlohmann/json.hpp"
 
@@ -17,6 +21,14 @@ private:
     std::atomic<bool> shouldStop;
     int serverPort;
 
+    std::shared_mutex dataMutex;          ///< Shared by read-only commands, exclusive for the others
+    std::unique_ptr<WriteAheadLog> wal;   ///< Log of mutating commands, null if disabled
+    std::unique_ptr<Checkpointer> checkpointer;  ///< Background snapshots, null if disabled
+    std::uint64_t checkpointSequence = 0;        ///< Last log entry held by the loaded snapshot
+
+    static constexpr std::size_t kLogBatchRecords = 4096;  ///< Records per logged append entry
+    static constexpr std::size_t kNothingAppended = static_cast<std::size_t>(-1);
+
 public:
     JSONServer(int port = 8080);
     ~JSONServer();
@@ -24,12 +36,94 @@ public:
     void Start();
     void Stop();
 
+    /**
+     * @brief Replay a write-ahead log into the dataset and log every later mutation
+     * @details Mutating commands are logged after they are applied and
+     * answered once the entry is durable under the configured sync policy.
+     * Entries already held by the checkpoint loaded by EnableCheckpoints()
+     * are skipped. Call before Start().
+     * @param path Log file path (created if missing)
+     * @param options Sync policy
+     * @return false if the log cannot be opened
+     */
+    bool EnableWal(const std::string& path, const WalOptions& options);
+
+    /**
+     * @brief Load the last checkpoint and write new ones in the background
+     * @details The snapshot file is opened if it exists. Checkpoints freeze
+     * the dataset under the command lock (constant time) and are written on
+     * their own thread while commands keep running; afterwards the log is
+     * trimmed up to the checkpoint. Call before EnableWal() and Start().
+     * @param options Snapshot path and interval
+     * @return false if an existing snapshot cannot be opened
+     */
+    bool EnableCheckpoints(const CheckpointOptions& options);
+
+    /**
+     * @brief Set the number of threads the execute command uses
+     * @param threads Worker count, 0 for one per core
+     */
+    void SetThreads(std::size_t threads) { handler->SetThreads(threads); }
+
+    /**
+     * @brief Set when deletes compact the store (see JSONHandler::SetCompactionRatio())
+     * @param ratio Fraction of deleted slots, 0..1
+     */
+    void SetCompactionRatio(double ratio) { handler->SetCompactionRatio(ratio); }
+
+    /**
+     * @brief Keep a secondary index on a field (see JSONHandler::IndexField())
+     * @param field "Author", "Name", "Publisher", "Year" or "Rating"
+     * @return false if the field cannot be indexed
+     */
+    bool IndexField(const std::string& field) { return handler->IndexField(field); }
+
+    /**
+     * @brief Keep the ID high-water mark in a file (see JSONHandler::PersistIDs())
+     * @details Call before EnableWal(), so replayed records are numbered above it
+     * @param path State file
+     * @return false if an existing file cannot be read
+     */
+    bool PersistIDs(const std::string& path) { return handler->PersistIDs(path); }
+
+    /**
+     * @brief Run one command as the /command route does
+     * @details Safe to call from many threads at once: read-only commands
+     * (IsReadOnly()) run in parallel under a shared lock, the others one at
+     * a time under an exclusive lock
+     * @param request {"Command": name, "Param": [strings]}
+     * @return Response with Command, Result and command-specific fields
+     */
+    json ProcessCommand(const json& request);
+
+    /**
+     * @brief Check whether a command only reads the dataset
+     * @param command Command name
+     * @return true for print, execute_view, get_by_id, resolve_ids, query,
+     * query_by_author, index_status and checkpoint_status
+     */
+    static bool IsReadOnly(const std::string& command);
+
+    /**
+     * @brief Check whether a command is written to the write-ahead log
+     * @details Once the log has failed these commands are rejected
+     * @param command Command name
+     */
+    static bool IsLogged(const std::string& command);
+
 private:
     void SetupRoutes();
     void HandleCommand(const httplib::Request& req, httplib::Response& res);
     void HandlePing(const httplib::Request& req, httplib::Response& res);
 
-    json ProcessCommand(const json& request);
+    void ApplyLogEntry(const json& entry);
+    /**
+     * @brief Log the records from a position on as append entries of at most kLogBatchRecords
+     * @param first Position of the first record
+     * @param sequence Receives the sequence number of the last entry; unchanged if none
+     * @return false if an entry could not be logged
+     */
+    bool LogRecords(std::size_t first, std::uint64_t& sequence);
     json CreateResponse(const std::string& command, int result) const;
 };
 
@@ -16,7 +16,16 @@
     #endif
 #endif
 
+#include <algorithm>
+#include <cstdint>
+#include <memory>
 #include <string>
+#include <vector>
+#include "../../../inc/literature_store.h"
+#include "../../../inc/id_allocator.h"
+#include "../../../inc/thread_pool.h"
+#include "../../../inc/workload_generator.h"
+#include "../../../inc/literature_format.h"
 #include "../../../ext/nlohmann/json.hpp"
 
 using json = nlohmann::json;
@@ -34,11 +43,22 @@ extern "C" {
  */
 class LIBRARY_API JSONHandlerLib {
 private:
-    json data;
-    int idCounter;
+    LiteratureStore store;
+    std::shared_ptr<ThreadPool> pool;  ///< Workers for Execute(), null for ThreadPool::Shared()
+    IdAllocator ids;  ///< Numbers for generated IDs, above every ID seen
     std::string dataFilePath;
+    std::uint8_t indexedFields;  ///< Secondary indexes kept on every loaded store
+    double compactionRatio;      ///< Fraction of deleted slots that triggers Compact()
+    mutable std::string appendFile;   ///< File already holding the first appendMark slots
+    mutable std::size_t appendMark;   ///< Slots written to appendFile (see SaveToFile())
+
+    std::string NextID(const std::string& name);
+    int DeleteRecords(const std::vector<std::size_t>& positions);
+    std::size_t CompactStore();
 
 public:
+    static constexpr double kDefaultCompactionRatio = 0.25;
+
     /**
      * @brief Constructor - initializes the handler
      */
@@ -51,10 +71,12 @@ public:
 
     /**
      * @brief Load JSON data from file
-     * @param filename Path to the JSON file to load
-     * @return true if successful, false otherwise
+     * @details Records that do not match the schema are skipped
+     * @param filename Path to the file to load
+     * @param format File format, DataFormat::Auto to detect it
+     * @return true if the file was read and parsed, false otherwise
      */
-    bool Input(const std::string& filename);
+    bool Input(const std::string& filename, DataFormat format = DataFormat::Auto);
 
     /**
      * @brief Get current JSON data as string
@@ -64,26 +86,99 @@ public:
 
     /**
      * @brief Execute task function (filter by rating)
-     * @details Keeps 10% top and 10% bottom rated items
+     * @details Keeps 10% top and 10% bottom rated items by default
+     * @param field Numeric field to rank by ("Rating" or "Year")
+     * @param lower Fraction of records to keep from the bottom
+     * @param upper Fraction of records to keep from the top
      * @return true if successful, false otherwise
      */
-    bool Execute();
+    bool Execute(const std::string& field = "Rating", double lower = 0.1, double upper = 0.1);
+
+    /**
+     * @brief Set the number of threads used by Execute()
+     * @param threads Worker count, 0 for the process-wide pool (one per core)
+     */
+    void SetThreads(std::size_t threads);
 
     /**
      * @brief Add new item to data
      * @param item JSON object to add
-     * @return true if successful, false otherwise
+     * @return true if successful, false if the item does not match the schema
      */
     bool AddItem(const json& item);
 
     /**
      * @brief Delete items by field value
+     * @details Matching records are marked deleted in O(matches) and
+     * compacted away in bulk (see SetCompactionRatio())
      * @param field Field name to match
      * @param value Value to match
      * @return Number of items deleted
      */
     int Delete(const std::string& field, const std::string& value);
 
+    /**
+     * @brief Delete items matching a condition (see RecordPredicate)
+     * @param condition Condition text, e.g. "Year BETWEEN 1800 AND 1850 AND Rating < 5"
+     * @return Number of items deleted, or -1 if the condition does not compile
+     */
+    int DeleteWhere(const std::string& condition);
+
+    /**
+     * @brief Delete the items listing every one of some authors
+     * @details Answered from the author index when Author is indexed
+     * @param authors Author names; none deletes nothing
+     * @return Number of items deleted
+     */
+    int DeleteByAuthors(const std::vector<std::string>& authors);
+
+    /**
+     * @brief Set when deletes compact the store
+     * @details Deletes only mark records (LiteratureStore::Delete()); once
+     * the deleted records make up this fraction of the slots, the store is
+     * compacted. 0 compacts on every delete, 1 only when all slots are deleted.
+     * @param ratio Fraction of deleted slots, clamped to 0..1
+     */
+    void SetCompactionRatio(double ratio) { compactionRatio = std::min(1.0, std::max(0.0, ratio)); }
+
+    /**
+     * @brief Fraction of deleted slots that triggers a compaction
+     */
+    double CompactionRatio() const { return compactionRatio; }
+
+    /**
+     * @brief Reclaim the slots of deleted records now
+     * @return Number of slots reclaimed
+     */
+    std::size_t Compact();
+
+    /**
+     * @brief Find the items matching a condition, using the secondary indexes where possible
+     * @param condition Condition text (see RecordPredicate)
+     * @return JSON array of the matches in record order, null if the condition does not compile
+     */
+    json Query(const std::string& condition) const;
+
+    /**
+     * @brief Find the items listing every one of some authors
+     * @param authors Author names
+     * @return JSON array of the matches in record order
+     */
+    json QueryAuthors(const std::vector<std::string>& authors) const;
+
+    /**
+     * @brief Keep or drop a secondary index (see LiteratureStore::IndexFields())
+     * @param field "Author", "Name", "Publisher", "Year" or "Rating"
+     * @param enabled Build the index, or drop it
+     * @return false if the field cannot be indexed
+     */
+    bool IndexField(const std::string& field, bool enabled = true);
+
+    /**
+     * @brief Heap bytes held by the secondary indexes
+     */
+    std::size_t IndexMemoryUsage() const { return store.IndexMemoryUsage(); }
+
     /**
      * @brief Generate random item
      * @return Generated item as JSON
@@ -92,11 +187,28 @@ public:
 
     /**
      * @brief Generate multiple items
+     * @details Generated in parallel chunks and appended in bulk (see
+     * GenerateLiterature()); the IDs come from one block leased from the ID allocator
      * @param count Number of items to generate
      * @return true if successful, false otherwise
      */
     bool GenerateEx(int count);
 
+    /**
+     * @brief Generate a reproducible synthetic dataset (see WorkloadSpec)
+     * @param spec Distributions and seed
+     * @param count Number of items to generate
+     * @return true if successful, false otherwise
+     */
+    bool GenerateWorkload(const WorkloadSpec& spec, int count);
+
+    /**
+     * @brief Keep the ID high-water mark in a file across restarts
+     * @param path State file (see IdAllocator::Persist())
+     * @return false if an existing file cannot be read
+     */
+    bool PersistIDs(const std::string& path);
+
     /**
      * @brief Generate unique ID
      * @param name Name to use for ID generation
@@ -118,24 +230,66 @@ public:
      */
     json GetByID(const std::string& id) const;
 
+    /**
+     * @brief Get many items by ID in one call
+     * @param ids IDs to look up
+     * @return JSON array with one entry per ID, in order: the item, or null
+     * if the ID is invalid or unknown
+     */
+    json GetByIDs(const std::vector<std::string>& ids) const;
+
+    /**
+     * @brief Validate and look up many IDs in one call
+     * @details No JSON is built per ID, for reconciliation of large ID sets
+     * @param ids IDs to check
+     * @param positions Receives one entry per ID: the record position, or
+     * IdIndex::kNotFound if the ID is malformed or unknown
+     * @return Number of well-formed IDs
+     */
+    std::size_t ResolveIDs(const std::vector<std::string>& ids, std::vector<std::size_t>& positions) const;
+
     /**
      * @brief Save data to file
      * @param filename Path to save file
+     * @param format File format, DataFormat::Auto to choose it from the extension
+     * @param append Append to an existing file (NDJSON only); records the
+     * file got from this handler's last load or save are not written again
+     * @return true if successful, false otherwise
+     */
+    bool SaveToFile(const std::string& filename, DataFormat format = DataFormat::Auto,
+                    bool append = false) const;
+
+    /**
+     * @brief Save data as a columnar snapshot
+     * @param filename Path to save file
      * @return true if successful, false otherwise
      */
-    bool SaveToFile(const std::string& filename) const;
+    bool SaveSnapshot(const std::string& filename) const;
+
+    /**
+     * @brief Open a columnar snapshot; records are read from the mapped file
+     * @param filename Path to the snapshot
+     * @param verify Also check the section checksums
+     * @return true if the snapshot is valid, false otherwise
+     */
+    bool LoadSnapshot(const std::string& filename, bool verify = false);
 
     /**
      * @brief Get current data
-     * @return Current JSON data
+     * @return JSON array built from the record store
      */
-    json GetData() const { return data; }
+    json GetData() const { return store.ToJson(); }
 
     /**
      * @brief Set data
      * @param newData New JSON data to set
+     * @throws json::type_error on records that do not match the schema
      */
-    void SetData(const json& newData) { data = newData; }
+    void SetData(const json& newData) {
+        store = LiteratureStore::FromJson(newData);
+        store.IndexFields(indexedFields);
+        appendFile.clear();
+    }
 };
 
 // C-style wrapper functions for maximum compatibility
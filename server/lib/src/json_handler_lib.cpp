@@ -1,202 +1,197 @@
 #include "../inc/json_handler_lib.h"
+#include "../../../inc/literature_loader.h"
+#include "../../../inc/literature_writer.h"
+#include "../../../inc/literature_snapshot.h"
+#include "../../../inc/record_predicate.h"
+#include "../../../inc/literature_id.h"
+#include "../../../inc/literature_generator.h"
 #include <iostream>
 #include <fstream>
-#include <sstream>
 #include <algorithm>
 #include <random>
-#include <regex>
-#include <iomanip>
 #include <chrono>
 
-JSONHandlerLib::JSONHandlerLib() : idCounter(1) {
+JSONHandlerLib::JSONHandlerLib() : indexedFields(0), compactionRatio(kDefaultCompactionRatio), appendMark(0) {
     dataFilePath = "data.json";
 }
 
 JSONHandlerLib::~JSONHandlerLib() {}
 
-bool JSONHandlerLib::Input(const std::string& filename) {
-    std::ifstream file(filename);
-    if (!file.is_open()) {
-        return false;
-    }
+bool JSONHandlerLib::Input(const std::string& filename, DataFormat format) {
+    LiteratureStore loaded;
+    LoadReport report;
 
-    try {
-        file >> data;
-        file.close();
-        return true;
-    } catch (const json::parse_error&) {
-        file.close();
+    if (!LoadLiteratureFile(filename, format, loaded, report) || !report.Ok()) {
         return false;
     }
+    store = std::move(loaded);
+    store.IndexFields(indexedFields);
+    ids.Observe(store);
+    appendFile = filename;
+    appendMark = store.Size();
+    return true;
 }
 
 std::string JSONHandlerLib::GetPrintOutput() const {
-    if (data.empty()) {
+    if (store.Empty()) {
         return "No data to display.";
     }
-    return data.dump(4);
+    return store.ToJson().dump(4);
 }
 
-bool JSONHandlerLib::Execute() {
-    if (!data.is_array() || data.empty()) {
+bool JSONHandlerLib::Execute(const std::string& field, double lower, double upper) {
+    if (store.Empty()) {
         return false;
     }
 
-    std::vector<json> items;
-    for (const auto& item : data) {
-        items.push_back(item);
+    // Rating bands come from the index, built here once after a snapshot open
+    store.IndexRatings();
+    std::vector<size_t> result;
+    if (!store.PercentileBand(field, lower, upper, result, pool ? *pool : ThreadPool::Shared())) {
+        return false;
     }
 
-    // Sort by Rating field
-    std::sort(items.begin(), items.end(), [](const json& a, const json& b) {
-        if (!a.contains("Rating") || !b.contains("Rating")) return false;
-        return a["Rating"].get<double>() < b["Rating"].get<double>();
-    });
-
-    // Calculate 10% of items
-    size_t tenPercent = std::max(size_t(1), items.size() / 10);
+    store = store.Select(result);
+    appendFile.clear();
+    return true;
+}
 
-    json result = json::array();
+void JSONHandlerLib::SetThreads(std::size_t threads) {
+    pool = threads == 0 ? nullptr : std::make_shared<ThreadPool>(threads);
+}
 
-    // Add bottom 10% (lowest ratings)
-    for (size_t i = 0; i < tenPercent && i < items.size(); ++i) {
-        result.push_back(items[i]);
+bool JSONHandlerLib::AddItem(const json& item) {
+    try {
+        store.AppendJson(item);
+        if (store.Has(store.Size() - 1, LiteratureStore::kID)) {
+            ids.Observe(store.ID(store.Size() - 1));
+        }
+        return true;
+    } catch (const json::exception&) {
+        return false;
     }
+}
 
-    // Add top 10% (highest ratings)
-    size_t startIdx = items.size() > tenPercent ? items.size() - tenPercent : 0;
-    for (size_t i = startIdx; i < items.size(); ++i) {
-        if (std::find(result.begin(), result.end(), items[i]) == result.end()) {
-            result.push_back(items[i]);
-        }
+int JSONHandlerLib::Delete(const std::string& field, const std::string& value) {
+    return DeleteRecords(RecordPredicate::Equals(field, value).Find(store));
+}
+
+int JSONHandlerLib::DeleteWhere(const std::string& condition) {
+    RecordPredicate predicate;
+    std::string error;
+    if (!RecordPredicate::Compile(condition, predicate, error)) {
+        return -1;
     }
+    return DeleteRecords(predicate.Find(store));
+}
 
-    data = result;
-    return true;
+int JSONHandlerLib::DeleteByAuthors(const std::vector<std::string>& authors) {
+    return DeleteRecords(RecordPredicate::Authors(authors).Find(store));
 }
 
-bool JSONHandlerLib::AddItem(const json& item) {
-    if (!data.is_array()) {
-        data = json::array();
+int JSONHandlerLib::DeleteRecords(const std::vector<std::size_t>& positions) {
+    std::size_t removed = store.Delete(positions);
+    if (removed > 0 && store.Deleted() >= compactionRatio * static_cast<double>(store.Size())) {
+        CompactStore();
     }
-    data.push_back(item);
-    return true;
+    return static_cast<int>(removed);
 }
 
-int JSONHandlerLib::Delete(const std::string& field, const std::string& value) {
-    if (!data.is_array()) {
-        return 0;
-    }
-
-    int deleted = 0;
-    auto it = std::remove_if(data.begin(), data.end(), [&](const json& item) {
-        if (!item.contains(field)) return false;
-
-        bool shouldDelete = false;
-        if (item[field].is_string()) {
-            shouldDelete = item[field].get<std::string>() == value;
-        } else if (item[field].is_number_integer()) {
-            try {
-                shouldDelete = item[field].get<int>() == std::stoi(value);
-            } catch(...) {}
-        } else if (item[field].is_number_float()) {
-            try {
-                shouldDelete = std::abs(item[field].get<double>() - std::stod(value)) < 0.001;
-            } catch(...) {}
-        }
+std::size_t JSONHandlerLib::CompactStore() {
+    // The append mark moves down past the deleted slots below it
+    std::size_t below = 0;
+    for (std::size_t i = 0; store.Deleted() > 0 && i < appendMark; ++i) {
+        below += !store.Live(i);
+    }
+    appendMark -= below;
+    return store.Compact();
+}
 
-        if (shouldDelete) deleted++;
-        return shouldDelete;
-    });
+std::size_t JSONHandlerLib::Compact() {
+    return CompactStore();
+}
 
-    if (it != data.end()) {
-        data.erase(it, data.end());
+json JSONHandlerLib::Query(const std::string& condition) const {
+    RecordPredicate predicate;
+    std::string error;
+    if (!RecordPredicate::Compile(condition, predicate, error)) {
+        return nullptr;
     }
+    json items = json::array();
+    for (std::size_t i : predicate.Find(store)) {
+        items.push_back(store.RecordToJson(i));
+    }
+    return items;
+}
 
-    return deleted;
+json JSONHandlerLib::QueryAuthors(const std::vector<std::string>& authors) const {
+    json items = json::array();
+    for (std::size_t i : RecordPredicate::Authors(authors).Find(store)) {
+        items.push_back(store.RecordToJson(i));
+    }
+    return items;
 }
 
-json JSONHandlerLib::Generate() {
-    json newItem;
+bool JSONHandlerLib::IndexField(const std::string& field, bool enabled) {
+    std::uint8_t bit = LiteratureStore::FieldBit(field) & LiteratureStore::kIndexableFields;
+    if (bit == 0) {
+        return false;
+    }
+    indexedFields = enabled ? (indexedFields | bit) : (indexedFields & ~bit);
+    store.IndexFields(indexedFields);
+    return true;
+}
 
-    // Sample data for random generation
-    std::vector<std::string> sampleAuthors = {
-        "Leo Tolstoy", "Fyodor Dostoevsky", "Anton Chekhov",
-        "Alexander Pushkin", "Nikolai Gogol", "Ivan Turgenev",
-        "Vladimir Nabokov", "Mikhail Bulgakov"
-    };
-
-    std::vector<std::string> sampleNames = {
-        "War and Peace", "Crime and Punishment", "Anna Karenina",
-        "The Brothers Karamazov", "Dead Souls", "Fathers and Sons",
-        "The Master and Margarita", "Eugene Onegin"
-    };
-
-    std::vector<std::string> samplePublishers = {
-        "Penguin Classics", "Oxford University Press", "Vintage Books",
-        "Modern Library", "Everyman's Library", "Dover Publications"
-    };
-
-    std::random_device rd;
-    std::mt19937 gen(rd());
-
-    // Generate random authors (1-3)
-    std::uniform_int_distribution<> authorCountDist(1, 3);
-    std::uniform_int_distribution<> authorDist(0, sampleAuthors.size() - 1);
-    int authorCount = authorCountDist(gen);
-    std::vector<std::string> authors;
-    for (int i = 0; i < authorCount; ++i) {
-        authors.push_back(sampleAuthors[authorDist(gen)]);
-    }
-    newItem["Author"] = authors;
-
-    // Generate random name
-    std::uniform_int_distribution<> nameDist(0, sampleNames.size() - 1);
-    std::string name = sampleNames[nameDist(gen)];
-    newItem["Name"] = name;
-
-    // Generate random year (1800-2024)
-    std::uniform_int_distribution<> yearDist(1800, 2024);
-    newItem["Year"] = yearDist(gen);
-
-    // Generate random publisher
-    std::uniform_int_distribution<> publisherDist(0, samplePublishers.size() - 1);
-    newItem["Publisher"] = samplePublishers[publisherDist(gen)];
-
-    // Generate random rating (0.0-10.0)
-    std::uniform_real_distribution<> ratingDist(0.0, 10.0);
-    newItem["Rating"] = std::round(ratingDist(gen) * 10.0) / 10.0;
-
-    // Generate ID
-    newItem["ID"] = GenerateID(name);
+json JSONHandlerLib::Generate() {
+    // One generator per thread, seeded once
+    thread_local FastRandom random((static_cast<std::uint64_t>(std::random_device{}()) << 32) ^ std::random_device{}());
+    Literature lit;
+    SampleLiterature(random, lit);
 
+    json newItem;
+    newItem["Author"] = lit.Author;
+    newItem["Name"] = lit.Name;
+    newItem["Year"] = lit.Year;
+    newItem["Publisher"] = lit.Publisher;
+    newItem["Rating"] = lit.Rating;
+    newItem["ID"] = NextID(lit.Name);
     return newItem;
 }
 
 bool JSONHandlerLib::GenerateEx(int count) {
-    for (int i = 0; i < count; ++i) {
-        json item = Generate();
-        AddItem(item);
-    }
+    std::uint64_t seed = (static_cast<std::uint64_t>(std::random_device{}()) << 32) ^ std::random_device{}();
+    GenerateLiterature(count > 0 ? count : 0, seed, ids, store, pool ? *pool : ThreadPool::Shared());
+    return true;
+}
+
+bool JSONHandlerLib::GenerateWorkload(const WorkloadSpec& spec, int count) {
+    ::GenerateWorkload(WorkloadGenerator(spec), count > 0 ? count : 0, ids, store,
+                       pool ? *pool : ThreadPool::Shared());
     return true;
 }
 
 std::string JSONHandlerLib::GenerateID(const std::string& name) {
-    std::stringstream ss;
-    ss << "LIT" << std::setfill('0') << std::setw(3) << idCounter++;
+    return NextID(name);
+}
+
+std::string JSONHandlerLib::NextID(const std::string& name) {
+    // Every ID observed so far lies below the counter; the lookup is a cheap
+    // guard against records that reached the store some other way
+    std::string id;
+    do {
+        id = FormatLiteratureID(ids.Next(), name);
+    } while (store.FindID(id) != IdIndex::kNotFound);
 
-    // Add first 3 letters of name (or less if name is shorter)
-    std::string namePrefix = name.substr(0, std::min(size_t(3), name.length()));
-    std::transform(namePrefix.begin(), namePrefix.end(), namePrefix.begin(), ::toupper);
-    ss << namePrefix;
+    return id;
+}
 
-    return ss.str();
+bool JSONHandlerLib::PersistIDs(const std::string& path) {
+    std::string error;
+    return ids.Persist(path, error);
 }
 
 bool JSONHandlerLib::ValidateID(const std::string& id) const {
-    // Pattern: LIT + 3 digits + 1-3 letters
-    std::regex pattern("^LIT\\d{3}[A-Z]{1,3}$");
-    return std::regex_match(id, pattern);
+    return IsLiteratureID(id);
 }
 
 json JSONHandlerLib::GetByID(const std::string& id) const {
@@ -204,23 +199,72 @@ json JSONHandlerLib::GetByID(const std::string& id) const {
         return json();
     }
 
-    for (const auto& item : data) {
-        if (item.contains("ID") && item["ID"] == id) {
-            return item;
-        }
+    std::size_t position = store.FindID(id);
+    return position == IdIndex::kNotFound ? json() : store.RecordToJson(position);
+}
+
+json JSONHandlerLib::GetByIDs(const std::vector<std::string>& ids) const {
+    json items = json::array();
+    for (const auto& id : ids) {
+        std::size_t position = ValidateID(id) ? store.FindID(id) : IdIndex::kNotFound;
+        items.push_back(position == IdIndex::kNotFound ? json() : store.RecordToJson(position));
     }
+    return items;
+}
 
-    return json();
+std::size_t JSONHandlerLib::ResolveIDs(const std::vector<std::string>& ids, std::vector<std::size_t>& positions) const {
+    std::size_t valid = 0;
+    positions.assign(ids.size(), IdIndex::kNotFound);
+    for (std::size_t k = 0; k < ids.size(); ++k) {
+        if (IsLiteratureID(ids[k])) {
+            ++valid;
+            positions[k] = store.FindID(ids[k]);
+        }
+    }
+    return valid;
 }
 
-bool JSONHandlerLib::SaveToFile(const std::string& filename) const {
-    std::ofstream file(filename);
+bool JSONHandlerLib::SaveToFile(const std::string& filename, DataFormat format, bool append) const {
+    if (format == DataFormat::Auto) {
+        format = FormatFromExtension(filename);
+        if (format == DataFormat::Auto) {
+            format = DataFormat::Json;
+        }
+    }
+    if (append && format != DataFormat::NDJSON) {
+        return false;
+    }
+
+    std::ofstream file(filename, std::ios::binary | (append ? std::ios::app : std::ios::trunc));
     if (!file.is_open()) {
         return false;
     }
 
-    file << std::setw(4) << data << std::endl;
+    if (append) {
+        WriteLiteratureLines(file, store, filename == appendFile ? appendMark : 0);
+    } else {
+        WriteLiterature(file, store, format);
+    }
     file.close();
+    appendFile = filename;
+    appendMark = store.Size();
+    return true;
+}
+
+bool JSONHandlerLib::SaveSnapshot(const std::string& filename) const {
+    std::string error;
+    return LiteratureSnapshot::Save(filename, store, error);
+}
+
+bool JSONHandlerLib::LoadSnapshot(const std::string& filename, bool verify) {
+    std::string error;
+    if (!LiteratureSnapshot::Open(filename, store, error, verify)) {
+        return false;
+    }
+    store.IndexIDs();
+    store.IndexFields(indexedFields);
+    ids.Observe(store);
+    appendFile.clear();
     return true;
 }
 
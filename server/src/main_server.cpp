@@ -1,6 +1,10 @@
 #include "../inc/server.h"
+#include "../../inc/logger.h"
 #include <iostream>
 #include <csignal>
+#include <string>
+#include <vector>
+#include <algorithm>
 
 std::unique_ptr<JSONServer> globalServer;
 
@@ -14,12 +18,69 @@ void SignalHandler(int signal) {
     }
 }
 
+void PrintUsage(const char* program) {
+    std::cerr << "Usage: " << program << " [port] [--wal FILE] [--wal-sync always|interval|never]"
+              << " [--wal-interval MS] [--checkpoint FILE] [--checkpoint-interval SEC]"
+              << " [--threads N] [--index FIELD[,FIELD...]] [--id-state FILE]"
+              << " [--compaction-ratio R] [--log-level debug|info|warning|error|off] [--log-rate N]" << std::endl;
+}
+
 int main(int argc, char* argv[]) {
     int port = 8080;
+    std::string walPath;
+    WalOptions walOptions;
+    CheckpointOptions checkpointOptions;
+    std::size_t threads = 0;
+    std::vector<std::string> indexFields;
+    std::string idStatePath;
+    double compactionRatio = JSONHandler::kDefaultCompactionRatio;
+    Logger& log = Logger::Shared();
+    log.SetDecorate(true);
 
     // Parse command line arguments if provided
-    if (argc > 1) {
-        port = std::stoi(argv[1]);
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--wal" && hasValue) {
+            walPath = argv[++i];
+        } else if (arg == "--wal-sync" && hasValue) {
+            if (!ParseWalSyncPolicy(argv[++i], walOptions.Sync)) {
+                PrintUsage(argv[0]);
+                return 1;
+            }
+        } else if (arg == "--wal-interval" && hasValue) {
+            walOptions.Interval = std::chrono::milliseconds(std::stoi(argv[++i]));
+        } else if (arg == "--checkpoint" && hasValue) {
+            checkpointOptions.Path = argv[++i];
+        } else if (arg == "--checkpoint-interval" && hasValue) {
+            checkpointOptions.Interval = std::chrono::seconds(std::stoi(argv[++i]));
+        } else if (arg == "--threads" && hasValue) {
+            threads = std::stoul(argv[++i]);
+        } else if (arg == "--index" && hasValue) {
+            std::string list = argv[++i];
+            for (std::size_t start = 0, comma; start <= list.size(); start = comma + 1) {
+                comma = std::min(list.find(',', start), list.size());
+                indexFields.push_back(list.substr(start, comma - start));
+            }
+        } else if (arg == "--id-state" && hasValue) {
+            idStatePath = argv[++i];
+        } else if (arg == "--compaction-ratio" && hasValue) {
+            compactionRatio = std::stod(argv[++i]);
+        } else if (arg == "--log-level" && hasValue) {
+            LogLevel level;
+            if (!ParseLogLevel(argv[++i], level)) {
+                PrintUsage(argv[0]);
+                return 1;
+            }
+            log.SetLevel(level);
+        } else if (arg == "--log-rate" && hasValue) {
+            log.SetRateLimit(std::stoul(argv[++i]));
+        } else if (!arg.empty() && arg[0] != '-') {
+            port = std::stoi(arg);
+        } else {
+            PrintUsage(argv[0]);
+            return 1;
+        }
     }
 
     // Set up signal handlers
@@ -28,6 +89,27 @@ int main(int argc, char* argv[]) {
 
     // Create and start server
     globalServer = std::make_unique<JSONServer>(port);
+    globalServer->SetThreads(threads);
+    globalServer->SetCompactionRatio(compactionRatio);
+    for (const auto& field : indexFields) {
+        if (!globalServer->IndexField(field)) {
+            log.Error("Cannot index field ", field);
+            return 1;
+        }
+    }
+    // A durable server keeps its ID mark next to the log unless told otherwise
+    if (idStatePath.empty() && !walPath.empty()) {
+        idStatePath = walPath + ".ids";
+    }
+    if (!idStatePath.empty() && !globalServer->PersistIDs(idStatePath)) {
+        return 1;
+    }
+    if (!checkpointOptions.Path.empty() && !globalServer->EnableCheckpoints(checkpointOptions)) {
+        return 1;
+    }
+    if (!walPath.empty() && !globalServer->EnableWal(walPath, walOptions)) {
+        return 1;
+    }
     globalServer->Start();
 
     return 0;
@@ -1,7 +1,10 @@
 #include "../inc/server.h"
-#include <iostream>
 #include <thread>
 #include <sstream>
+#include <fstream>
+#include <algorithm>
+#include "../../inc/literature_snapshot.h"
+#include "../../inc/logger.h"
 
 JSONServer::JSONServer(int port) : serverPort(port), shouldStop(false) {
     server = std::make_unique<httplib::Server>();
@@ -54,6 +57,19 @@ json JSONServer::CreateResponse(const std::string& command, int result) const {
     return response;
 }
 
+bool JSONServer::IsReadOnly(const std::string& command) {
+    // Not save_snapshot: with tombstones it freezes the live store, which marks its columns shared
+    static const char* const kReadOnly[] = {"print", "execute_view", "get_by_id", "resolve_ids", "query",
+                                            "query_by_author", "index_status", "checkpoint_status"};
+    return std::find(std::begin(kReadOnly), std::end(kReadOnly), command) != std::end(kReadOnly);
+}
+
+bool JSONServer::IsLogged(const std::string& command) {
+    static const char* const kLogged[] = {"input", "load_snapshot", "execute", "add", "delete", "delete_where",
+                                          "delete_by_author", "generate", "generate_ex", "generate_workload"};
+    return std::find(std::begin(kLogged), std::end(kLogged), command) != std::end(kLogged);
+}
+
 json JSONServer::ProcessCommand(const json& request) {
     if (!request.contains("Command")) {
         return CreateResponse("error", 0);
@@ -71,19 +87,75 @@ json JSONServer::ProcessCommand(const json& request) {
     }
 
     int result = 0;
+    json details;              // Extra response fields
+    json logEntry;             // Set by commands that change the dataset
+    std::size_t appendedFrom = kNothingAppended;  // First record to log by value
+    std::uint64_t logSequence = 0;
 
     try {
-        if (command == "input") {
+        // Readers only use const members of the handler and share the lock;
+        // writers wait for them and exclude everyone
+        std::shared_lock<std::shared_mutex> shared(dataMutex, std::defer_lock);
+        std::unique_lock<std::shared_mutex> lock(dataMutex, std::defer_lock);
+        if (IsReadOnly(command)) {
+            shared.lock();
+        } else {
+            lock.lock();
+        }
+
+        if (wal && IsLogged(command) && wal->Failed()) {
+            // Changes made now would be lost on restart and break the replay of later ones
+            Logger::Shared().Error("Error: write-ahead log failed, ", command, " rejected");
+            return CreateResponse(command, 0);
+        } else if (command == "input") {
+            // Optional second parameter names the format, otherwise it is detected
+            DataFormat format = DataFormat::Auto;
+            if (!params.empty() && (params.size() < 2 || ParseDataFormat(params[1], format))) {
+                handler->Input(params[0], format);
+                // The file may change or vanish before a replay, so the records are logged by value
+                logEntry = {{"Op", "clear"}};
+                appendedFrom = 0;
+                result = 1;
+            }
+        } else if (command == "save_snapshot") {
+            if (!params.empty()) {
+                handler->SaveSnapshot(params[0]);
+                result = 1;
+            }
+        } else if (command == "load_snapshot") {
             if (!params.empty()) {
-                handler->Input(params[0]);
+                // Checksums too: the cheap open only checks the header and the offset ends
+                handler->LoadSnapshot(params[0], true);
+                logEntry = {{"Op", "clear"}};
+                appendedFrom = 0;
                 result = 1;
             }
         } else if (command == "print") {
             handler->Print();
             result = 1;
         } else if (command == "execute") {
-            handler->Execute();
+            // Optional parameters: field, lower fraction, upper fraction
+            std::string field = params.size() > 0 ? params[0] : "Rating";
+            double lower = params.size() > 1 ? std::stod(params[1]) : 0.1;
+            double upper = params.size() > 2 ? std::stod(params[2]) : lower;
+            handler->Execute(field, lower, upper);
+            logEntry = {{"Op", "execute"}, {"Field", field}, {"Lower", lower}, {"Upper", upper}};
             result = 1;
+        } else if (command == "execute_view") {
+            // Read-only execute: [field, lower, upper, max items]; the data is not changed
+            std::string field = params.size() > 0 ? params[0] : "Rating";
+            double lower = params.size() > 1 ? std::stod(params[1]) : 0.1;
+            double upper = params.size() > 2 ? std::stod(params[2]) : lower;
+            std::shared_ptr<const BandView> view = handler->ExecuteView(field, lower, upper);
+            if (view) {
+                std::size_t limit = params.size() > 3 ? std::stoul(params[3]) : view->Indices.size();
+                json items = json::array();
+                for (std::size_t i = 0; i < view->Indices.size() && i < limit; ++i) {
+                    items.push_back(handler->GetStore().RecordToJson(view->Indices[i]));
+                }
+                details = {{"Version", view->Version}, {"Count", view->Indices.size()}, {"Items", std::move(items)}};
+                result = 1;
+            }
         } else if (command == "add") {
             // Parse parameters for add
             json newItem;
@@ -119,54 +191,290 @@ json JSONServer::ProcessCommand(const json& request) {
             }
 
             // Add to data
-            json currentData = handler->GetData();
-            if (!currentData.is_array()) {
-                currentData = json::array();
-            }
-            currentData.push_back(newItem);
-            handler->SetData(currentData);
+            handler->AddItem(newItem);
+            logEntry = {{"Op", "append"}, {"Items", json::array({newItem})}};
 
             result = 1;
         } else if (command == "delete") {
             if (params.size() >= 2) {
                 handler->Delete(params[0], params[1]);
+                logEntry = {{"Op", "delete"}, {"Field", params[0]}, {"Value", params[1]}};
+                result = 1;
+            }
+        } else if (command == "delete_where") {
+            // Condition in params[0], e.g. "Year < 1900 AND Rating <= 3"
+            if (!params.empty() && handler->DeleteWhere(params[0])) {
+                logEntry = {{"Op", "delete_where"}, {"Condition", params[0]}};
+                result = 1;
+            }
+        } else if (command == "delete_by_author") {
+            // Records listing every author in params
+            if (!params.empty()) {
+                std::size_t removed = handler->DeleteByAuthors(params);
+                details = {{"Deleted", removed}};
+                logEntry = {{"Op", "delete_by_author"}, {"Authors", params}};
                 result = 1;
             }
+        } else if (command == "compact") {
+            // Not logged: compaction moves records but changes none of them
+            std::size_t reclaimed = handler->Compact();
+            details = {{"Reclaimed", reclaimed}, {"Records", handler->GetStore().Count()}};
+            result = 1;
         } else if (command == "generate") {
+            // Random records are logged by value so that replay reproduces them
+            appendedFrom = handler->GetStore().Size();
             handler->Generate();
             result = 1;
         } else if (command == "generate_ex") {
             if (!params.empty()) {
                 int count = std::stoi(params[0]);
+                appendedFrom = handler->GetStore().Size();
                 handler->Generate_ex(count);
                 result = 1;
             }
+        } else if (command == "generate_workload") {
+            // [count, spec JSON]; the spec (see WorkloadSpec) is optional
+            WorkloadSpec spec;
+            std::string error;
+            json config = params.size() > 1 ? json::parse(params[1], nullptr, false) : json::object();
+            if (!params.empty() && WorkloadSpec::FromJson(config, spec, error)) {
+                appendedFrom = handler->GetStore().Size();
+                handler->GenerateWorkload(spec, std::stoul(params[0]));
+                result = 1;
+            } else if (!error.empty()) {
+                details = {{"Error", error}};
+            }
+        } else if (command == "checkpoint") {
+            // Written on the checkpoint thread; progress shows in checkpoint_status
+            if (checkpointer) {
+                checkpointer->Trigger();
+                result = 1;
+            }
+        } else if (command == "checkpoint_status") {
+            if (checkpointer) {
+                CheckpointStats stats = checkpointer->GetStats();
+                details = {{"Completed", stats.Completed},
+                           {"Failed", stats.Failed},
+                           {"InProgress", stats.InProgress},
+                           {"LastFreezeMs", stats.LastFreezeMs},
+                           {"LastDurationMs", stats.LastDurationMs},
+                           {"LastBytes", stats.LastBytes},
+                           {"LastRecords", stats.LastRecords},
+                           {"LastSequence", stats.LastSequence},
+                           {"LastError", stats.LastError}};
+                result = 1;
+            }
+        } else if (command == "get_by_id") {
+            // Read-only multi-get: one item (or null) per ID in params
+            json items = handler->GetByIDs(params);
+            std::size_t found = std::count_if(items.begin(), items.end(), [](const json& item) { return !item.is_null(); });
+            details = {{"Found", found}, {"Items", std::move(items)}};
+            result = 1;
+        } else if (command == "resolve_ids") {
+            // Read-only batch check: "found", "unknown" or "invalid" per ID in params, no items
+            std::vector<std::size_t> positions;
+            std::size_t valid = handler->ResolveIDs(params, positions);
+            std::size_t found = 0;
+            json status = json::array();
+            for (std::size_t k = 0; k < params.size(); ++k) {
+                bool hit = positions[k] != IdIndex::kNotFound;
+                found += hit;
+                status.push_back(hit ? "found" : handler->ValidateID(params[k]) ? "unknown" : "invalid");
+            }
+            details = {{"Valid", valid}, {"Found", found}, {"Status", std::move(status)}};
+            result = 1;
+        } else if (command == "query") {
+            // Read-only: [condition, max items]; indexed fields are looked up, not scanned
+            std::vector<std::size_t> positions;
+            if (!params.empty() && handler->Query(params[0], positions)) {
+                std::size_t limit = params.size() > 1 ? std::stoul(params[1]) : positions.size();
+                json items = json::array();
+                for (std::size_t i = 0; i < positions.size() && i < limit; ++i) {
+                    items.push_back(handler->GetStore().RecordToJson(positions[i]));
+                }
+                details = {{"Count", positions.size()}, {"Items", std::move(items)}};
+                result = 1;
+            }
+        } else if (command == "query_by_author") {
+            // Read-only: records listing every author in params, from the author index when kept
+            if (!params.empty()) {
+                json items = json::array();
+                for (std::size_t i : handler->QueryAuthors(params)) {
+                    items.push_back(handler->GetStore().RecordToJson(i));
+                }
+                details = {{"Count", items.size()}, {"Items", std::move(items)}};
+                result = 1;
+            }
+        } else if (command == "index" || command == "index_status") {
+            // index: [field, "on"|"off"]; not logged, indexes are rebuilt from --index on restart
+            if (command == "index_status" ||
+                (!params.empty() && handler->IndexField(params[0], params.size() < 2 || params[1] != "off"))) {
+                const LiteratureStore& store = handler->GetStore();
+                json fields = json::array();
+                for (const char* name : {"Author", "Name", "Publisher", "Year", "Rating"}) {
+                    if (store.IndexedFields() & LiteratureStore::FieldBit(name)) {
+                        fields.push_back(name);
+                    }
+                }
+                details = {{"Indexed", std::move(fields)}, {"IndexBytes", store.IndexMemoryUsage()}};
+                result = 1;
+            }
         } else if (command == "stop") {
             shouldStop = true;
             result = 1;
         }
 
-        std::cout << "Processed command: " << command << " (Result: " << result << ")" << std::endl;
+        // Logged in apply order while the lock is held; the wait for the sync
+        // happens outside it so that concurrent commits share one fsync
+        bool logged = true;
+        if (wal && !logEntry.is_null()) {
+            logSequence = wal->Append(logEntry);
+            logged = logSequence != 0;
+        }
+        if (wal && appendedFrom != kNothingAppended) {
+            logged = logged && LogRecords(appendedFrom, logSequence);
+        }
+        if (lock.owns_lock()) {
+            lock.unlock();
+        } else {
+            shared.unlock();
+        }
+        if (!logged) {
+            // The log has failed: later logged commands are rejected
+            Logger::Shared().Error("Error: change too large for the write-ahead log");
+            result = 0;
+        } else if (logSequence != 0 && !wal->WaitDurable(logSequence)) {
+            Logger::Shared().Error("Error: write-ahead log write failed");
+            result = 0;
+        }
+
+        Logger::Shared().Info("Processed command: ", command, " (Result: ", result, ")");
 
     } catch (const std::exception& e) {
-        std::cerr << "Error processing command: " << e.what() << std::endl;
+        Logger::Shared().Error("Error processing command: ", e.what());
         result = 0;
     }
 
-    return CreateResponse(command, result);
+    json response = CreateResponse(command, result);
+    if (details.is_object()) {
+        response.update(details);
+    }
+    return response;
+}
+
+bool JSONServer::LogRecords(std::size_t first, std::uint64_t& sequence) {
+    // One append entry per batch, so no entry (and no DOM) grows with the count
+    const LiteratureStore& store = handler->GetStore();
+    json items = json::array();
+    for (std::size_t i = first; i < store.Size(); ++i) {
+        if (store.Live(i)) {
+            items.push_back(store.RecordToJson(i));
+        }
+        if (items.size() == kLogBatchRecords || (i + 1 == store.Size() && !items.empty())) {
+            sequence = wal->Append({{"Op", "append"}, {"Items", std::move(items)}});
+            if (sequence == 0) {
+                return false;
+            }
+            items = json::array();
+        }
+    }
+    return true;
+}
+
+void JSONServer::ApplyLogEntry(const json& entry) {
+    const std::string op = entry.value("Op", "");
+    if (op == "append") {
+        for (const auto& item : entry.at("Items")) {
+            handler->AddItem(item);
+        }
+    } else if (op == "delete") {
+        handler->Delete(entry.at("Field").get<std::string>(), entry.at("Value").get<std::string>());
+    } else if (op == "delete_where") {
+        handler->DeleteWhere(entry.at("Condition").get<std::string>());
+    } else if (op == "delete_by_author") {
+        handler->DeleteByAuthors(entry.at("Authors").get<std::vector<std::string>>());
+    } else if (op == "execute") {
+        handler->Execute(entry.value("Field", "Rating"), entry.value("Lower", 0.1), entry.value("Upper", 0.1));
+    } else if (op == "clear") {
+        handler->Clear();
+    } else if (op == "input") {
+        // Logs written before input and load_snapshot were logged by value
+        DataFormat format = DataFormat::Auto;
+        ParseDataFormat(entry.value("Format", "auto"), format);
+        handler->Input(entry.at("File").get<std::string>(), format);
+    } else if (op == "load_snapshot") {
+        handler->LoadSnapshot(entry.at("File").get<std::string>(), true);
+    }
+}
+
+bool JSONServer::EnableWal(const std::string& path, const WalOptions& options) {
+    std::lock_guard<std::shared_mutex> lock(dataMutex);
+    auto log = std::make_unique<WriteAheadLog>(options);
+    std::string error;
+    bool ok = log->Open(path, [this](const json& entry) {
+        try {
+            ApplyLogEntry(entry);
+        } catch (const std::exception& e) {
+            Logger::Shared().Warning("Skipped log entry: ", e.what());
+        }
+    }, error, checkpointSequence);
+    if (!ok) {
+        Logger::Shared().Error("Error: ", error);
+        return false;
+    }
+
+    Logger::Shared().Info("Replayed ", log->Replayed(), " log entries from ", path, ", ",
+                          handler->GetStore().Count(), " items");
+    wal = std::move(log);
+    return true;
+}
+
+bool JSONServer::EnableCheckpoints(const CheckpointOptions& options) {
+    std::lock_guard<std::shared_mutex> lock(dataMutex);
+    std::ifstream existing(options.Path, std::ios::binary);
+    if (existing.is_open()) {
+        existing.close();
+        LiteratureStore store;
+        std::string error;
+        if (!LiteratureSnapshot::Open(options.Path, store, error, true, &checkpointSequence)) {
+            Logger::Shared().Error("Error: ", options.Path, ": ", error);
+            return false;
+        }
+        handler->SetStore(std::move(store));
+        Logger::Shared().Info("Loaded checkpoint ", options.Path, ", ", handler->GetStore().Count(),
+                              " items up to log entry ", checkpointSequence);
+    }
+
+    checkpointer = std::make_unique<Checkpointer>(
+        options,
+        [this]() {
+            // Only the freeze and the log position need the lock
+            std::lock_guard<std::shared_mutex> guard(dataMutex);
+            return Checkpointer::Version{handler->GetStore().Freeze(), wal ? wal->LastSequence() : 0};
+        },
+        [this](std::uint64_t sequence) {
+            std::string error;
+            if (wal && !wal->TrimThrough(sequence, error)) {
+                Logger::Shared().Error("Error: ", error);
+            }
+        });
+    return true;
 }
 
 void JSONServer::Start() {
     SetupRoutes();
+    if (checkpointer) {
+        checkpointer->Start();
+    }
 
-    std::cout << "JSON Server starting on port " << serverPort << "..." << std::endl;
+    Logger::Shared().Info("JSON Server starting on port ", serverPort, "...");
 
     // Start server in a separate thread
     std::thread serverThread([this]() {
         server->listen("0.0.0.0", serverPort);
     });
 
-    std::cout << "Server is running. Press Ctrl+C to stop..." << std::endl;
+    Logger::Shared().Info("Server is running. Press Ctrl+C to stop...");
 
     // Monitor for stop signal
     while (!shouldStop.load()) {
@@ -181,8 +489,11 @@ void JSONServer::Start() {
 }
 
 void JSONServer::Stop() {
+    if (checkpointer) {
+        checkpointer->Stop();
+    }
     if (server) {
-        std::cout << "Stopping server..." << std::endl;
+        Logger::Shared().Info("Stopping server...");
         server->stop();
     }
 }
\ No newline at end of file
@@ -0,0 +1,113 @@
+#include "../inc/checkpointer.h"
+#include "../inc/literature_snapshot.h"
+#include <fstream>
+#include <utility>
+
+Checkpointer::Checkpointer(CheckpointOptions checkpointOptions, FreezeFunction freezeFunction,
+                           CompleteFunction completeFunction)
+    : options(std::move(checkpointOptions)),
+      freeze(std::move(freezeFunction)),
+      complete(std::move(completeFunction)) {}
+
+Checkpointer::~Checkpointer() {
+    Stop();
+}
+
+void Checkpointer::Start() {
+    if (worker.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        stopping = false;
+    }
+    worker = std::thread([this]() { Loop(); });
+}
+
+void Checkpointer::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        stopping = true;
+    }
+    wake.notify_one();
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+void Checkpointer::Trigger() {
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        triggered = true;
+    }
+    wake.notify_one();
+}
+
+bool Checkpointer::RunNow() {
+    std::lock_guard<std::mutex> run(runMutex);
+    using Clock = std::chrono::steady_clock;
+
+    auto freezeStart = Clock::now();
+    Version version = freeze();
+    auto writeStart = Clock::now();
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        stats.InProgress = true;
+        stats.LastFreezeMs = std::chrono::duration<double, std::milli>(writeStart - freezeStart).count();
+    }
+
+    std::string error;
+    bool ok = LiteratureSnapshot::Save(options.Path, version.Store, error, version.Sequence);
+    double durationMs = std::chrono::duration<double, std::milli>(Clock::now() - writeStart).count();
+    std::uint64_t records = version.Store.Count();
+    std::uint64_t sequence = version.Sequence;
+    version = Version();  // Release the frozen columns before trimming
+
+    if (ok && complete) {
+        complete(sequence);
+    }
+
+    std::uint64_t bytes = 0;
+    if (ok) {
+        std::ifstream file(options.Path, std::ios::binary | std::ios::ate);
+        bytes = file.is_open() ? static_cast<std::uint64_t>(file.tellg()) : 0;
+    }
+
+    std::lock_guard<std::mutex> lock(stateMutex);
+    stats.InProgress = false;
+    if (ok) {
+        ++stats.Completed;
+        stats.LastDurationMs = durationMs;
+        stats.LastBytes = bytes;
+        stats.LastRecords = records;
+        stats.LastSequence = sequence;
+    } else {
+        ++stats.Failed;
+        stats.LastError = error;
+    }
+    return ok;
+}
+
+CheckpointStats Checkpointer::GetStats() const {
+    std::lock_guard<std::mutex> lock(stateMutex);
+    return stats;
+}
+
+void Checkpointer::Loop() {
+    std::unique_lock<std::mutex> lock(stateMutex);
+    while (!stopping) {
+        auto ready = [this]() { return stopping || triggered; };
+        if (options.Interval.count() > 0) {
+            wake.wait_for(lock, options.Interval, ready);
+        } else {
+            wake.wait(lock, ready);
+        }
+        if (stopping) {
+            break;
+        }
+        triggered = false;
+        lock.unlock();
+        RunNow();
+        lock.lock();
+    }
+}
@@ -0,0 +1,125 @@
+#include "../inc/field_index.h"
+#include <algorithm>
+
+void TextIndex::Add(std::size_t record, std::string_view value) {
+    if (record <= kMaxPostingRecord) {
+        postings[std::string(value)].push_back(static_cast<std::uint32_t>(record));
+    }
+}
+
+void TextIndex::RemoveLast(std::size_t record, std::string_view value) {
+    if (record > kMaxPostingRecord) {
+        return;
+    }
+    auto found = postings.find(std::string(value));
+    if (found == postings.end()) {
+        return;
+    }
+    found->second.pop_back();
+    if (found->second.empty()) {
+        postings.erase(found);
+    }
+}
+
+const std::vector<std::uint32_t>* TextIndex::Find(std::string_view value) const {
+    auto found = postings.find(std::string(value));
+    return found == postings.end() ? nullptr : &found->second;
+}
+
+std::size_t TextIndex::MemoryUsage() const {
+    if (postings.empty()) {
+        return 0;  // An empty table may still hold a one-slot bucket array
+    }
+    // Bucket array plus one node (next pointer, cached hash, key, list) per value
+    std::size_t bytes = postings.bucket_count() * sizeof(void*);
+    for (const auto& entry : postings) {
+        bytes += 2 * sizeof(void*) + sizeof(entry);
+        if (entry.first.capacity() > std::string().capacity()) {
+            bytes += entry.first.capacity() + 1;
+        }
+        bytes += entry.second.capacity() * sizeof(std::uint32_t);
+    }
+    return bytes;
+}
+
+void AuthorIndex::Add(std::size_t record, std::string_view author) {
+    if (record > kMaxPostingRecord) {
+        return;
+    }
+    auto term = terms.emplace(std::string(author), static_cast<std::uint32_t>(postings.size()));
+    if (term.second) {
+        postings.emplace_back();
+    }
+    std::vector<std::uint32_t>& list = postings[term.first->second];
+    if (list.empty() || list.back() != record) {
+        list.push_back(static_cast<std::uint32_t>(record));
+    }
+}
+
+void AuthorIndex::RemoveLast(std::size_t record, std::string_view author) {
+    // The name stays interned, with an empty list if no other record lists it
+    auto term = terms.find(std::string(author));
+    if (record <= kMaxPostingRecord && term != terms.end() && !postings[term->second].empty() &&
+        postings[term->second].back() == record) {
+        postings[term->second].pop_back();
+    }
+}
+
+const std::vector<std::uint32_t>* AuthorIndex::Find(std::string_view author) const {
+    auto term = terms.find(std::string(author));
+    return term == terms.end() || postings[term->second].empty() ? nullptr : &postings[term->second];
+}
+
+void AuthorIndex::FindAll(const std::vector<std::string>& authors, std::vector<std::size_t>& positions) const {
+    positions.clear();
+    std::vector<const std::vector<std::uint32_t>*> lists;
+    for (const auto& author : authors) {
+        const std::vector<std::uint32_t>* list = Find(author);
+        if (list == nullptr) {
+            return;  // An author nobody lists empties the intersection
+        }
+        lists.push_back(list);
+    }
+    if (lists.empty()) {
+        return;
+    }
+    std::sort(lists.begin(), lists.end(), [](const std::vector<std::uint32_t>* a, const std::vector<std::uint32_t>* b) {
+        return a->size() < b->size();
+    });
+
+    // Each candidate of the shortest list is searched for in the longer ones;
+    // the search resumes where the previous candidate was found
+    std::vector<const std::uint32_t*> cursors;
+    for (const auto* list : lists) {
+        cursors.push_back(list->data());
+    }
+    for (std::uint32_t record : *lists[0]) {
+        bool everywhere = true;
+        for (std::size_t k = 1; k < lists.size() && everywhere; ++k) {
+            const std::uint32_t* end = lists[k]->data() + lists[k]->size();
+            cursors[k] = std::lower_bound(cursors[k], end, record);
+            everywhere = cursors[k] != end && *cursors[k] == record;
+        }
+        if (everywhere) {
+            positions.push_back(record);
+        }
+    }
+}
+
+std::size_t AuthorIndex::MemoryUsage() const {
+    if (terms.empty()) {
+        return 0;
+    }
+    // Bucket array, one node per name (next pointer, cached hash, key, number) and the lists
+    std::size_t bytes = terms.bucket_count() * sizeof(void*) + postings.capacity() * sizeof(postings[0]);
+    for (const auto& term : terms) {
+        bytes += 2 * sizeof(void*) + sizeof(term);
+        if (term.first.capacity() > std::string().capacity()) {
+            bytes += term.first.capacity() + 1;
+        }
+    }
+    for (const auto& list : postings) {
+        bytes += list.capacity() * sizeof(std::uint32_t);
+    }
+    return bytes;
+}
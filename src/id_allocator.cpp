@@ -0,0 +1,99 @@
+#include "../inc/id_allocator.h"
+#include "../inc/file_sync.h"
+#include "../inc/literature_id.h"
+#include <algorithm>
+#include <fstream>
+
+bool IdAllocator::Persist(const std::string& path, std::string& error) {
+    std::lock_guard<std::mutex> lock(persistMutex);
+    std::ifstream existing(path);
+    if (existing.is_open()) {
+        std::uint64_t mark = 0;
+        if (!(existing >> mark) || mark > kMaxIdNumber) {
+            error = "No ID high-water mark in " + path;
+            return false;
+        }
+        if (mark > 0) {
+            Observe(mark - 1);
+        }
+    }
+    statePath = path;
+    // The next allocation writes a mark covering everything handed out so far
+    limit.store(next.load(std::memory_order_relaxed), std::memory_order_release);
+    return true;
+}
+
+std::uint64_t IdAllocator::Next() {
+    std::uint64_t number = next.fetch_add(1, std::memory_order_relaxed);
+    if (number >= limit.load(std::memory_order_acquire)) {
+        Reserve(number + 1);
+    }
+    return number;
+}
+
+IdAllocator::Block IdAllocator::Lease(std::uint64_t count) {
+    Block block;
+    block.Next = next.fetch_add(count, std::memory_order_relaxed);
+    block.End = block.Next + count;
+    if (count > 0 && block.End > limit.load(std::memory_order_acquire)) {
+        Reserve(block.End);
+    }
+    return block;
+}
+
+void IdAllocator::Observe(std::uint64_t number) {
+    if (number >= kMaxIdNumber) {
+        return;
+    }
+    std::uint64_t current = next.load(std::memory_order_relaxed);
+    while (current <= number && !next.compare_exchange_weak(current, number + 1, std::memory_order_relaxed)) {
+    }
+}
+
+void IdAllocator::Observe(std::string_view id) {
+    std::uint64_t number = 0;
+    if (ParseLiteratureID(id, number)) {
+        Observe(number);
+    }
+}
+
+void IdAllocator::Observe(const LiteratureStore& store) {
+    std::uint64_t highest = 0;
+    bool any = false;
+    for (std::size_t i = 0; i < store.Size(); ++i) {
+        std::uint64_t number = 0;
+        if ((store.Mask(i) & LiteratureStore::kID) && ParseLiteratureID(store.ID(i), number)) {
+            highest = std::max(highest, number);
+            any = true;
+        }
+    }
+    if (any) {
+        Observe(highest);
+    }
+}
+
+std::string IdAllocator::LastError() const {
+    std::lock_guard<std::mutex> lock(persistMutex);
+    return lastError;
+}
+
+void IdAllocator::Reserve(std::uint64_t end) {
+    std::lock_guard<std::mutex> lock(persistMutex);
+    if (statePath.empty() || limit.load(std::memory_order_relaxed) >= end) {
+        return;  // Another thread wrote a mark covering this allocation
+    }
+
+    std::uint64_t mark = std::max(end, next.load(std::memory_order_relaxed)) + kReserveStep;
+    const std::string temporary = statePath + ".tmp";
+    bool written = false;
+    {
+        std::ofstream out(temporary, std::ios::trunc);
+        out << mark << '\n';
+        out.close();
+        written = static_cast<bool>(out);
+    }
+    if (!written || !DurableReplace(temporary, statePath)) {
+        lastError = "Cannot write ID high-water mark to " + statePath;
+    }
+    limit.store(mark, std::memory_order_release);
+}
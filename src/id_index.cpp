@@ -0,0 +1,101 @@
+#include "../inc/id_index.h"
+#include "../inc/checksum.h"
+
+std::uint32_t IdIndex::Hash(std::string_view id) {
+    // Checksum64 mixes upward only; a final avalanche spreads it to the bits the slot uses
+    std::uint64_t hash = Checksum64(id.data(), id.size());
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    return static_cast<std::uint32_t>(hash >> 32);
+}
+
+void IdIndex::Clear() {
+    slots.clear();
+    mask = 0;
+    count = 0;
+    unhashedEnd = 0;
+}
+
+void IdIndex::Reserve(std::size_t records) {
+    std::size_t capacity = 16;
+    while (capacity < 2 * records) {
+        capacity *= 2;
+    }
+    if (capacity > slots.size()) {
+        Rehash(capacity);
+    }
+}
+
+void IdIndex::Add(std::size_t record, std::string_view id) {
+    if (record > kMaxRecord) {
+        unhashedEnd = record + 1;
+        return;
+    }
+    if (2 * (count + 1) > slots.size()) {
+        Rehash(slots.empty() ? 16 : 2 * slots.size());
+    }
+    Place({Hash(id), static_cast<std::uint32_t>(record + 1)});
+    ++count;
+}
+
+void IdIndex::RemoveLast(std::size_t record, std::string_view id) {
+    if (record > kMaxRecord) {
+        // Unhashed positions without an ID are scanned as well; they never match
+        unhashedEnd = record > kMaxRecord + 1 ? record : 0;
+        return;
+    }
+    if (slots.empty()) {
+        return;
+    }
+    const std::uint32_t position = static_cast<std::uint32_t>(record + 1);
+    std::size_t i = Hash(id) & mask;
+    while (slots[i].Position != position) {
+        if (slots[i].Position == 0) {
+            return;
+        }
+        i = (i + 1) & mask;
+    }
+
+    // Backward-shift deletion: pull later chain members into the hole so
+    // that no lookup stops early and equal IDs keep their order
+    std::size_t hole = i;
+    for (std::size_t next = (hole + 1) & mask; slots[next].Position != 0; next = (next + 1) & mask) {
+        std::size_t home = slots[next].Hash & mask;
+        // Movable unless its home lies cyclically in (hole, next]
+        bool stays = hole <= next ? (home > hole && home <= next) : (home > hole || home <= next);
+        if (!stays) {
+            slots[hole] = slots[next];
+            hole = next;
+        }
+    }
+    slots[hole] = Slot{0, 0};
+    --count;
+}
+
+void IdIndex::Rehash(std::size_t capacity) {
+    std::vector<Slot> old(capacity, Slot{0, 0});
+    old.swap(slots);
+    mask = capacity - 1;
+
+    // Walking the old table cyclically from an empty slot visits every probe
+    // chain from its start, so equal IDs are reinserted in their order
+    std::size_t start = 0;
+    while (start < old.size() && old[start].Position != 0) {
+        ++start;
+    }
+    for (std::size_t k = 1; k <= old.size(); ++k) {
+        const Slot& slot = old[(start + k) % old.size()];
+        if (slot.Position != 0) {
+            Place(slot);
+        }
+    }
+}
+
+void IdIndex::Place(Slot slot) {
+    std::size_t i = slot.Hash & mask;
+    while (slots[i].Position != 0) {
+        i = (i + 1) & mask;
+    }
+    slots[i] = slot;
+}
@@ -0,0 +1,127 @@
+#include "../inc/literature_format.h"
+#include <algorithm>
+#include <cctype>
+
+namespace {
+
+std::string ToLower(std::string text) {
+    std::transform(text.begin(), text.end(), text.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return text;
+}
+
+bool IsJsonSpace(char c) {
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+// Offset of the first element after a CBOR array header, 0 if unknown
+std::size_t CborElementOffset(unsigned char marker) {
+    switch (marker) {
+        case 0x98: return 2;
+        case 0x99: return 3;
+        case 0x9a: return 5;
+        case 0x9b: return 9;
+        default: return 1;
+    }
+}
+
+} // namespace
+
+DataFormat FormatFromExtension(const std::string& filename) {
+    size_t dot = filename.find_last_of('.');
+    size_t slash = filename.find_last_of("/\\");
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) {
+        return DataFormat::Auto;
+    }
+
+    DataFormat format = DataFormat::Auto;
+    ParseDataFormat(filename.substr(dot + 1), format);
+    return format;
+}
+
+DataFormat DetectDataFormat(const std::string& filename, std::string_view head) {
+    DataFormat format = FormatFromExtension(filename);
+    if (format != DataFormat::Auto) {
+        return format;
+    }
+    if (head.empty()) {
+        return DataFormat::Json;
+    }
+
+    auto byte = [&head](std::size_t i) {
+        return i < head.size() ? static_cast<unsigned char>(head[i]) : 0u;
+    };
+    unsigned char first = byte(0);
+
+    // Binary array headers
+    if (first == 0xdc || first == 0xdd) {
+        return DataFormat::MessagePack;
+    }
+    if (first >= 0x80 && first <= 0x9f) {
+        // 0x90-0x9f is a MessagePack fixarray but also a CBOR array header;
+        // the first element (a record map) settles it
+        if (first >= 0x90) {
+            unsigned char element = byte(1);
+            bool msgpackMap = (element >= 0x80 && element <= 0x8f) || element == 0xde || element == 0xdf;
+            if (first == 0x90 || msgpackMap) {
+                return DataFormat::MessagePack;
+            }
+        }
+        unsigned char element = byte(CborElementOffset(first));
+        if (first == 0x80 || (element >= 0xa0 && element <= 0xbb) || element == 0xbf) {
+            return DataFormat::Cbor;
+        }
+        return DataFormat::MessagePack;
+    }
+
+    // Text formats
+    std::size_t i = 0;
+    while (i < head.size() && IsJsonSpace(head[i])) ++i;
+    if (i < head.size() && head[i] == '[') {
+        char next = i + 1 < head.size() ? head[i + 1] : '\0';
+        return next == '#' || next == '$' ? DataFormat::Ubjson : DataFormat::Json;
+    }
+    if (i < head.size() && head[i] == '{') {
+        std::size_t newline = head.find('\n', i);
+        if (newline != std::string_view::npos) {
+            std::size_t j = newline + 1;
+            while (j < head.size() && IsJsonSpace(head[j])) ++j;
+            if (j < head.size() && head[j] == '{') {
+                return DataFormat::NDJSON;
+            }
+        }
+    }
+    return DataFormat::Json;
+}
+
+bool ParseDataFormat(const std::string& name, DataFormat& format) {
+    std::string lower = ToLower(name);
+    if (lower == "auto") {
+        format = DataFormat::Auto;
+    } else if (lower == "json") {
+        format = DataFormat::Json;
+    } else if (lower == "ndjson" || lower == "jsonl") {
+        format = DataFormat::NDJSON;
+    } else if (lower == "cbor") {
+        format = DataFormat::Cbor;
+    } else if (lower == "msgpack" || lower == "messagepack" || lower == "mpk") {
+        format = DataFormat::MessagePack;
+    } else if (lower == "ubjson" || lower == "ubj") {
+        format = DataFormat::Ubjson;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+const char* DataFormatName(DataFormat format) {
+    switch (format) {
+        case DataFormat::Auto: return "auto";
+        case DataFormat::Json: return "json";
+        case DataFormat::NDJSON: return "ndjson";
+        case DataFormat::Cbor: return "cbor";
+        case DataFormat::MessagePack: return "msgpack";
+        case DataFormat::Ubjson: return "ubjson";
+    }
+    return "json";
+}
@@ -0,0 +1,240 @@
+#include "../inc/literature_generator.h"
+#include "../inc/literature_id.h"
+#include "../inc/literature_writer.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <deque>
+#include <exception>
+#include <future>
+#include <sstream>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+const std::string_view kSampleAuthors[] = {
+    "Leo Tolstoy", "Fyodor Dostoevsky", "Anton Chekhov",
+    "Alexander Pushkin", "Nikolai Gogol", "Ivan Turgenev",
+    "Vladimir Nabokov", "Mikhail Bulgakov"
+};
+
+const std::string_view kSampleNames[] = {
+    "War and Peace", "Crime and Punishment", "Anna Karenina",
+    "The Brothers Karamazov", "Dead Souls", "Fathers and Sons",
+    "The Master and Margarita", "Eugene Onegin"
+};
+
+const std::string_view kSamplePublishers[] = {
+    "Penguin Classics", "Oxford University Press", "Vintage Books",
+    "Modern Library", "Everyman's Library", "Dover Publications"
+};
+
+template <typename T, std::size_t N>
+const T& Pick(FastRandom& random, const T (&table)[N]) {
+    return table[random.Below(N)];
+}
+
+std::uint64_t SplitMix64(std::uint64_t& x) {
+    std::uint64_t z = (x += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+std::uint64_t Rotate(std::uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+}
+
+// Fills records [first, first + count) of a batch from the chunk's own generator and block of numbers
+void GenerateChunk(const LiteratureFiller& fill, std::size_t first, std::size_t count, std::uint64_t seed,
+                   IdAllocator::Block block, LiteratureStore& out) {
+    FastRandom random(seed);
+    Literature lit;
+    char id[kMaxIdLength];
+    for (std::size_t i = 0; i < count; ++i) {
+        fill(first + i, random, lit);
+        out.Append(lit, std::string_view(id, FormatLiteratureID(block.Take(), lit.Name, id)));
+    }
+}
+
+// Appends a chunk; records whose ID the target already holds are renumbered from ids
+void AppendChunk(const LiteratureStore& chunk, IdAllocator& ids, LiteratureStore& store) {
+    bool clash = false;
+    for (std::size_t i = 0; store.IDsIndexed() && i < chunk.Size() && !clash; ++i) {
+        clash = store.FindID(chunk.ID(i)) != IdIndex::kNotFound;
+    }
+    if (!clash) {
+        store.AppendAll(chunk);
+        return;
+    }
+    for (std::size_t i = 0; i < chunk.Size(); ++i) {
+        Literature lit = chunk.Get(i);
+        std::string id(chunk.ID(i));
+        while (store.FindID(id) != IdIndex::kNotFound) {
+            id = FormatLiteratureID(ids.Next(), lit.Name);
+        }
+        store.Append(lit, id);
+    }
+}
+
+} // namespace
+
+FastRandom::FastRandom(std::uint64_t seed) {
+    for (std::uint64_t& word : state) {
+        word = SplitMix64(seed);
+    }
+}
+
+FastRandom::FastRandom(std::uint64_t seed, std::uint64_t stream) : FastRandom(seed ^ SplitMix64(stream)) {}
+
+std::uint64_t FastRandom::Next() {
+    const std::uint64_t result = Rotate(state[1] * 5, 7) * 9;
+    const std::uint64_t t = state[1] << 17;
+    state[2] ^= state[0];
+    state[3] ^= state[1];
+    state[1] ^= state[2];
+    state[0] ^= state[3];
+    state[2] ^= t;
+    state[3] = Rotate(state[3], 45);
+    return result;
+}
+
+void SampleLiterature(FastRandom& random, Literature& lit) {
+    lit.Author.resize(1 + random.Below(3));
+    for (std::string& author : lit.Author) {
+        author = Pick(random, kSampleAuthors);
+    }
+    lit.Name = Pick(random, kSampleNames);
+    lit.Year = 1800 + static_cast<int>(random.Below(225));
+    lit.Publisher = Pick(random, kSamplePublishers);
+    lit.Rating = std::round(random.Unit() * 100.0) / 10.0;
+}
+
+void GenerateLiterature(std::size_t count, std::uint64_t seed, const LiteratureFiller& fill, IdAllocator& ids,
+                        LiteratureStore& store, ThreadPool& pool) {
+    // Fixed chunks: the records depend on the seed, not on the number of threads
+    const std::size_t chunkRecords = 1 << 14;
+
+    // One lease for the batch keeps the IDs in position order
+    IdAllocator::Block batch = ids.Lease(count);
+    std::vector<std::future<LiteratureStore>> pending;
+    for (std::size_t first = 0, k = 0; first < count; first += chunkRecords, ++k) {
+        std::size_t records = std::min(chunkRecords, count - first);
+        IdAllocator::Block block{batch.Next + first, batch.Next + first + records};
+        pending.push_back(pool.Submit([&fill, first, records, seed, k, block]() {
+            LiteratureStore chunk;
+            // Indexed once when appended to the target store
+            chunk.IndexRatings(false);
+            chunk.IndexIDs(false);
+            chunk.Reserve(records);
+            GenerateChunk(fill, first, records, seed + k, block, chunk);
+            return chunk;
+        }));
+    }
+
+    // Workers never touch the target, so each chunk is appended as soon as
+    // it is done and only unmerged chunks are held. After a failure the
+    // remaining chunks are still waited for: they use fill
+    store.Reserve(store.Size() + count);
+    std::exception_ptr failure;
+    for (auto& result : pending) {
+        try {
+            LiteratureStore chunk = result.get();
+            if (!failure) AppendChunk(chunk, ids, store);
+        } catch (...) {
+            if (!failure) failure = std::current_exception();
+        }
+    }
+    if (failure) {
+        std::rethrow_exception(failure);
+    }
+}
+
+void GenerateLiterature(std::size_t count, std::uint64_t seed, IdAllocator& ids, LiteratureStore& store,
+                        ThreadPool& pool) {
+    GenerateLiterature(count, seed, [](std::size_t, FastRandom& random, Literature& lit) {
+        SampleLiterature(random, lit);
+    }, ids, store, pool);
+}
+
+StreamStats StreamLiterature(std::ostream& out, DataFormat format, std::uint64_t count, std::uint64_t seed,
+                             const LiteratureFiller& fill, const StreamOptions& options, ThreadPool& pool) {
+    const auto start = std::chrono::steady_clock::now();
+    const std::size_t chunkRecords = std::max<std::size_t>(options.ChunkRecords, 1);
+    const std::size_t depth = options.Depth > 0 ? options.Depth : std::max<std::size_t>(2 * pool.Size(), 2);
+    StreamStats stats;
+
+    // Generation stage: one chunk, encoded on the worker
+    std::uint64_t submitted = 0, chunks = 0;
+    auto submit = [&]() {
+        std::size_t records = static_cast<std::size_t>(std::min<std::uint64_t>(chunkRecords, count - submitted));
+        IdAllocator::Block block{options.FirstNumber + submitted, options.FirstNumber + submitted + records};
+        std::uint64_t first = submitted, k = chunks++;
+        submitted += records;
+        return pool.Submit([&fill, format, first, records, seed, k, block]() {
+            LiteratureStore chunk;
+            chunk.IndexRatings(false);
+            chunk.IndexIDs(false);
+            chunk.Reserve(records);
+            GenerateChunk(fill, static_cast<std::size_t>(first), records, seed + k, block, chunk);
+            std::ostringstream encoded;
+            WriteLiteratureRecords(encoded, chunk, format, first == 0);
+            return encoded.str();
+        });
+    };
+
+    auto countingWrite = [&](const std::string& bytes) {
+        out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+        if (out) {
+            stats.Bytes += bytes.size();
+        }
+        return static_cast<bool>(out);
+    };
+    std::ostringstream header;
+    WriteLiteratureHeader(header, count, format);
+    countingWrite(header.str());
+
+    // Write stage: the oldest chunk is written while the next ones are generated
+    std::deque<std::future<std::string>> pending;
+    std::exception_ptr failure;
+    while (submitted < count && pending.size() < depth) {
+        pending.push_back(submit());
+    }
+    while (!pending.empty()) {
+        std::size_t ready = 0;
+        for (const auto& result : pending) {
+            ready += result.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+        }
+        stats.PeakChunks = std::max(stats.PeakChunks, ready);
+        try {
+            std::string bytes = pending.front().get();
+            if (!failure && out && countingWrite(bytes)) {
+                stats.Records = std::min<std::uint64_t>(stats.Records + chunkRecords, count);
+            }
+        } catch (...) {
+            if (!failure) failure = std::current_exception();
+        }
+        pending.pop_front();
+        // After a failure the chunks in flight are still waited for: they use fill
+        if (!failure && out && submitted < count) {
+            pending.push_back(submit());
+        }
+        stats.Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (!failure && options.Progress) {
+            options.Progress(stats);
+        }
+    }
+    if (failure) {
+        std::rethrow_exception(failure);
+    }
+
+    if (out && stats.Records == count) {
+        std::ostringstream footer;
+        WriteLiteratureFooter(footer, count, format);
+        countingWrite(footer.str());
+        out.flush();
+    }
+    stats.Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return stats;
+}
@@ -0,0 +1,529 @@
+#include "../inc/literature_loader.h"
+#include "../inc/mapped_file.h"
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+
+namespace {
+
+/**
+ * Iterates over "[" + [begin, end) + "]" so a run of comma-separated array
+ * elements can be parsed as one JSON array without copying it.
+ */
+class BracketedChunkIterator {
+public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = char;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const char*;
+    using reference = const char&;
+
+    BracketedChunkIterator(const char* chunk, std::ptrdiff_t length, std::ptrdiff_t position)
+        : chunk(chunk), length(length), position(position) {}
+
+    reference operator*() const {
+        return position < 0 ? kOpen : position == length ? kClose : chunk[position];
+    }
+    BracketedChunkIterator& operator++() { ++position; return *this; }
+    BracketedChunkIterator operator++(int) { BracketedChunkIterator old = *this; ++position; return old; }
+    bool operator==(const BracketedChunkIterator& other) const { return position == other.position; }
+    bool operator!=(const BracketedChunkIterator& other) const { return position != other.position; }
+
+private:
+    static constexpr char kOpen = '[';
+    static constexpr char kClose = ']';
+
+    const char* chunk;
+    std::ptrdiff_t length;
+    std::ptrdiff_t position;
+};
+
+/**
+ * Drops the target's ID index for the duration of a bulk load and builds it
+ * once, pre-sized, at the end, instead of growing it record by record
+ */
+class DeferredIdIndex {
+public:
+    explicit DeferredIdIndex(LiteratureStore& target) : store(target), wanted(target.IDsIndexed()) {
+        if (wanted) store.IndexIDs(false);
+    }
+    ~DeferredIdIndex() {
+        if (wanted) store.IndexIDs();
+    }
+    DeferredIdIndex(const DeferredIdIndex&) = delete;
+    DeferredIdIndex& operator=(const DeferredIdIndex&) = delete;
+
+private:
+    LiteratureStore& store;
+    bool wanted;
+};
+
+struct Chunk {
+    const char* Begin;
+    const char* End;
+    std::size_t FirstRecord;  ///< Index of the chunk's first element in the whole array
+};
+
+/**
+ * Splits the elements of the top-level array starting at begin into chunks
+ * of at least chunkBytes. Returns false if the input is not a well-formed
+ * array at the structural level (brackets, strings, trailing content).
+ */
+bool SplitTopLevelArray(const char* begin, const char* end, std::size_t chunkBytes,
+                        std::vector<Chunk>& chunks) {
+    auto isSpace = [](char c) { return c == ' ' || c == '\n' || c == '\r' || c == '\t'; };
+
+    const char* p = begin;
+    while (p < end && isSpace(*p)) ++p;
+    if (p == end || *p != '[') return false;
+    ++p;
+
+    const char* chunkBegin = p;
+    std::size_t chunkFirst = 0;
+    std::size_t element = 0;
+    std::size_t depth = 0;
+    bool sawValue = false;
+
+    for (; p < end; ++p) {
+        char c = *p;
+        if (c == '"') {
+            // Skip the string, honouring escapes
+            for (++p; p < end && *p != '"'; ++p) {
+                if (*p == '\\') ++p;
+            }
+            if (p >= end) return false;
+            sawValue = true;
+        } else if (c == '{' || c == '[') {
+            ++depth;
+            sawValue = true;
+        } else if (c == '}' || c == ']') {
+            if (depth == 0) {
+                if (c != ']' || (!sawValue && element > 0)) return false;
+                if (sawValue) {
+                    chunks.push_back({chunkBegin, p, chunkFirst});
+                }
+                for (++p; p < end; ++p) {
+                    if (!isSpace(*p)) return false;
+                }
+                return true;
+            }
+            --depth;
+        } else if (c == ',' && depth == 0) {
+            if (!sawValue) return false;
+            sawValue = false;
+            ++element;
+            if (static_cast<std::size_t>(p - chunkBegin) >= chunkBytes) {
+                chunks.push_back({chunkBegin, p, chunkFirst});
+                chunkBegin = p + 1;
+                chunkFirst = element;
+            }
+        } else if (!isSpace(c)) {
+            sawValue = true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+LiteratureSaxLoader::LiteratureSaxLoader(LiteratureStore& target, LoadReport& loadReport)
+    : store(target), report(loadReport) {}
+
+void LiteratureSaxLoader::Reject(const std::string& message) {
+    if (!recordValid) return;
+
+    recordValid = false;
+    ++report.Rejected;
+    if (report.Errors.size() < LoadReport::kMaxReportedErrors) {
+        report.Errors.push_back({recordIndex, message});
+    }
+}
+
+bool LiteratureSaxLoader::Number(double value) {
+    if (recordDepth == 0) {
+        return Other("number");
+    }
+    if (depth != recordDepth) {
+        if (inAuthorList && depth == recordDepth + 1) {
+            Reject("Author entries must be strings, but one is a number");
+        }
+        return true;
+    }
+
+    switch (slot) {
+        case Slot::Year:
+            current.Year = static_cast<int>(value);
+            currentMask |= LiteratureStore::kYear;
+            break;
+        case Slot::Rating:
+            current.Rating = value;
+            currentMask |= LiteratureStore::kRating;
+            break;
+        case Slot::Unknown:
+        case Slot::None:
+            break;
+        default:
+            Reject("Field has type number, but a string was expected");
+            break;
+    }
+    return true;
+}
+
+bool LiteratureSaxLoader::Text(std::string& value) {
+    if (recordDepth == 0) {
+        return Other("string");
+    }
+    if (depth != recordDepth) {
+        if (inAuthorList && depth == recordDepth + 1) {
+            current.Author.push_back(std::move(value));
+        }
+        return true;
+    }
+
+    switch (slot) {
+        case Slot::Author:
+            current.Author.push_back(std::move(value));
+            currentMask |= LiteratureStore::kAuthor;
+            break;
+        case Slot::Name:
+            current.Name = std::move(value);
+            currentMask |= LiteratureStore::kName;
+            break;
+        case Slot::Publisher:
+            current.Publisher = std::move(value);
+            currentMask |= LiteratureStore::kPublisher;
+            break;
+        case Slot::ID:
+            currentId = std::move(value);
+            currentMask |= LiteratureStore::kID;
+            break;
+        case Slot::Year:
+        case Slot::Rating:
+            Reject("Field has type string, but a number was expected");
+            break;
+        default:
+            break;
+    }
+    return true;
+}
+
+bool LiteratureSaxLoader::Other(const char* typeName) {
+    if (depth == 0) {
+        report.ParseError = std::string("Literature data must be an array, but is ") + typeName;
+        return false;
+    }
+    if (recordDepth == 0) {
+        // Scalar element of the top-level array
+        if (depth == 1) {
+            recordValid = true;
+            Reject(std::string("Record must be an object, but is ") + typeName);
+            ++recordIndex;
+        }
+        return true;
+    }
+    if (depth == recordDepth && slot != Slot::Unknown && slot != Slot::None) {
+        Reject(std::string("Field has unexpected type ") + typeName);
+    } else if (inAuthorList && depth == recordDepth + 1) {
+        Reject(std::string("Author entries must be strings, but one is ") + typeName);
+    }
+    return true;
+}
+
+bool LiteratureSaxLoader::null() {
+    return Other("null");
+}
+
+bool LiteratureSaxLoader::boolean(bool) {
+    return Other("boolean");
+}
+
+bool LiteratureSaxLoader::number_integer(number_integer_t val) {
+    return Number(static_cast<double>(val));
+}
+
+bool LiteratureSaxLoader::number_unsigned(number_unsigned_t val) {
+    return Number(static_cast<double>(val));
+}
+
+bool LiteratureSaxLoader::number_float(number_float_t val, const string_t&) {
+    return Number(val);
+}
+
+bool LiteratureSaxLoader::string(string_t& val) {
+    return Text(val);
+}
+
+bool LiteratureSaxLoader::binary(binary_t&) {
+    return Other("binary");
+}
+
+bool LiteratureSaxLoader::start_object(std::size_t) {
+    if (recordDepth == 0 && depth <= 1) {
+        // A record starts: either an element of the top-level array or a lone object
+        ++depth;
+        recordDepth = depth;
+        recordValid = true;
+        inAuthorList = false;
+        slot = Slot::None;
+        current.Author.clear();
+        current.Name.clear();
+        current.Year = 0;
+        current.Publisher.clear();
+        current.Rating = 0.0;
+        currentId.clear();
+        currentMask = 0;
+        return true;
+    }
+
+    if (depth == recordDepth && slot != Slot::Unknown) {
+        Reject("Field has unexpected type object");
+    } else if (inAuthorList && depth == recordDepth + 1) {
+        Reject("Author entries must be strings, but one is object");
+    }
+    ++depth;
+    return true;
+}
+
+bool LiteratureSaxLoader::key(string_t& val) {
+    if (depth != recordDepth) {
+        return true;
+    }
+
+    if (val == "Author") slot = Slot::Author;
+    else if (val == "Name") slot = Slot::Name;
+    else if (val == "Year") slot = Slot::Year;
+    else if (val == "Publisher") slot = Slot::Publisher;
+    else if (val == "Rating") slot = Slot::Rating;
+    else if (val == "ID") slot = Slot::ID;
+    else slot = Slot::Unknown;
+    return true;
+}
+
+bool LiteratureSaxLoader::end_object() {
+    if (depth == recordDepth) {
+        if (recordValid) {
+            store.Append(current, currentId, currentMask);
+            ++report.Records;
+        }
+        recordDepth = 0;
+        ++recordIndex;
+    }
+    --depth;
+    return true;
+}
+
+bool LiteratureSaxLoader::start_array(std::size_t elements) {
+    if (depth == 0) {
+        if (elements != static_cast<std::size_t>(-1)) {
+            store.Reserve(store.Size() + elements);
+        }
+        ++depth;
+        return true;
+    }
+
+    if (recordDepth == 0 && depth == 1) {
+        recordValid = true;
+        Reject("Record must be an object, but is array");
+        ++recordIndex;
+    } else if (depth == recordDepth) {
+        if (slot == Slot::Author) {
+            inAuthorList = true;
+            currentMask |= LiteratureStore::kAuthor;
+        } else if (slot != Slot::Unknown) {
+            Reject("Field has unexpected type array");
+        }
+    } else if (inAuthorList && depth == recordDepth + 1) {
+        Reject("Author entries must be strings, but one is array");
+    }
+    ++depth;
+    return true;
+}
+
+bool LiteratureSaxLoader::end_array() {
+    --depth;
+    if (inAuthorList && depth == recordDepth) {
+        inAuthorList = false;
+    }
+    return true;
+}
+
+bool LiteratureSaxLoader::parse_error(std::size_t, const std::string&,
+                                      const nlohmann::detail::exception& ex) {
+    report.ParseError = ex.what();
+    return false;
+}
+
+LoadReport LoadLiterature(std::istream& input, LiteratureStore& store) {
+    DeferredIdIndex ids(store);
+    LoadReport report;
+    LiteratureSaxLoader loader(store, report);
+    json::sax_parse(input, &loader);
+    return report;
+}
+
+LoadReport LoadLiterature(const char* begin, const char* end, LiteratureStore& store) {
+    DeferredIdIndex ids(store);
+    LoadReport report;
+    LiteratureSaxLoader loader(store, report);
+    json::sax_parse(begin, end, &loader);
+    return report;
+}
+
+LiteratureLineReader::LiteratureLineReader(std::istream& source) : input(source) {}
+
+std::size_t LiteratureLineReader::ReadBatch(LiteratureStore& batch, std::size_t maxRecords) {
+    std::size_t appended = 0;
+
+    while (appended < maxRecords && std::getline(input, line)) {
+        std::size_t position = lineNumber++;
+        std::size_t first = line.find_first_not_of(" \t\r");
+        if (first == std::string::npos) {
+            continue;
+        }
+
+        LoadReport lineReport;
+        if (line[first] == '{') {
+            LiteratureSaxLoader loader(batch, lineReport);
+            json::sax_parse(line.data() + first, line.data() + line.size(), &loader);
+        } else {
+            lineReport.ParseError = "Record must be an object";
+        }
+
+        if (!lineReport.Ok() || lineReport.Rejected > 0) {
+            std::string message = lineReport.Ok() ? lineReport.Errors.front().Message : lineReport.ParseError;
+            if (!lineReport.Ok() && lineReport.Records > 0) {
+                // Valid object followed by garbage on the same line: drop the object again
+                batch.PopBack();
+            }
+            ++report.Rejected;
+            if (report.Errors.size() < LoadReport::kMaxReportedErrors) {
+                report.Errors.push_back({position, message});
+            }
+            continue;
+        }
+
+        ++report.Records;
+        ++appended;
+    }
+
+    if (input.bad()) {
+        report.ParseError = "Read error after line " + std::to_string(lineNumber);
+    }
+    if (!input) {
+        done = true;
+    }
+    return appended;
+}
+
+LoadReport LoadLiteratureLines(std::istream& input, LiteratureStore& store) {
+    DeferredIdIndex ids(store);
+    LiteratureLineReader reader(input);
+    const std::size_t kBatchRecords = 1 << 16;
+    while (!reader.Done()) {
+        reader.ReadBatch(store, kBatchRecords);
+    }
+    return reader.Report();
+}
+
+LoadReport LoadLiteratureParallel(const char* begin, const char* end, LiteratureStore& store,
+                                  ThreadPool& pool) {
+    const std::size_t kMinChunkBytes = 1 << 20;
+    std::size_t size = static_cast<std::size_t>(end - begin);
+    std::size_t chunkBytes = std::max(kMinChunkBytes, size / (pool.Size() * 4));
+
+    std::vector<Chunk> chunks;
+    if (pool.Size() < 2 || size < 2 * kMinChunkBytes ||
+        !SplitTopLevelArray(begin, end, chunkBytes, chunks) || chunks.size() < 2) {
+        return LoadLiterature(begin, end, store);
+    }
+
+    DeferredIdIndex ids(store);
+    struct ChunkResult {
+        LiteratureStore Store;
+        LoadReport Report;
+    };
+    std::vector<std::future<ChunkResult>> pending;
+    pending.reserve(chunks.size());
+    for (const Chunk& chunk : chunks) {
+        pending.push_back(pool.Submit([chunk]() {
+            ChunkResult result;
+            // Indexed once when merged into the target store
+            result.Store.IndexRatings(false);
+            result.Store.IndexIDs(false);
+            LiteratureSaxLoader loader(result.Store, result.Report);
+            std::ptrdiff_t length = chunk.End - chunk.Begin;
+            json::sax_parse(BracketedChunkIterator(chunk.Begin, length, -1),
+                            BracketedChunkIterator(chunk.Begin, length, length + 1), &loader);
+            return result;
+        }));
+    }
+
+    // Merge in source order; wait for every chunk even after a failure
+    LoadReport report;
+    for (std::size_t i = 0; i < pending.size(); ++i) {
+        ChunkResult result = pending[i].get();
+        if (!report.Ok()) continue;
+        if (!result.Report.Ok()) {
+            report.ParseError = result.Report.ParseError;
+            continue;
+        }
+
+        store.AppendAll(result.Store);
+        report.Records += result.Report.Records;
+        report.Rejected += result.Report.Rejected;
+        for (const LoadError& error : result.Report.Errors) {
+            if (report.Errors.size() < LoadReport::kMaxReportedErrors) {
+                report.Errors.push_back({error.Record + chunks[i].FirstRecord, error.Message});
+            }
+        }
+    }
+
+    return report;
+}
+
+LoadReport LoadLiteratureBinary(const char* begin, const char* end, DataFormat format, LiteratureStore& store) {
+    json::input_format_t inputFormat = json::input_format_t::ubjson;
+    if (format == DataFormat::Cbor) {
+        inputFormat = json::input_format_t::cbor;
+    } else if (format == DataFormat::MessagePack) {
+        inputFormat = json::input_format_t::msgpack;
+    }
+
+    DeferredIdIndex ids(store);
+    LoadReport report;
+    LiteratureSaxLoader loader(store, report);
+    json::sax_parse(begin, end, &loader, inputFormat);
+    return report;
+}
+
+bool LoadLiteratureFile(const std::string& filename, DataFormat format, LiteratureStore& store,
+                        LoadReport& report) {
+    MappedFile file;
+    if (!file.Open(filename)) {
+        return false;
+    }
+    if (format == DataFormat::Auto) {
+        format = DetectDataFormat(filename, file.View().substr(0, 4096));
+    }
+
+    switch (format) {
+        case DataFormat::NDJSON: {
+            file.Close();
+            std::ifstream lines(filename);
+            if (!lines.is_open()) {
+                return false;
+            }
+            report = LoadLiteratureLines(lines, store);
+            break;
+        }
+        case DataFormat::Cbor:
+        case DataFormat::MessagePack:
+        case DataFormat::Ubjson:
+            report = LoadLiteratureBinary(file.Data(), file.Data() + file.Size(), format, store);
+            break;
+        default:
+            report = LoadLiteratureParallel(file.Data(), file.Data() + file.Size(), store);
+            break;
+    }
+    return true;
+}
@@ -0,0 +1,216 @@
+#include "../inc/literature_snapshot.h"
+#include "../inc/mapped_file.h"
+#include "../inc/checksum.h"
+#include "../inc/file_sync.h"
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <memory>
+
+static_assert(sizeof(int) == 4, "Year column is stored as 32-bit integers");
+static_assert(sizeof(double) == 8, "Rating column is stored as 64-bit doubles");
+static_assert(sizeof(LiteratureSnapshot::SnapshotHeader) % 8 == 0, "Header keeps sections aligned");
+
+namespace {
+
+const char kMagic[8] = {'L', 'I', 'T', 'S', 'N', 'A', 'P', '\0'};
+const std::size_t kAlignment = 8;
+
+std::uint64_t Align(std::uint64_t offset) {
+    return (offset + kAlignment - 1) & ~static_cast<std::uint64_t>(kAlignment - 1);
+}
+
+// Offsets must start at 0, never decrease and end at the heap size
+bool ValidOffsets(const std::uint64_t* offsets, std::size_t entries, std::uint64_t heapBytes, bool full) {
+    if (offsets[0] != 0 || offsets[entries] != heapBytes) {
+        return false;
+    }
+    if (full) {
+        for (std::size_t i = 0; i < entries; ++i) {
+            if (offsets[i] > offsets[i + 1]) return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+std::uint64_t LiteratureSnapshot::Checksum(const void* data, std::size_t size) {
+    return Checksum64(data, size);
+}
+
+bool LiteratureSnapshot::Write(std::ostream& out, const LiteratureStore& store, std::uint64_t sequence) {
+    if (store.Deleted() > 0) {
+        // Snapshots hold live records only: write a compacted version
+        LiteratureStore live = store.Freeze();
+        live.IndexIDs(false);
+        live.Compact();
+        return Write(out, live, sequence);
+    }
+    struct Block {
+        const void* Data;
+        std::size_t Size;
+    };
+    const Block blocks[kSectionCount] = {
+        {store.masks.data(), store.masks.size() * sizeof(std::uint8_t)},
+        {store.years.data(), store.years.size() * sizeof(int)},
+        {store.ratings.data(), store.ratings.size() * sizeof(double)},
+        {store.names.Offsets().data(), store.names.Offsets().size() * sizeof(std::uint64_t)},
+        {store.names.Heap().data(), store.names.Heap().size()},
+        {store.publishers.Offsets().data(), store.publishers.Offsets().size() * sizeof(std::uint64_t)},
+        {store.publishers.Heap().data(), store.publishers.Heap().size()},
+        {store.ids.Offsets().data(), store.ids.Offsets().size() * sizeof(std::uint64_t)},
+        {store.ids.Heap().data(), store.ids.Heap().size()},
+        {store.authorStarts.data(), store.authorStarts.size() * sizeof(std::uint64_t)},
+        {store.authors.Offsets().data(), store.authors.Offsets().size() * sizeof(std::uint64_t)},
+        {store.authors.Heap().data(), store.authors.Heap().size()},
+    };
+
+    SnapshotHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.Magic, kMagic, sizeof(kMagic));
+    header.Version = kVersion;
+    header.ByteOrder = kByteOrderTag;
+    header.Records = store.Size();
+    header.Authors = store.authors.Size();
+    header.Sequence = sequence;
+
+    std::uint64_t offset = sizeof(SnapshotHeader);
+    for (std::size_t s = 0; s < kSectionCount; ++s) {
+        header.Sections[s].Offset = offset;
+        header.Sections[s].Size = blocks[s].Size;
+        header.Sections[s].Checksum = Checksum(blocks[s].Data, blocks[s].Size);
+        offset = Align(offset + blocks[s].Size);
+    }
+    header.HeaderChecksum = Checksum(&header, offsetof(SnapshotHeader, HeaderChecksum));
+
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    const char padding[kAlignment] = {};
+    for (std::size_t s = 0; s < kSectionCount; ++s) {
+        if (blocks[s].Size > 0) {
+            out.write(static_cast<const char*>(blocks[s].Data), static_cast<std::streamsize>(blocks[s].Size));
+        }
+        std::size_t pad = static_cast<std::size_t>(Align(blocks[s].Size) - blocks[s].Size);
+        out.write(padding, static_cast<std::streamsize>(pad));
+    }
+    return static_cast<bool>(out);
+}
+
+bool LiteratureSnapshot::Save(const std::string& filename, const LiteratureStore& store, std::string& error,
+                              std::uint64_t sequence) {
+    const std::string temporary = filename + ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            error = "Cannot open " + temporary + " for writing";
+            return false;
+        }
+        if (!Write(file, store, sequence) || !file.flush()) {
+            error = "Write to " + temporary + " failed";
+            file.close();
+            std::remove(temporary.c_str());
+            return false;
+        }
+    }
+
+    if (!DurableReplace(temporary, filename)) {
+        error = "Cannot replace " + filename;
+        return false;
+    }
+    return true;
+}
+
+bool LiteratureSnapshot::Open(const std::string& filename, LiteratureStore& store, std::string& error,
+                              bool verify, std::uint64_t* sequence) {
+    auto file = std::make_shared<MappedFile>();
+    if (!file->Open(filename, MappedFile::Access::Random)) {
+        error = "Cannot open file " + filename;
+        return false;
+    }
+
+    const char* base = file->Data();
+    std::size_t fileSize = file->Size();
+    SnapshotHeader header;
+    if (fileSize < sizeof(header)) {
+        error = "File is too small for a snapshot";
+        return false;
+    }
+    std::memcpy(&header, base, sizeof(header));
+
+    if (std::memcmp(header.Magic, kMagic, sizeof(kMagic)) != 0) {
+        error = "Not a snapshot file";
+        return false;
+    }
+    if (header.Version != kVersion) {
+        error = "Unsupported snapshot version " + std::to_string(header.Version);
+        return false;
+    }
+    if (header.ByteOrder != kByteOrderTag) {
+        error = "Snapshot was written with a different byte order";
+        return false;
+    }
+    if (header.HeaderChecksum != Checksum(&header, offsetof(SnapshotHeader, HeaderChecksum))) {
+        error = "Header checksum mismatch";
+        return false;
+    }
+
+    const std::uint64_t records = header.Records;
+    const std::uint64_t authorCount = header.Authors;
+    const std::uint64_t offsetBytes = (records + 1) * sizeof(std::uint64_t);
+    const std::uint64_t expected[kSectionCount] = {
+        records * sizeof(std::uint8_t), records * sizeof(int), records * sizeof(double),
+        offsetBytes, header.Sections[kNameHeap].Size,
+        offsetBytes, header.Sections[kPublisherHeap].Size,
+        offsetBytes, header.Sections[kIDHeap].Size,
+        offsetBytes, (authorCount + 1) * sizeof(std::uint64_t), header.Sections[kAuthorHeap].Size,
+    };
+    if (records > fileSize || authorCount > fileSize) {
+        error = "Record counts exceed the file size";
+        return false;
+    }
+    for (std::size_t s = 0; s < kSectionCount; ++s) {
+        const SectionEntry& section = header.Sections[s];
+        if (section.Size != expected[s] || section.Offset % kAlignment != 0 ||
+            section.Offset > fileSize || section.Size > fileSize - section.Offset) {
+            error = "Section " + std::to_string(s) + " is out of bounds";
+            return false;
+        }
+        if (verify && section.Checksum != Checksum(base + section.Offset, section.Size)) {
+            error = "Section " + std::to_string(s) + " checksum mismatch";
+            return false;
+        }
+    }
+
+    auto section = [&](Section s) { return base + header.Sections[s].Offset; };
+    auto offsets = [&](Section s) { return reinterpret_cast<const std::uint64_t*>(section(s)); };
+    if (!ValidOffsets(offsets(kNameOffsets), records, header.Sections[kNameHeap].Size, verify) ||
+        !ValidOffsets(offsets(kPublisherOffsets), records, header.Sections[kPublisherHeap].Size, verify) ||
+        !ValidOffsets(offsets(kIDOffsets), records, header.Sections[kIDHeap].Size, verify) ||
+        !ValidOffsets(offsets(kAuthorStarts), records, authorCount, verify) ||
+        !ValidOffsets(offsets(kAuthorOffsets), authorCount, header.Sections[kAuthorHeap].Size, verify)) {
+        error = "Inconsistent offset arrays";
+        return false;
+    }
+
+    LiteratureStore mapped;
+    mapped.masks.Borrow(reinterpret_cast<const std::uint8_t*>(section(kMasks)), records);
+    mapped.years.Borrow(reinterpret_cast<const int*>(section(kYears)), records);
+    mapped.ratings.Borrow(reinterpret_cast<const double*>(section(kRatings)), records);
+    mapped.names.Borrow(section(kNameHeap), header.Sections[kNameHeap].Size, offsets(kNameOffsets), records);
+    mapped.publishers.Borrow(section(kPublisherHeap), header.Sections[kPublisherHeap].Size,
+                             offsets(kPublisherOffsets), records);
+    mapped.ids.Borrow(section(kIDHeap), header.Sections[kIDHeap].Size, offsets(kIDOffsets), records);
+    mapped.authors.Borrow(section(kAuthorHeap), header.Sections[kAuthorHeap].Size, offsets(kAuthorOffsets),
+                          authorCount);
+    mapped.authorStarts.Borrow(offsets(kAuthorStarts), records + 1);
+    mapped.backing = std::move(file);
+    mapped.ratingsIndexed = false;  // Built on demand, so that opening stays O(1)
+    mapped.idsIndexed = false;
+
+    store = std::move(mapped);
+    if (sequence != nullptr) {
+        *sequence = header.Sequence;
+    }
+    return true;
+}
@@ -0,0 +1,761 @@
+#include "../inc/literature_store.h"
+#include "../inc/record_predicate.h"
+#include <algorithm>
+#include <cmath>
+#include <climits>
+#include <cstring>
+#include <utility>
+
+void StringColumn::Reserve(std::size_t entries, std::size_t bytes) {
+    offsets.reserve(entries + 1);
+    heap.reserve(bytes);
+}
+
+void StringColumn::Clear() {
+    heap.clear();
+    offsets.assign(1, 0);
+}
+
+void StringColumn::Erase(const std::vector<bool>& remove) {
+    std::size_t writeEntry = 0;
+    std::uint64_t writeByte = 0;
+
+    for (std::size_t i = 0; i < Size(); ++i) {
+        if (remove[i]) continue;
+
+        std::uint64_t begin = offsets[i];
+        std::uint64_t length = offsets[i + 1] - begin;
+        if (writeByte != begin && length > 0) {
+            std::memmove(&heap[writeByte], &heap[begin], length);
+        }
+        writeByte += length;
+        offsets[++writeEntry] = writeByte;
+    }
+
+    offsets.resize(writeEntry + 1);
+    heap.resize(writeByte);
+}
+
+std::size_t StringColumn::MemoryUsage() const {
+    return heap.capacity() + offsets.capacity() * sizeof(std::uint64_t);
+}
+
+std::uint8_t LiteratureStore::FieldBit(const std::string& name) {
+    if (name == "Author") return kAuthor;
+    if (name == "Name") return kName;
+    if (name == "Year") return kYear;
+    if (name == "Publisher") return kPublisher;
+    if (name == "Rating") return kRating;
+    if (name == "ID") return kID;
+    return 0;
+}
+
+void LiteratureStore::Clear() {
+    masks.clear();
+    years.clear();
+    ratings.clear();
+    names.Clear();
+    publishers.Clear();
+    ids.Clear();
+    authors.Clear();
+    authorStarts.assign(1, 0);
+    deleted = 0;
+    backing.reset();
+    ratingIndex.Clear();
+    idIndex.Clear();
+    idsIndexed = idsWanted;
+    nameIndex.Clear();
+    publisherIndex.Clear();
+    authorIndex.Clear();
+    yearIndex.Clear();
+    ratingOrder.Clear();
+}
+
+void LiteratureStore::Reserve(std::size_t records) {
+    masks.reserve(records);
+    years.reserve(records);
+    ratings.reserve(records);
+    authorStarts.reserve(records + 1);
+    names.Reserve(records, 0);
+    publishers.Reserve(records, 0);
+    ids.Reserve(records, 0);
+}
+
+std::size_t LiteratureStore::Append(const Literature& lit, std::string_view id) {
+    std::uint8_t mask = kLiteratureFields;
+    if (!id.empty()) mask |= kID;
+    return Append(lit, id, mask);
+}
+
+std::size_t LiteratureStore::Append(const Literature& lit, std::string_view id, std::uint8_t mask) {
+    masks.push_back(mask);
+    years.push_back((mask & kYear) ? lit.Year : 0);
+    ratings.push_back((mask & kRating) ? lit.Rating : 0.0);
+    names.Append((mask & kName) ? std::string_view(lit.Name) : std::string_view());
+    publishers.Append((mask & kPublisher) ? std::string_view(lit.Publisher) : std::string_view());
+    ids.Append((mask & kID) ? id : std::string_view());
+
+    if (mask & kAuthor) {
+        for (const auto& author : lit.Author) {
+            authors.Append(author);
+        }
+    }
+    authorStarts.push_back(authors.Size());
+    IndexRecord(masks.size() - 1);
+
+    return masks.size() - 1;
+}
+
+std::size_t LiteratureStore::AppendJson(const json& item) {
+    if (!item.is_object()) {
+        throw json::type_error::create(302, "Literature record must be an object, but is " +
+                                       std::string(item.type_name()), &item);
+    }
+
+    Literature lit{};
+    std::string id;
+    std::uint8_t mask = 0;
+
+    auto field = item.find("Author");
+    if (field != item.end()) {
+        if (field->is_string()) {
+            lit.Author.push_back(field->get<std::string>());
+        } else {
+            field->get_to(lit.Author);
+        }
+        mask |= kAuthor;
+    }
+    if ((field = item.find("Name")) != item.end()) {
+        field->get_to(lit.Name);
+        mask |= kName;
+    }
+    if ((field = item.find("Year")) != item.end()) {
+        field->get_to(lit.Year);
+        mask |= kYear;
+    }
+    if ((field = item.find("Publisher")) != item.end()) {
+        field->get_to(lit.Publisher);
+        mask |= kPublisher;
+    }
+    if ((field = item.find("Rating")) != item.end()) {
+        field->get_to(lit.Rating);
+        mask |= kRating;
+    }
+    if ((field = item.find("ID")) != item.end()) {
+        field->get_to(id);
+        mask |= kID;
+    }
+
+    return Append(lit, id, mask);
+}
+
+void LiteratureStore::PopBack() {
+    UnindexLast();
+    if (!Live(Size() - 1)) {
+        --deleted;
+    }
+    masks.pop_back();
+    years.pop_back();
+    ratings.pop_back();
+    names.PopBack();
+    publishers.PopBack();
+    ids.PopBack();
+    authorStarts.pop_back();
+    while (authors.Size() > authorStarts.back()) {
+        authors.PopBack();
+    }
+}
+
+void LiteratureStore::AppendAll(const LiteratureStore& other) {
+    Reserve(Size() + other.Size());
+    for (std::size_t i = 0; i < other.Size(); ++i) {
+        masks.push_back(other.masks[i]);
+        years.push_back(other.years[i]);
+        ratings.push_back(other.ratings[i]);
+        names.Append(other.names.Get(i));
+        publishers.Append(other.publishers.Get(i));
+        ids.Append(other.ids.Get(i));
+        for (std::size_t k = 0; k < other.AuthorCount(i); ++k) {
+            authors.Append(other.Author(i, k));
+        }
+        authorStarts.push_back(authors.Size());
+        IndexRecord(masks.size() - 1);
+    }
+    deleted += other.deleted;
+}
+
+LiteratureStore LiteratureStore::Freeze() const {
+    LiteratureStore version;
+    version.masks = masks.Share();
+    version.years = years.Share();
+    version.ratings = ratings.Share();
+    version.names = names.Share();
+    version.publishers = publishers.Share();
+    version.ids = ids.Share();
+    version.authors = authors.Share();
+    version.authorStarts = authorStarts.Share();
+    version.deleted = deleted;
+    version.backing = backing;
+    version.ratingsIndexed = false;  // Read-only; an index would cost a copy
+    version.idsIndexed = false;
+    version.indexedFields = 0;
+    return version;
+}
+
+Literature LiteratureStore::Get(std::size_t i) const {
+    Literature lit;
+    lit.Author.reserve(AuthorCount(i));
+    for (std::size_t k = 0; k < AuthorCount(i); ++k) {
+        lit.Author.emplace_back(Author(i, k));
+    }
+    lit.Name = std::string(names.Get(i));
+    lit.Year = years[i];
+    lit.Publisher = std::string(publishers.Get(i));
+    lit.Rating = ratings[i];
+    return lit;
+}
+
+json LiteratureStore::RecordToJson(std::size_t i) const {
+    json item = json::object();
+
+    if (Has(i, kAuthor)) {
+        json authorList = json::array();
+        for (std::size_t k = 0; k < AuthorCount(i); ++k) {
+            authorList.push_back(Author(i, k));
+        }
+        item["Author"] = std::move(authorList);
+    }
+    if (Has(i, kName)) item["Name"] = names.Get(i);
+    if (Has(i, kYear)) item["Year"] = years[i];
+    if (Has(i, kPublisher)) item["Publisher"] = publishers.Get(i);
+    if (Has(i, kRating)) item["Rating"] = ratings[i];
+    if (Has(i, kID)) item["ID"] = ids.Get(i);
+
+    return item;
+}
+
+json LiteratureStore::ToJson() const {
+    json result = json::array();
+    for (std::size_t i = 0; i < Size(); ++i) {
+        if (Live(i)) {
+            result.push_back(RecordToJson(i));
+        }
+    }
+    return result;
+}
+
+LiteratureStore LiteratureStore::FromJson(const json& data) {
+    LiteratureStore store;
+
+    if (data.is_array()) {
+        store.Reserve(data.size());
+        for (const auto& item : data) {
+            store.AppendJson(item);
+        }
+    } else if (data.is_object()) {
+        store.AppendJson(data);
+    } else if (!data.is_null()) {
+        throw json::type_error::create(302, "Literature data must be an array, but is " +
+                                       std::string(data.type_name()), &data);
+    }
+
+    return store;
+}
+
+LiteratureStore LiteratureStore::Select(const std::vector<std::size_t>& indices) const {
+    LiteratureStore result;
+    result.indexedFields = indexedFields;
+    result.Reserve(indices.size());
+
+    for (std::size_t i : indices) {
+        result.deleted += !Live(i);
+        result.masks.push_back(masks[i]);
+        result.years.push_back(years[i]);
+        result.ratings.push_back(ratings[i]);
+        result.names.Append(names.Get(i));
+        result.publishers.Append(publishers.Get(i));
+        result.ids.Append(ids.Get(i));
+        for (std::size_t k = 0; k < AuthorCount(i); ++k) {
+            result.authors.Append(Author(i, k));
+        }
+        result.authorStarts.push_back(result.authors.Size());
+        result.IndexRecord(result.masks.size() - 1);
+    }
+
+    return result;
+}
+
+namespace {
+
+// Number of ranks a band fraction covers
+std::size_t BandSize(std::size_t n, double fraction) {
+    if (fraction <= 0.0 || n == 0) {
+        return 0;
+    }
+    // The epsilon keeps e.g. 30 * 0.1 from rounding down to 2
+    auto count = static_cast<std::size_t>(std::floor(static_cast<double>(n) * fraction + 1e-9));
+    return std::min(n, std::max<std::size_t>(1, count));
+}
+
+template <typename T>
+using RankKey = std::pair<T, std::size_t>;  // (value, index): a total order over records
+
+// Smallest lowCount and largest topCount keys of records [begin, end), each sorted ascending
+template <typename T>
+struct PartialBand {
+    std::vector<RankKey<T>> Bottom;
+    std::vector<RankKey<T>> Top;
+};
+
+template <typename T>
+PartialBand<T> SelectChunk(const ColumnBuffer<T>& values, std::size_t begin, std::size_t end,
+                           std::size_t lowCount, std::size_t topCount) {
+    const std::size_t m = end - begin;
+    std::vector<RankKey<T>> keys(m);
+    for (std::size_t i = 0; i < m; ++i) {
+        keys[i] = {values[begin + i], begin + i};
+    }
+    lowCount = std::min(lowCount, m);
+    topCount = std::min(topCount, m);
+
+    auto lowEnd = keys.begin() + static_cast<std::ptrdiff_t>(lowCount);
+    auto topBegin = keys.end() - static_cast<std::ptrdiff_t>(topCount);
+    if (lowCount + topCount >= m) {
+        std::sort(keys.begin(), keys.end());
+    } else {
+        if (lowCount > 0) {
+            std::nth_element(keys.begin(), lowEnd, keys.end());
+        }
+        std::nth_element(lowEnd, topBegin, keys.end());
+        std::sort(keys.begin(), lowEnd);
+        std::sort(topBegin, keys.end());
+    }
+
+    PartialBand<T> band;
+    band.Bottom.assign(keys.begin(), lowEnd);
+    band.Top.assign(topBegin, keys.end());
+    return band;
+}
+
+// Keys of records [begin, end) at or below lowLimit / at or above topLimit, each sorted ascending
+template <typename T>
+PartialBand<T> CollectChunk(const ColumnBuffer<T>& values, std::size_t begin, std::size_t end,
+                            const RankKey<T>* lowLimit, const RankKey<T>* topLimit) {
+    PartialBand<T> band;
+    for (std::size_t i = begin; i < end; ++i) {
+        RankKey<T> key{values[i], i};
+        if (lowLimit && key <= *lowLimit) band.Bottom.push_back(key);
+        if (topLimit && key >= *topLimit) band.Top.push_back(key);
+    }
+    std::sort(band.Bottom.begin(), band.Bottom.end());
+    std::sort(band.Top.begin(), band.Top.end());
+    return band;
+}
+
+template <typename T>
+void SelectBand(const ColumnBuffer<T>& values, std::size_t lowCount, std::size_t highCount,
+                std::vector<std::size_t>& indices, ThreadPool& pool) {
+    const std::size_t kMinChunkRecords = 1 << 16;
+    const std::size_t kSampleSize = 1 << 15;
+    const std::size_t n = values.size();
+    // Ranks [0, lowCount) and [n - topCount, n); the top band never re-takes bottom ranks
+    const std::size_t topCount = n - std::max(n - highCount, lowCount);
+
+    std::size_t chunks = std::min(pool.Size(), n / kMinChunkRecords);
+    std::vector<PartialBand<T>> partials;
+    if (chunks >= 2) {
+        // Limits a little past the band edges, estimated from an evenly spaced
+        // sample; each chunk then only sorts the keys beyond them
+        std::vector<RankKey<T>> sample(kSampleSize);
+        for (std::size_t s = 0; s < kSampleSize; ++s) {
+            std::size_t i = s * n / kSampleSize;
+            sample[s] = {values[i], i};
+        }
+        std::sort(sample.begin(), sample.end());
+        const std::size_t margin = kSampleSize / 64 + 16;
+        std::size_t lowRank = (lowCount * kSampleSize + n - 1) / n + margin;
+        std::size_t topRank = topCount * kSampleSize / n + margin;
+
+        // A band covering most of the data is cheaper to select on one thread
+        if (lowRank < kSampleSize && topRank < kSampleSize) {
+            RankKey<T> lowLimit = sample[lowRank];
+            RankKey<T> topLimit = sample[kSampleSize - 1 - topRank];
+            const RankKey<T>* low = lowCount > 0 ? &lowLimit : nullptr;
+            const RankKey<T>* top = topCount > 0 ? &topLimit : nullptr;
+
+            std::vector<std::future<PartialBand<T>>> pending;
+            for (std::size_t c = 0; c < chunks; ++c) {
+                std::size_t begin = n * c / chunks;
+                std::size_t end = n * (c + 1) / chunks;
+                pending.push_back(pool.Submit([&values, begin, end, low, top]() {
+                    return CollectChunk(values, begin, end, low, top);
+                }));
+            }
+
+            std::size_t bottomFound = 0, topFound = 0;
+            for (auto& partial : pending) {
+                partials.push_back(partial.get());
+                bottomFound += partials.back().Bottom.size();
+                topFound += partials.back().Top.size();
+            }
+            // A skewed sample may put a limit inside a band; use the exact path then
+            if (bottomFound < lowCount || topFound < topCount) {
+                partials.clear();
+            }
+        }
+    }
+    if (partials.empty()) {
+        partials.push_back(SelectChunk(values, 0, n, lowCount, topCount));
+    }
+
+    indices.clear();
+    indices.reserve(lowCount + topCount);
+    if (partials.size() == 1) {
+        for (const auto& key : partials[0].Bottom) indices.push_back(key.second);
+        for (const auto& key : partials[0].Top) indices.push_back(key.second);
+        return;
+    }
+
+    // k-way merge of the sorted candidate lists: the bottom from the front...
+    using Cursor = std::pair<RankKey<T>, std::size_t>;  // (key, chunk)
+    std::vector<Cursor> heap;
+    std::vector<std::size_t> next(partials.size(), 0);
+    auto greater = [](const Cursor& a, const Cursor& b) { return a.first > b.first; };
+    for (std::size_t c = 0; c < partials.size(); ++c) {
+        if (!partials[c].Bottom.empty()) heap.push_back({partials[c].Bottom[0], c});
+    }
+    std::make_heap(heap.begin(), heap.end(), greater);
+    while (indices.size() < lowCount) {
+        std::pop_heap(heap.begin(), heap.end(), greater);
+        std::size_t c = heap.back().second;
+        indices.push_back(heap.back().first.second);
+        heap.pop_back();
+        if (++next[c] < partials[c].Bottom.size()) {
+            heap.push_back({partials[c].Bottom[next[c]], c});
+            std::push_heap(heap.begin(), heap.end(), greater);
+        }
+    }
+
+    // ...and the top from the back, written in ascending order
+    indices.resize(lowCount + topCount);
+    auto less = [](const Cursor& a, const Cursor& b) { return a.first < b.first; };
+    heap.clear();
+    for (std::size_t c = 0; c < partials.size(); ++c) {
+        next[c] = partials[c].Top.size();
+        if (next[c] > 0) heap.push_back({partials[c].Top[--next[c]], c});
+    }
+    std::make_heap(heap.begin(), heap.end(), less);
+    for (std::size_t slot = indices.size(); slot > lowCount; --slot) {
+        std::pop_heap(heap.begin(), heap.end(), less);
+        std::size_t c = heap.back().second;
+        indices[slot - 1] = heap.back().first.second;
+        heap.pop_back();
+        if (next[c] > 0) {
+            heap.push_back({partials[c].Top[--next[c]], c});
+            std::push_heap(heap.begin(), heap.end(), less);
+        }
+    }
+}
+
+} // namespace
+
+bool LiteratureStore::PercentileBand(const std::string& field, double lower, double upper,
+                                     std::vector<std::size_t>& indices, ThreadPool& pool) const {
+    if (!(lower >= 0.0 && lower <= 1.0 && upper >= 0.0 && upper <= 1.0)) {
+        return false;
+    }
+    if (field != "Rating" && field != "Year") {
+        return false;
+    }
+    const std::size_t n = Count();
+    const std::size_t lowCount = BandSize(n, lower);
+    const std::size_t highCount = BandSize(n, upper);
+    if (deleted > 0) {
+        // Rank the live values only, then map their ranks back to slots
+        std::vector<std::size_t> slots;
+        slots.reserve(n);
+        for (std::size_t i = 0; i < Size(); ++i) {
+            if (Live(i)) slots.push_back(i);
+        }
+        if (field == "Rating") {
+            ColumnBuffer<double> live;
+            live.reserve(n);
+            for (std::size_t i : slots) live.push_back(Rating(i));
+            SelectBand(live, lowCount, highCount, indices, pool);
+        } else {
+            ColumnBuffer<int> live;
+            live.reserve(n);
+            for (std::size_t i : slots) live.push_back(Year(i));
+            SelectBand(live, lowCount, highCount, indices, pool);
+        }
+        for (std::size_t& index : indices) {
+            index = slots[index];
+        }
+    } else if (field == "Rating" && ratingsIndexed && ratingIndex.Exact()) {
+        ratingIndex.Band(lowCount, n - std::max(n - highCount, lowCount), indices);
+    } else if (field == "Rating") {
+        SelectBand(ratings, lowCount, highCount, indices, pool);
+    } else {
+        SelectBand(years, lowCount, highCount, indices, pool);
+    }
+    return true;
+}
+
+void LiteratureStore::IndexRatings(bool enabled) {
+    if (enabled && !ratingsIndexed) {
+        ratingIndex.Build(ratings.data(), ratings.size());
+    } else if (!enabled) {
+        ratingIndex = RatingIndex();  // Releases the buckets
+    }
+    ratingsIndexed = enabled;
+}
+
+void LiteratureStore::IndexFields(std::uint8_t fields) {
+    fields &= kIndexableFields;
+    std::uint8_t added = fields & ~indexedFields;
+    if (!(fields & kName)) nameIndex = TextIndex();  // Assigning releases the memory
+    if (!(fields & kPublisher)) publisherIndex = TextIndex();
+    if (!(fields & kAuthor)) authorIndex = AuthorIndex();
+    if (!(fields & kYear)) yearIndex = OrderedIndex<int>();
+    if (!(fields & kRating)) ratingOrder = OrderedIndex<double>();
+
+    // Const accessors only: the columns may be borrowed or shared with a frozen version
+    for (std::size_t i = 0; added != 0 && i < Size(); ++i) {
+        std::uint8_t mask = Mask(i) & added;
+        if (mask & kName) nameIndex.Add(i, Name(i));
+        if (mask & kPublisher) publisherIndex.Add(i, Publisher(i));
+        if (mask & kYear) yearIndex.Add(i, Year(i));
+        if (mask & kRating) ratingOrder.Add(i, Rating(i));
+        for (std::size_t k = 0; (mask & kAuthor) && k < AuthorCount(i); ++k) authorIndex.Add(i, Author(i, k));
+    }
+    indexedFields = fields;
+}
+
+bool LiteratureStore::IndexLookup(Field field, std::string_view value, std::vector<std::size_t>& positions) const {
+    if (!(indexedFields & field) || (field != kName && field != kPublisher && field != kAuthor)) {
+        return false;
+    }
+    const std::vector<std::uint32_t>* found = field == kAuthor ? authorIndex.Find(value)
+                                            : (field == kName ? nameIndex : publisherIndex).Find(value);
+    positions.clear();
+    if (found != nullptr) {
+        positions.assign(found->begin(), found->end());
+    }
+    if (field == kName || field == kPublisher) {
+        ScanUnindexed(positions, [this, field, value](std::size_t i) {
+            return Has(i, field) && (field == kName ? Name(i) : Publisher(i)) == value;
+        });
+    } else {
+        ScanUnindexed(positions, [this, value](std::size_t i) { return ListsAuthor(i, value); });
+    }
+    DropDeleted(positions);
+    return true;
+}
+
+bool LiteratureStore::AuthorLookup(const std::vector<std::string>& authors, std::vector<std::size_t>& positions) const {
+    if (!(indexedFields & kAuthor)) {
+        return false;
+    }
+    authorIndex.FindAll(authors, positions);
+    ScanUnindexed(positions, [this, &authors](std::size_t i) {
+        return !authors.empty() && std::all_of(authors.begin(), authors.end(),
+                                               [this, i](const std::string& author) { return ListsAuthor(i, author); });
+    });
+    DropDeleted(positions);
+    return true;
+}
+
+bool LiteratureStore::IndexRange(Field field, double low, double high, const std::function<bool(double)>& accept,
+                                 std::vector<std::size_t>& positions) const {
+    if (!(indexedFields & field) || (field != kYear && field != kRating)) {
+        return false;
+    }
+    positions.clear();
+    if (field == kRating) {
+        ratingOrder.Collect(low, high, accept, positions);
+    } else if (low <= high && high >= INT_MIN && low <= INT_MAX) {
+        int first = low < INT_MIN ? INT_MIN : static_cast<int>(std::ceil(low));
+        int last = high > INT_MAX ? INT_MAX : static_cast<int>(std::floor(high));
+        yearIndex.Collect(first, last, [&accept](int year) { return accept(year); }, positions);
+    }
+    ScanUnindexed(positions, [this, field, low, high, &accept](std::size_t i) {
+        double value = field == kRating ? Rating(i) : Year(i);
+        return Has(i, field) && value >= low && value <= high && accept(value);
+    });
+    // Posting lists come out by value; callers expect record order
+    std::sort(positions.begin(), positions.end());
+    DropDeleted(positions);
+    return true;
+}
+
+std::size_t LiteratureStore::FindID(std::string_view id) const {
+    if (idsIndexed && deleted == 0) {
+        return idIndex.Find(id, [this](std::size_t i) { return ids.Get(i); });
+    }
+    if (idsIndexed) {
+        // Probe past deleted records carrying the same ID
+        return idIndex.FindIf(id, [this, id](std::size_t i) { return Live(i) && ids.Get(i) == id; });
+    }
+    for (std::size_t i = 0; i < Size(); ++i) {
+        if (Has(i, kID) && Live(i) && ids.Get(i) == id) {
+            return i;
+        }
+    }
+    return IdIndex::kNotFound;
+}
+
+void LiteratureStore::IndexIDs(bool enabled) {
+    idsWanted = enabled;
+    if (!enabled) {
+        idIndex = IdIndex();  // Releases the slots
+        idsIndexed = false;
+        return;
+    }
+    if (idsIndexed) {
+        return;
+    }
+    std::size_t withID = 0;
+    for (std::size_t i = 0; i < Size(); ++i) {
+        withID += (Mask(i) & kID) != 0;
+    }
+    idIndex.Clear();
+    idIndex.Reserve(withID);
+    for (std::size_t i = 0; i < Size(); ++i) {
+        if (Mask(i) & kID) {
+            idIndex.Add(i, ID(i));
+        }
+    }
+    idsIndexed = true;
+}
+
+std::size_t LiteratureStore::IndexMemoryUsage() const {
+    return nameIndex.MemoryUsage() + publisherIndex.MemoryUsage() + authorIndex.MemoryUsage() +
+           yearIndex.MemoryUsage() + ratingOrder.MemoryUsage();
+}
+
+void LiteratureStore::IndexRecord(std::size_t i) {
+    if (ratingsIndexed) {
+        ratingIndex.Add(i, Rating(i));
+    }
+    if (idsIndexed) {
+        if (Mask(i) & kID) idIndex.Add(i, ID(i));
+    } else if (idsWanted) {
+        IndexIDs();  // First change after a snapshot open or a freeze, which copies the columns anyway
+    }
+    std::uint8_t mask = Mask(i) & indexedFields;
+    if (mask & kName) nameIndex.Add(i, Name(i));
+    if (mask & kPublisher) publisherIndex.Add(i, Publisher(i));
+    if (mask & kYear) yearIndex.Add(i, Year(i));
+    if (mask & kRating) ratingOrder.Add(i, Rating(i));
+    for (std::size_t k = 0; (mask & kAuthor) && k < AuthorCount(i); ++k) authorIndex.Add(i, Author(i, k));
+}
+
+void LiteratureStore::UnindexLast() {
+    std::size_t i = Size() - 1;
+    if (ratingsIndexed) {
+        ratingIndex.RemoveLast(Rating(i));
+    }
+    if (idsIndexed && (Mask(i) & kID)) {
+        idIndex.RemoveLast(i, ID(i));
+    }
+    std::uint8_t mask = Mask(i) & indexedFields;
+    if (mask & kName) nameIndex.RemoveLast(i, Name(i));
+    if (mask & kPublisher) publisherIndex.RemoveLast(i, Publisher(i));
+    if (mask & kYear) yearIndex.RemoveLast(i, Year(i));
+    if (mask & kRating) ratingOrder.RemoveLast(i, Rating(i));
+    for (std::size_t k = 0; (mask & kAuthor) && k < AuthorCount(i); ++k) authorIndex.RemoveLast(i, Author(i, k));
+}
+
+void LiteratureStore::RebuildIndexes() {
+    if (ratingsIndexed) {
+        ratingIndex.Build(ratings.data(), ratings.size());
+    }
+    if (idsWanted) {
+        idsIndexed = false;
+        IndexIDs();
+    }
+    std::uint8_t fields = indexedFields;
+    IndexFields(0);
+    IndexFields(fields);
+}
+
+std::vector<bool> LiteratureStore::Match(const std::string& field, const std::string& value) const {
+    return RecordPredicate::Equals(field, value).Evaluate(*this);
+}
+
+std::size_t LiteratureStore::Delete(const std::vector<std::size_t>& positions) {
+    std::size_t marked = 0;
+    for (std::size_t i : positions) {
+        if (i < Size() && Live(i)) {
+            masks[i] |= kDeleted;
+            ++marked;
+        }
+    }
+    deleted += marked;
+    return marked;
+}
+
+std::size_t LiteratureStore::Compact() {
+    return deleted == 0 ? 0 : Erase(std::vector<bool>(Size(), false));
+}
+
+void LiteratureStore::DropDeleted(std::vector<std::size_t>& positions) const {
+    if (deleted > 0) {
+        positions.erase(std::remove_if(positions.begin(), positions.end(),
+                                       [this](std::size_t i) { return !Live(i); }),
+                        positions.end());
+    }
+}
+
+std::size_t LiteratureStore::Erase(const std::vector<bool>& flagged) {
+    // Deleted records go with the flagged ones
+    std::vector<bool> remove = flagged;
+    for (std::size_t i = 0; deleted > 0 && i < Size(); ++i) {
+        if (!Live(i)) remove[i] = true;
+    }
+    std::vector<bool> removeAuthors(authors.Size(), false);
+    std::size_t write = 0;
+
+    for (std::size_t i = 0; i < Size(); ++i) {
+        if (remove[i]) {
+            for (std::uint64_t k = authorStarts[i]; k < authorStarts[i + 1]; ++k) {
+                removeAuthors[k] = true;
+            }
+            continue;
+        }
+        masks[write] = masks[i];
+        years[write] = years[i];
+        ratings[write] = ratings[i];
+        authorStarts[write + 1] = authorStarts[write] + (authorStarts[i + 1] - authorStarts[i]);
+        ++write;
+    }
+
+    std::size_t removed = Size() - write;
+    if (removed == 0) {
+        return 0;
+    }
+    deleted = 0;
+
+    masks.resize(write);
+    years.resize(write);
+    ratings.resize(write);
+    authorStarts.resize(write + 1);
+    names.Erase(remove);
+    publishers.Erase(remove);
+    ids.Erase(remove);
+    authors.Erase(removeAuthors);
+    // Positions after the first removal shift; rebuilding is as cheap as the compaction
+    RebuildIndexes();
+
+    return removed;
+}
+
+std::size_t LiteratureStore::MemoryUsage() const {
+    return masks.capacity() * sizeof(std::uint8_t) +
+           years.capacity() * sizeof(int) +
+           ratings.capacity() * sizeof(double) +
+           authorStarts.capacity() * sizeof(std::uint64_t) +
+           names.MemoryUsage() + publishers.MemoryUsage() +
+           ids.MemoryUsage() + authors.MemoryUsage() + ratingIndex.MemoryUsage() +
+           idIndex.MemoryUsage() + IndexMemoryUsage();
+}
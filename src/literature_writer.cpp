@@ -0,0 +1,184 @@
+#include "../inc/literature_writer.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace {
+
+void WriteBigEndian(std::ostream& out, std::uint64_t value, int bytes) {
+    for (int shift = (bytes - 1) * 8; shift >= 0; shift -= 8) {
+        out.put(static_cast<char>((value >> shift) & 0xff));
+    }
+}
+
+void WriteArrayHeader(std::ostream& out, std::uint64_t count, DataFormat format) {
+    if (format == DataFormat::Cbor) {
+        if (count < 24) {
+            out.put(static_cast<char>(0x80 | count));
+        } else if (count <= 0xff) {
+            out.put(static_cast<char>(0x98));
+            WriteBigEndian(out, count, 1);
+        } else if (count <= 0xffff) {
+            out.put(static_cast<char>(0x99));
+            WriteBigEndian(out, count, 2);
+        } else if (count <= 0xffffffffULL) {
+            out.put(static_cast<char>(0x9a));
+            WriteBigEndian(out, count, 4);
+        } else {
+            out.put(static_cast<char>(0x9b));
+            WriteBigEndian(out, count, 8);
+        }
+    } else if (format == DataFormat::MessagePack) {
+        if (count < 16) {
+            out.put(static_cast<char>(0x90 | count));
+        } else if (count <= 0xffff) {
+            out.put(static_cast<char>(0xdc));
+            WriteBigEndian(out, count, 2);
+        } else {
+            out.put(static_cast<char>(0xdd));
+            WriteBigEndian(out, count, 4);
+        }
+    } else {
+        // UBJSON: '[' '#' followed by the smallest integer type holding the count
+        out << "[#";
+        if (count <= 0x7f) {
+            out.put('i');
+            WriteBigEndian(out, count, 1);
+        } else if (count <= 0xff) {
+            out.put('U');
+            WriteBigEndian(out, count, 1);
+        } else if (count <= 0x7fff) {
+            out.put('I');
+            WriteBigEndian(out, count, 2);
+        } else if (count <= 0x7fffffffULL) {
+            out.put('l');
+            WriteBigEndian(out, count, 4);
+        } else {
+            out.put('L');
+            WriteBigEndian(out, count, 8);
+        }
+    }
+}
+
+// Pretty-printed records of a JSON array, separated by ",\n"
+void WriteJsonRecords(std::ostream& out, const LiteratureStore& store, bool first) {
+    std::string text;
+    for (std::size_t i = 0; i < store.Size(); ++i) {
+        if (!store.Live(i)) {
+            continue;
+        }
+        if (!first) {
+            out << ",\n";
+        }
+        first = false;
+        // Indent the pretty-printed record by one level
+        text = store.RecordToJson(i).dump(4);
+        std::size_t start = 0;
+        out << "    ";
+        for (std::size_t newline = text.find('\n'); newline != std::string::npos;
+             newline = text.find('\n', start)) {
+            out.write(text.data() + start, static_cast<std::streamsize>(newline + 1 - start));
+            out << "    ";
+            start = newline + 1;
+        }
+        out.write(text.data() + start, static_cast<std::streamsize>(text.size() - start));
+    }
+}
+
+void WriteBinaryRecords(std::ostream& out, const LiteratureStore& store, DataFormat format) {
+    std::vector<std::uint8_t> bytes;
+    for (std::size_t i = 0; i < store.Size(); ++i) {
+        if (!store.Live(i)) {
+            continue;
+        }
+        bytes.clear();
+        json record = store.RecordToJson(i);
+        if (format == DataFormat::Cbor) {
+            json::to_cbor(record, bytes);
+        } else if (format == DataFormat::MessagePack) {
+            json::to_msgpack(record, bytes);
+        } else {
+            json::to_ubjson(record, bytes, true);
+        }
+        out.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    }
+}
+
+} // namespace
+
+void WriteLiteratureJson(std::ostream& out, const LiteratureStore& store) {
+    WriteLiteratureHeader(out, store.Count(), DataFormat::Json);
+    WriteJsonRecords(out, store, true);
+    out << (store.Empty() ? "]" : "\n]");
+}
+
+void WriteLiteratureBinary(std::ostream& out, const LiteratureStore& store, DataFormat format) {
+    WriteArrayHeader(out, store.Count(), format);
+    WriteBinaryRecords(out, store, format);
+}
+
+void WriteLiterature(std::ostream& out, const LiteratureStore& store, DataFormat format) {
+    switch (format) {
+        case DataFormat::NDJSON:
+            WriteLiteratureLines(out, store);
+            break;
+        case DataFormat::Cbor:
+        case DataFormat::MessagePack:
+        case DataFormat::Ubjson:
+            WriteLiteratureBinary(out, store, format);
+            break;
+        default:
+            WriteLiteratureJson(out, store);
+            out << std::endl;
+            break;
+    }
+}
+
+void WriteLiteratureLines(std::ostream& out, const LiteratureStore& store, std::size_t first) {
+    std::string line;
+    for (std::size_t i = first; i < store.Size(); ++i) {
+        if (!store.Live(i)) {
+            continue;
+        }
+        line = store.RecordToJson(i).dump();
+        line += '\n';
+        out.write(line.data(), static_cast<std::streamsize>(line.size()));
+    }
+}
+
+void WriteLiteratureHeader(std::ostream& out, std::uint64_t count, DataFormat format) {
+    switch (format) {
+        case DataFormat::NDJSON:
+            break;
+        case DataFormat::Cbor:
+        case DataFormat::MessagePack:
+        case DataFormat::Ubjson:
+            WriteArrayHeader(out, count, format);
+            break;
+        default:
+            out << (count == 0 ? "[" : "[\n");
+            break;
+    }
+}
+
+void WriteLiteratureRecords(std::ostream& out, const LiteratureStore& store, DataFormat format, bool first) {
+    switch (format) {
+        case DataFormat::NDJSON:
+            WriteLiteratureLines(out, store);
+            break;
+        case DataFormat::Cbor:
+        case DataFormat::MessagePack:
+        case DataFormat::Ubjson:
+            WriteBinaryRecords(out, store, format);
+            break;
+        default:
+            WriteJsonRecords(out, store, first);
+            break;
+    }
+}
+
+void WriteLiteratureFooter(std::ostream& out, std::uint64_t count, DataFormat format) {
+    if (format == DataFormat::Json || format == DataFormat::Auto) {
+        out << (count == 0 ? "]" : "\n]") << '\n';
+    }
+}
@@ -0,0 +1,228 @@
+#include "../inc/logger.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+
+bool ParseLogLevel(const std::string& name, LogLevel& level) {
+    std::string lower(name);
+    std::transform(lower.begin(), lower.end(), lower.begin(), [](unsigned char c) { return std::tolower(c); });
+    if (lower == "debug") {
+        level = LogLevel::Debug;
+    } else if (lower == "info") {
+        level = LogLevel::Info;
+    } else if (lower == "warning" || lower == "warn") {
+        level = LogLevel::Warning;
+    } else if (lower == "error") {
+        level = LogLevel::Error;
+    } else if (lower == "off" || lower == "none") {
+        level = LogLevel::Off;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+const char* LogLevelName(LogLevel level) {
+    switch (level) {
+        case LogLevel::Debug: return "DEBUG";
+        case LogLevel::Info: return "INFO";
+        case LogLevel::Warning: return "WARNING";
+        case LogLevel::Error: return "ERROR";
+        default: return "OFF";
+    }
+}
+
+void Logger::Text::Append(std::string_view part) {
+    std::size_t room = kMessageBytes - Length;
+    if (part.size() > room) {
+        Truncated = true;
+    }
+    std::size_t bytes = std::min(part.size(), room);
+    std::memcpy(Data + Length, part.data(), bytes);
+    Length += bytes;
+}
+
+void Logger::Text::Append(double part) {
+    // Six significant digits, as `std::cout << part` prints it
+    char digits[32];
+    Append(std::string_view(digits, std::to_chars(digits, digits + sizeof(digits), part,
+                                                  std::chars_format::general, 6).ptr - digits));
+}
+
+Logger::Logger(std::ostream& output, std::ostream& errors, std::size_t capacity, std::chrono::milliseconds period)
+    : out(output), err(errors), interval(period) {
+    std::size_t size = 2;
+    while (size < capacity) {
+        size <<= 1;
+    }
+    slots = std::make_unique<Slot[]>(size);
+    mask = size - 1;
+    for (std::size_t i = 0; i < size; ++i) {
+        slots[i].Sequence.store(i, std::memory_order_relaxed);
+    }
+    flusher = std::thread(&Logger::FlushLoop, this);
+}
+
+Logger::~Logger() {
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        stopping = true;
+    }
+    wake.notify_one();
+    flusher.join();
+    Flush();
+}
+
+Logger& Logger::Shared() {
+    // Never destroyed: objects destroyed at exit may still log. What is
+    // queued when exit() runs is written by the handler registered here
+    static Logger* logger = []() {
+        Logger* shared = new Logger();
+        std::atexit([]() { Shared().Flush(); });
+        return shared;
+    }();
+    return *logger;
+}
+
+bool Logger::Admit(LogLevel level) {
+    std::size_t limit = rateLimit.load(std::memory_order_relaxed);
+    if (limit == 0 || level >= LogLevel::Error) {
+        return true;
+    }
+    // Fixed one-second windows; a race at the boundary only lets a few more through
+    std::int64_t second = std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+    std::int64_t window = windowSecond.load(std::memory_order_relaxed);
+    if (window != second && windowSecond.compare_exchange_strong(window, second, std::memory_order_relaxed)) {
+        windowCount.store(0, std::memory_order_relaxed);
+    }
+    if (windowCount.fetch_add(1, std::memory_order_relaxed) >= limit) {
+        suppressed.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    return true;
+}
+
+Logger::Slot* Logger::Claim(LogLevel level) {
+    if (!Enabled(level) || !Admit(level)) {
+        return nullptr;
+    }
+    // Bounded MPMC queue (per-slot sequence numbers): a slot is free for
+    // position p when its sequence equals p
+    std::uint64_t position = tail.load(std::memory_order_relaxed);
+    while (true) {
+        Slot& slot = slots[position & mask];
+        std::uint64_t sequence = slot.Sequence.load(std::memory_order_acquire);
+        if (sequence == position) {
+            if (tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                slot.Level = level;
+                slot.Time = std::chrono::duration_cast<std::chrono::milliseconds>(
+                    std::chrono::system_clock::now().time_since_epoch()).count();
+                return &slot;
+            }
+        } else if (sequence < position) {
+            // Still holds the message logged one lap ago: full
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        } else {
+            position = tail.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+void Logger::Publish(Slot* slot) {
+    std::uint64_t position = slot->Sequence.load(std::memory_order_relaxed);
+    slot->Sequence.store(position + 1, std::memory_order_release);
+    // Wake the writer every half buffer so bursts are drained before it
+    // fills; notifying without the mutex keeps producers lock-free
+    if ((position & (mask >> 1)) == 0) {
+        wake.notify_one();
+    }
+}
+
+void Logger::Drain() {
+    // Lines are batched per destination and each batch is written and flushed once
+    std::string batch;
+    std::ostream* target = nullptr;
+    auto line = [&](std::ostream& stream, LogLevel level, std::int64_t time, std::string_view text) {
+        if (target != &stream && !batch.empty()) {
+            target->write(batch.data(), static_cast<std::streamsize>(batch.size()));
+            target->flush();
+            batch.clear();
+        }
+        target = &stream;
+        if (decorate.load(std::memory_order_relaxed)) {
+            std::time_t seconds = static_cast<std::time_t>(time / 1000);
+            char stamp[40];
+            std::size_t length = std::strftime(stamp, sizeof(stamp), "%Y-%m-%dT%H:%M:%S", std::gmtime(&seconds));
+            length += std::snprintf(stamp + length, sizeof(stamp) - length, ".%03dZ ", static_cast<int>(time % 1000));
+            batch.append(stamp, length);
+            batch += LogLevelName(level);
+            batch += ' ';
+        }
+        batch.append(text.data(), text.size());
+        batch += '\n';
+    };
+
+    while (true) {
+        Slot& slot = slots[head & mask];
+        if (slot.Sequence.load(std::memory_order_acquire) != head + 1) {
+            break;
+        }
+        line(slot.Level >= LogLevel::Warning ? err : out, slot.Level, slot.Time,
+             std::string_view(slot.Text, slot.Length));
+        slot.Sequence.store(head + mask + 1, std::memory_order_release);
+        ++head;
+    }
+
+    std::int64_t now = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    std::uint64_t lost = dropped.load(std::memory_order_relaxed);
+    if (lost != reportedDropped) {
+        line(err, LogLevel::Warning, now, "Logger: " + std::to_string(lost - reportedDropped) +
+                                              " messages dropped, buffer full");
+        reportedDropped = lost;
+    }
+    std::uint64_t limited = suppressed.load(std::memory_order_relaxed);
+    if (limited != reportedSuppressed) {
+        line(err, LogLevel::Warning, now, "Logger: " + std::to_string(limited - reportedSuppressed) +
+                                              " messages suppressed by the rate limit");
+        reportedSuppressed = limited;
+    }
+
+    if (!batch.empty()) {
+        target->write(batch.data(), static_cast<std::streamsize>(batch.size()));
+        target->flush();
+    }
+}
+
+void Logger::Flush() {
+    // Messages claimed before the call; a writer may still be filling one
+    std::uint64_t target = tail.load(std::memory_order_acquire);
+    while (true) {
+        {
+            std::lock_guard<std::mutex> lock(drainMutex);
+            Drain();
+            if (head >= target) {
+                return;
+            }
+        }
+        std::this_thread::yield();
+    }
+}
+
+void Logger::FlushLoop() {
+    std::unique_lock<std::mutex> lock(wakeMutex);
+    while (!stopping) {
+        // Woken by the period, by producers or by the destructor
+        wake.wait_for(lock, interval);
+        lock.unlock();
+        {
+            std::lock_guard<std::mutex> drain(drainMutex);
+            Drain();
+        }
+        lock.lock();
+    }
+}
@@ -1,4 +1,5 @@
 #include "../inc/task.h"
+#include "../inc/logger.h"
 #include <iostream>
 #include <string>
 
@@ -14,6 +15,10 @@ void printMenu() {
     std::cout << "8. Save data to file" << std::endl;
     std::cout << "9. Validate ID" << std::endl;
     std::cout << "10. Get item by ID" << std::endl;
+    std::cout << "11. Append data to NDJSON file" << std::endl;
+    std::cout << "12. Save snapshot" << std::endl;
+    std::cout << "13. Open snapshot" << std::endl;
+    std::cout << "14. Generate workload from spec file" << std::endl;
     std::cout << "0. Exit" << std::endl;
     std::cout << "================================" << std::endl;
     std::cout << "Enter your choice: ";
@@ -28,6 +33,8 @@ int main() {
     std::cout << "Welcome to JSON Data Handler!" << std::endl;
 
     while (true) {
+        // Results of the last command are logged asynchronously; show them before the menu
+        Logger::Shared().Flush();
         printMenu();
         std::cin >> choice;
 
@@ -111,6 +118,41 @@ int main() {
                 }
                 break;
 
+            case 11:
+                std::cout << "Enter NDJSON file to append to: ";
+                std::cin >> filename;
+                handler.SaveToFile(filename, DataFormat::NDJSON, true);
+                break;
+
+            case 12:
+                std::cout << "Enter snapshot file to save (e.g. data.lsnap): ";
+                std::cin >> filename;
+                handler.SaveSnapshot(filename);
+                break;
+
+            case 13:
+                std::cout << "Enter snapshot file to open: ";
+                std::cin >> filename;
+                handler.LoadSnapshot(filename);
+                break;
+
+            case 14: {
+                std::cout << "Enter workload spec file (- for defaults): ";
+                std::cin >> filename;
+                std::cout << "Enter number of items to generate: ";
+                std::cin >> count;
+                WorkloadSpec spec;
+                std::string error;
+                if (filename != "-" && !WorkloadSpec::Load(filename, spec, error)) {
+                    std::cout << "Error: " << error << std::endl;
+                } else if (count > 0) {
+                    handler.GenerateWorkload(spec, count);
+                } else {
+                    std::cout << "Invalid count." << std::endl;
+                }
+                break;
+            }
+
             case 0:
                 std::cout << "Exiting... Goodbye!" << std::endl;
                 return 0;
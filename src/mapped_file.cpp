@@ -0,0 +1,128 @@
+#include "../inc/mapped_file.h"
+#include <fstream>
+#include <iterator>
+#include <utility>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::~MappedFile() {
+    Close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept {
+    *this = std::move(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        Close();
+        mapping = std::exchange(other.mapping, nullptr);
+        buffer = std::move(other.buffer);
+        size = std::exchange(other.size, 0);
+        isOpen = std::exchange(other.isOpen, false);
+        data = mapping ? std::exchange(other.data, nullptr) : buffer.data();
+        other.data = nullptr;
+    }
+    return *this;
+}
+
+bool MappedFile::Open(const std::string& filename, Access access) {
+    Close();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              access == Access::Sequential ? FILE_FLAG_SEQUENTIAL_SCAN : FILE_FLAG_RANDOM_ACCESS,
+                              nullptr);
+    if (file != INVALID_HANDLE_VALUE) {
+        LARGE_INTEGER fileSize;
+        if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart == 0) {
+            CloseHandle(file);
+            isOpen = true;
+            return true;
+        }
+        HANDLE view = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (view != nullptr) {
+            mapping = MapViewOfFile(view, FILE_MAP_READ, 0, 0, 0);
+            CloseHandle(view);
+        }
+        CloseHandle(file);
+        if (mapping != nullptr) {
+            data = static_cast<const char*>(mapping);
+            size = static_cast<std::size_t>(fileSize.QuadPart);
+            isOpen = true;
+            return true;
+        }
+    }
+#else
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) == 0 && S_ISREG(info.st_mode)) {
+        if (info.st_size == 0) {
+            ::close(fd);
+            isOpen = true;
+            return true;
+        }
+
+        void* address = mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        if (address != MAP_FAILED) {
+            mapping = address;
+            data = static_cast<const char*>(address);
+            size = static_cast<std::size_t>(info.st_size);
+
+            // Hints only: failures are harmless
+            if (access == Access::Sequential) {
+                madvise(address, size, MADV_SEQUENTIAL);
+                madvise(address, size, MADV_WILLNEED);
+#ifdef MADV_HUGEPAGE
+                madvise(address, size, MADV_HUGEPAGE);
+#endif
+            } else {
+                madvise(address, size, MADV_RANDOM);
+            }
+
+            ::close(fd);
+            isOpen = true;
+            return true;
+        }
+    }
+    ::close(fd);
+#endif
+
+    // Not mappable (pipe, device, ...): fall back to reading the whole file
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    buffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    data = buffer.data();
+    size = buffer.size();
+    isOpen = true;
+    return true;
+}
+
+void MappedFile::Close() {
+    if (mapping != nullptr) {
+#ifdef _WIN32
+        UnmapViewOfFile(mapping);
+#else
+        munmap(mapping, size);
+#endif
+        mapping = nullptr;
+    }
+    buffer.clear();
+    buffer.shrink_to_fit();
+    data = nullptr;
+    size = 0;
+    isOpen = false;
+}
@@ -0,0 +1,93 @@
+#include "../inc/rating_index.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+int RatingIndex::Bucket(double rating) {
+    if (!(rating >= 0.0 && rating <= 10.0)) {
+        return -1;
+    }
+    // 7.3 parsed from text and std::round(x * 10) / 10 give the same double
+    // as 73 / 10.0, so only exact tenths land in a bucket
+    int bucket = static_cast<int>(std::lround(rating * 10.0));
+    return static_cast<double>(bucket) / 10.0 == rating ? bucket : -1;
+}
+
+void RatingIndex::Clear() {
+    for (auto& bucket : buckets) {
+        bucket.clear();
+    }
+    offGrid = 0;
+    records = 0;
+}
+
+void RatingIndex::Add(std::size_t record, double rating) {
+    int bucket = Bucket(rating);
+    if (bucket < 0 || record > std::numeric_limits<std::uint32_t>::max()) {
+        ++offGrid;
+    } else {
+        buckets[bucket].push_back(static_cast<std::uint32_t>(record));
+    }
+    ++records;
+}
+
+void RatingIndex::RemoveLast(double rating) {
+    int bucket = Bucket(rating);
+    if (bucket >= 0 && !buckets[bucket].empty() && buckets[bucket].back() == records - 1) {
+        buckets[bucket].pop_back();
+    } else {
+        --offGrid;
+    }
+    --records;
+}
+
+void RatingIndex::Build(const double* ratings, std::size_t count) {
+    // Count first so that every bucket is allocated once
+    std::size_t counts[kBuckets] = {};
+    for (std::size_t i = 0; i < count; ++i) {
+        int bucket = Bucket(ratings[i]);
+        if (bucket >= 0) ++counts[bucket];
+    }
+    Clear();
+    for (int b = 0; b < kBuckets; ++b) {
+        buckets[b].reserve(counts[b]);
+    }
+    for (std::size_t i = 0; i < count; ++i) {
+        Add(i, ratings[i]);
+    }
+}
+
+void RatingIndex::Band(std::size_t lowCount, std::size_t topCount, std::vector<std::size_t>& indices) const {
+    indices.clear();
+    indices.reserve(lowCount + topCount);
+
+    for (int b = 0; b < kBuckets && indices.size() < lowCount; ++b) {
+        std::size_t take = std::min(buckets[b].size(), lowCount - indices.size());
+        indices.insert(indices.end(), buckets[b].begin(), buckets[b].begin() + static_cast<std::ptrdiff_t>(take));
+    }
+
+    // The top band starts inside the highest bucket that is needed
+    std::size_t remaining = topCount;
+    int first = kBuckets;
+    while (remaining > 0 && first > 0) {
+        --first;
+        if (buckets[first].size() >= remaining) {
+            const auto& bucket = buckets[first];
+            indices.insert(indices.end(), bucket.end() - static_cast<std::ptrdiff_t>(remaining), bucket.end());
+            remaining = 0;
+        } else {
+            remaining -= buckets[first].size();
+        }
+    }
+    for (int b = first + 1; b < kBuckets; ++b) {
+        indices.insert(indices.end(), buckets[b].begin(), buckets[b].end());
+    }
+}
+
+std::size_t RatingIndex::MemoryUsage() const {
+    std::size_t bytes = 0;
+    for (const auto& bucket : buckets) {
+        bytes += bucket.capacity() * sizeof(std::uint32_t);
+    }
+    return bytes;
+}
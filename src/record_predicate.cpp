@@ -0,0 +1,599 @@
+#include "../inc/record_predicate.h"
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cfloat>
+#include <climits>
+#include <cmath>
+#include <cstdlib>
+#include <iterator>
+#include <string_view>
+#include <utility>
+
+namespace {
+
+const double kRatingTolerance = 0.001;
+
+bool ParseInt(const std::string& text, int& value) {
+    if (text.empty()) {
+        return false;
+    }
+    char* end = nullptr;
+    errno = 0;
+    long parsed = std::strtol(text.c_str(), &end, 10);
+    if (errno != 0 || *end != '\0' || parsed < INT_MIN || parsed > INT_MAX) {
+        return false;
+    }
+    value = static_cast<int>(parsed);
+    return true;
+}
+
+bool ParseReal(const std::string& text, double& value) {
+    if (text.empty()) {
+        return false;
+    }
+    char* end = nullptr;
+    double parsed = std::strtod(text.c_str(), &end);
+    if (*end != '\0' || !std::isfinite(parsed)) {
+        return false;
+    }
+    value = parsed;
+    return true;
+}
+
+bool SameWord(const std::string& word, const char* keyword) {
+    std::size_t i = 0;
+    for (; keyword[i] != '\0'; ++i) {
+        if (i >= word.size() || std::toupper(static_cast<unsigned char>(word[i])) != keyword[i]) {
+            return false;
+        }
+    }
+    return i == word.size();
+}
+
+// Ordered comparison shared by the integer and string columns
+template <typename T>
+bool CompareOrdered(RecordPredicate::Op op, const T& value, const T& low, const T& high) {
+    switch (op) {
+        case RecordPredicate::Op::Equal: return value == low;
+        case RecordPredicate::Op::NotEqual: return value != low;
+        case RecordPredicate::Op::Less: return value < low;
+        case RecordPredicate::Op::LessEqual: return value <= low;
+        case RecordPredicate::Op::Greater: return value > low;
+        case RecordPredicate::Op::GreaterEqual: return value >= low;
+        case RecordPredicate::Op::Between: return low <= value && value <= high;
+    }
+    return false;
+}
+
+// Ratings within the tolerance of a literal count as equal to it
+bool CompareRating(RecordPredicate::Op op, double value, double low, double high) {
+    bool equal = std::abs(value - low) < kRatingTolerance;
+    switch (op) {
+        case RecordPredicate::Op::Equal: return equal;
+        case RecordPredicate::Op::NotEqual: return !equal;
+        case RecordPredicate::Op::Less: return value < low && !equal;
+        case RecordPredicate::Op::LessEqual: return value < low || equal;
+        case RecordPredicate::Op::Greater: return value > low && !equal;
+        case RecordPredicate::Op::GreaterEqual: return value > low || equal;
+        case RecordPredicate::Op::Between:
+            return value > low - kRatingTolerance && value < high + kRatingTolerance;
+    }
+    return false;
+}
+
+// Runs test over the records still flagged (all records unless narrow)
+template <typename Test>
+void Scan(std::vector<std::uint8_t>& flags, bool narrow, Test test) {
+    const std::size_t n = flags.size();
+    if (narrow) {
+        for (std::size_t i = 0; i < n; ++i) {
+            if (flags[i]) flags[i] = test(i);
+        }
+    } else {
+        for (std::size_t i = 0; i < n; ++i) {
+            flags[i] = test(i);
+        }
+    }
+}
+
+} // namespace
+
+/**
+ * @brief Recursive-descent parser producing the node list of a predicate
+ */
+class RecordPredicate::Parser {
+public:
+    Parser(const std::string& condition, std::vector<Node>& output, std::string& message)
+        : text(condition), nodes(output), error(message) {}
+
+    bool Run() {
+        Next();
+        std::size_t root;
+        if (!ParseOr(root)) {
+            return false;
+        }
+        if (token != Token::End) {
+            return Fail("Unexpected '" + word + "'");
+        }
+        return true;
+    }
+
+private:
+    enum class Token { End, Word, Quoted, Operator, Open, Close };
+
+    bool Fail(const std::string& message) {
+        if (error.empty()) {
+            error = message + " at position " + std::to_string(start);
+        }
+        return false;
+    }
+
+    void Next() {
+        while (position < text.size() && std::isspace(static_cast<unsigned char>(text[position]))) {
+            ++position;
+        }
+        start = position;
+        word.clear();
+        if (position == text.size()) {
+            token = Token::End;
+            return;
+        }
+        char c = text[position];
+        if (c == '(' || c == ')') {
+            token = c == '(' ? Token::Open : Token::Close;
+            word = c;
+            ++position;
+        } else if (c == '"' || c == '\'') {
+            std::size_t close = text.find(c, position + 1);
+            token = Token::Quoted;
+            if (close == std::string::npos) {
+                unterminated = true;
+                close = text.size();
+            }
+            word = text.substr(position + 1, close - position - 1);
+            position = std::min(close + 1, text.size());
+        } else if (c == '=' || c == '!' || c == '<' || c == '>' || c == '&' || c == '|') {
+            token = Token::Operator;
+            word = c;
+            ++position;
+            if (position < text.size() && (text[position] == '=' || (text[position] == c && (c == '&' || c == '|')))) {
+                word += text[position++];
+            }
+        } else {
+            token = Token::Word;
+            while (position < text.size() && !std::isspace(static_cast<unsigned char>(text[position])) &&
+                   std::string_view("()\"'=!<>&|").find(text[position]) == std::string_view::npos) {
+                word += text[position++];
+            }
+        }
+    }
+
+    bool AtKeyword(const char* keyword, const char* symbol) const {
+        return (token == Token::Word && SameWord(word, keyword)) || (token == Token::Operator && word == symbol);
+    }
+
+    // Joins the operands of a chain of one connective under a single node
+    bool ParseChain(Kind kind, const char* keyword, const char* symbol, bool (Parser::*operand)(std::size_t&),
+                    std::size_t& index) {
+        std::size_t first;
+        if (!(this->*operand)(first)) {
+            return false;
+        }
+        if (!AtKeyword(keyword, symbol)) {
+            index = first;
+            return true;
+        }
+        Node chain;
+        chain.Type = kind;
+        chain.Children.push_back(first);
+        while (AtKeyword(keyword, symbol)) {
+            Next();
+            std::size_t child;
+            if (!(this->*operand)(child)) {
+                return false;
+            }
+            chain.Children.push_back(child);
+        }
+        nodes.push_back(std::move(chain));
+        index = nodes.size() - 1;
+        return true;
+    }
+
+    bool ParseOr(std::size_t& index) { return ParseChain(Kind::Or, "OR", "||", &Parser::ParseAnd, index); }
+    bool ParseAnd(std::size_t& index) { return ParseChain(Kind::And, "AND", "&&", &Parser::ParsePrimary, index); }
+
+    bool ParseValue(std::string& value) {
+        if (unterminated) {
+            return Fail("Unterminated string");
+        }
+        if (token != Token::Word && token != Token::Quoted) {
+            return Fail("Expected a value");
+        }
+        value = word;
+        Next();
+        return true;
+    }
+
+    bool ParsePrimary(std::size_t& index) {
+        if (token == Token::Open) {
+            // Parsing and evaluation recurse once per level
+            if (++depth > kMaxNesting) {
+                return Fail("Parentheses nested deeper than " + std::to_string(kMaxNesting));
+            }
+            Next();
+            if (!ParseOr(index)) {
+                return false;
+            }
+            --depth;
+            if (token != Token::Close) {
+                return Fail("Expected ')'");
+            }
+            Next();
+            return true;
+        }
+        if (token != Token::Word) {
+            return Fail("Expected a field name");
+        }
+        std::string field = word;
+        Next();
+
+        Op op;
+        std::string low, high;
+        if (token == Token::Word && SameWord(word, "BETWEEN")) {
+            op = Op::Between;
+            Next();
+            if (!ParseValue(low)) {
+                return false;
+            }
+            if (!AtKeyword("AND", "&&")) {
+                return Fail("Expected AND in BETWEEN");
+            }
+            Next();
+            if (!ParseValue(high)) {
+                return false;
+            }
+        } else {
+            if (token != Token::Operator) {
+                return Fail("Expected an operator after " + field);
+            }
+            if (word == "=" || word == "==") op = Op::Equal;
+            else if (word == "!=") op = Op::NotEqual;
+            else if (word == "<") op = Op::Less;
+            else if (word == "<=") op = Op::LessEqual;
+            else if (word == ">") op = Op::Greater;
+            else if (word == ">=") op = Op::GreaterEqual;
+            else return Fail("Unknown operator '" + word + "'");
+            Next();
+            if (!ParseValue(low)) {
+                return false;
+            }
+        }
+
+        Node node;
+        std::string message;
+        if (!MakeCompare(field, op, low, high, node, message)) {
+            return Fail(message);
+        }
+        nodes.push_back(std::move(node));
+        index = nodes.size() - 1;
+        return true;
+    }
+
+    const std::string& text;
+    std::vector<Node>& nodes;
+    std::string& error;
+    std::size_t position = 0;
+    std::size_t start = 0;
+    Token token = Token::End;
+    std::string word;
+    bool unterminated = false;
+    std::size_t depth = 0;  // Open parentheses around the current token
+};
+
+RecordPredicate::RecordPredicate() {}
+
+bool RecordPredicate::MakeCompare(const std::string& field, Op op, const std::string& low, const std::string& high,
+                                  Node& node, std::string& error) {
+    node.Type = Kind::Compare;
+    node.Operator = op;
+    const bool range = op == Op::Between;
+    if (field == "Year") {
+        node.Field = Column::Year;
+        if (!ParseInt(low, node.IntLow) || (range && !ParseInt(high, node.IntHigh))) {
+            error = "Year needs an integer";
+            return false;
+        }
+    } else if (field == "Rating") {
+        node.Field = Column::Rating;
+        if (!ParseReal(low, node.RealLow) || (range && !ParseReal(high, node.RealHigh))) {
+            error = "Rating needs a number";
+            return false;
+        }
+    } else if (field == "Name" || field == "Publisher" || field == "ID" || field == "Author") {
+        node.Field = field == "Name" ? Column::Name : field == "Publisher" ? Column::Publisher
+                   : field == "ID" ? Column::ID : Column::Author;
+        if (node.Field == Column::Author && op != Op::Equal && op != Op::NotEqual) {
+            error = "Author supports only = and !=";
+            return false;
+        }
+        node.TextLow = low;
+        node.TextHigh = high;
+    } else {
+        error = "Unknown field '" + field + "'";
+        return false;
+    }
+    return true;
+}
+
+bool RecordPredicate::Compile(const std::string& condition, RecordPredicate& predicate, std::string& error) {
+    std::vector<Node> nodes;
+    std::string message;
+    Parser parser(condition, nodes, message);
+    if (!parser.Run()) {
+        error = message;
+        return false;
+    }
+    predicate.nodes = std::move(nodes);
+    return true;
+}
+
+RecordPredicate RecordPredicate::Equals(const std::string& field, const std::string& value) {
+    RecordPredicate predicate;
+    Node node;
+    std::string error;
+    if (MakeCompare(field, Op::Equal, value, std::string(), node, error)) {
+        predicate.nodes.push_back(std::move(node));
+    }
+    return predicate;
+}
+
+RecordPredicate RecordPredicate::Authors(const std::vector<std::string>& authors) {
+    RecordPredicate predicate;
+    Node all;
+    all.Type = Kind::And;
+    for (const auto& author : authors) {
+        Node node;
+        node.Type = Kind::Compare;
+        node.Field = Column::Author;
+        node.TextLow = author;
+        predicate.nodes.push_back(std::move(node));
+        all.Children.push_back(predicate.nodes.size() - 1);
+    }
+    if (authors.size() > 1) {
+        predicate.nodes.push_back(std::move(all));
+    }
+    return predicate;
+}
+
+bool RecordPredicate::Test(const Node& node, const LiteratureStore& store, std::size_t i) const {
+    switch (node.Type) {
+        case Kind::None:
+            return false;
+        case Kind::And:
+            for (std::size_t child : node.Children) {
+                if (!Test(nodes[child], store, i)) return false;
+            }
+            return true;
+        case Kind::Or:
+            for (std::size_t child : node.Children) {
+                if (Test(nodes[child], store, i)) return true;
+            }
+            return false;
+        case Kind::Compare:
+            break;
+    }
+
+    switch (node.Field) {
+        case Column::Year:
+            return store.Has(i, LiteratureStore::kYear) &&
+                   CompareOrdered(node.Operator, store.Year(i), node.IntLow, node.IntHigh);
+        case Column::Rating:
+            return store.Has(i, LiteratureStore::kRating) &&
+                   CompareRating(node.Operator, store.Rating(i), node.RealLow, node.RealHigh);
+        case Column::Name:
+            return store.Has(i, LiteratureStore::kName) &&
+                   CompareOrdered(node.Operator, store.Name(i), std::string_view(node.TextLow),
+                                  std::string_view(node.TextHigh));
+        case Column::Publisher:
+            return store.Has(i, LiteratureStore::kPublisher) &&
+                   CompareOrdered(node.Operator, store.Publisher(i), std::string_view(node.TextLow),
+                                  std::string_view(node.TextHigh));
+        case Column::ID:
+            return store.Has(i, LiteratureStore::kID) &&
+                   CompareOrdered(node.Operator, store.ID(i), std::string_view(node.TextLow),
+                                  std::string_view(node.TextHigh));
+        case Column::Author: {
+            if (!store.Has(i, LiteratureStore::kAuthor)) {
+                return false;
+            }
+            bool found = false;
+            for (std::size_t k = 0; k < store.AuthorCount(i) && !found; ++k) {
+                found = store.Author(i, k) == node.TextLow;
+            }
+            return found == (node.Operator == Op::Equal);
+        }
+    }
+    return false;
+}
+
+bool RecordPredicate::Matches(const LiteratureStore& store, std::size_t i) const {
+    return !nodes.empty() && store.Live(i) && Test(nodes.back(), store, i);
+}
+
+void RecordPredicate::Apply(std::size_t index, const LiteratureStore& store, std::vector<std::uint8_t>& flags,
+                            bool narrow) const {
+    const Node& node = nodes[index];
+    if (node.Type == Kind::And) {
+        // Each operand only looks at the records the previous ones kept
+        for (std::size_t k = 0; k < node.Children.size(); ++k) {
+            Apply(node.Children[k], store, flags, narrow || k > 0);
+        }
+        return;
+    }
+    if (node.Type == Kind::Or) {
+        // Each operand only looks at the records no previous one matched
+        std::vector<std::uint8_t> matched(flags.size(), 0);
+        std::vector<std::uint8_t> pending(flags.size());
+        for (std::size_t child : node.Children) {
+            for (std::size_t i = 0; i < flags.size(); ++i) {
+                pending[i] = (!narrow || flags[i]) && !matched[i];
+            }
+            Apply(child, store, pending, true);
+            for (std::size_t i = 0; i < flags.size(); ++i) {
+                matched[i] |= pending[i];
+            }
+        }
+        flags.swap(matched);
+        return;
+    }
+
+    // Typed column scans; the constant operands were parsed by Compile()
+    const Op op = node.Operator;
+    switch (node.Field) {
+        case Column::Year: {
+            const int* years = store.Years().data();
+            Scan(flags, narrow, [&](std::size_t i) {
+                return store.Has(i, LiteratureStore::kYear) && CompareOrdered(op, years[i], node.IntLow, node.IntHigh);
+            });
+            break;
+        }
+        case Column::Rating: {
+            const double* ratings = store.Ratings().data();
+            Scan(flags, narrow, [&](std::size_t i) {
+                return store.Has(i, LiteratureStore::kRating) &&
+                       CompareRating(op, ratings[i], node.RealLow, node.RealHigh);
+            });
+            break;
+        }
+        default:
+            Scan(flags, narrow, [&](std::size_t i) { return Test(node, store, i); });
+            break;
+    }
+}
+
+bool RecordPredicate::Candidates(std::size_t index, const LiteratureStore& store,
+                                 std::vector<std::size_t>& positions) const {
+    const Node& node = nodes[index];
+    if (node.Type == Kind::And) {
+        // The smallest indexed operand seeds the result, the whole node filters it.
+        // Hash lookups come first: they are O(1) to try, while a range may
+        // collect far more candidates than the lookup would
+        bool found = false;
+        std::vector<std::size_t> operand;
+        std::vector<std::string> authors;
+        for (std::size_t child : node.Children) {
+            const Node& term = nodes[child];
+            if (term.Type == Kind::Compare && term.Field == Column::Author && term.Operator == Op::Equal) {
+                authors.push_back(term.TextLow);
+            }
+        }
+        // Several authors: the intersection of their posting lists is the seed
+        found = authors.size() > 1 && store.AuthorLookup(authors, positions);
+        for (int pass = 0; pass < 2 && !found; ++pass) {
+            for (std::size_t child : node.Children) {
+                const Node& term = nodes[child];
+                bool lookup = term.Type == Kind::Compare && term.Operator == Op::Equal &&
+                              (term.Field == Column::Name || term.Field == Column::Publisher ||
+                               term.Field == Column::Author);
+                if (lookup == (pass == 0) && Candidates(child, store, operand) &&
+                    (!found || operand.size() < positions.size())) {
+                    positions.swap(operand);
+                    found = true;
+                }
+            }
+        }
+        if (found) {
+            positions.erase(std::remove_if(positions.begin(), positions.end(),
+                                           [&](std::size_t i) { return !Test(node, store, i); }),
+                            positions.end());
+        }
+        return found;
+    }
+    if (node.Type == Kind::Or) {
+        std::vector<std::size_t> operand, merged;
+        positions.clear();
+        for (std::size_t child : node.Children) {
+            if (!Candidates(child, store, operand)) {
+                return false;
+            }
+            merged.clear();
+            std::set_union(positions.begin(), positions.end(), operand.begin(), operand.end(),
+                           std::back_inserter(merged));
+            positions.swap(merged);
+        }
+        return true;
+    }
+    if (node.Type != Kind::Compare || node.Operator == Op::NotEqual) {
+        return false;
+    }
+
+    const Op op = node.Operator;
+    switch (node.Field) {
+        case Column::Name:
+        case Column::Publisher:
+            return op == Op::Equal &&
+                   store.IndexLookup(node.Field == Column::Name ? LiteratureStore::kName : LiteratureStore::kPublisher,
+                                     node.TextLow, positions);
+        case Column::Author:
+            return op == Op::Equal && store.IndexLookup(LiteratureStore::kAuthor, node.TextLow, positions);
+        case Column::Year: {
+            double low = op == Op::Less || op == Op::LessEqual ? -DBL_MAX : node.IntLow;
+            double high = op == Op::Between ? node.IntHigh
+                        : op == Op::Greater || op == Op::GreaterEqual ? DBL_MAX : node.IntLow;
+            return store.IndexRange(LiteratureStore::kYear, low, high, [&](double year) {
+                return CompareOrdered(op, static_cast<int>(year), node.IntLow, node.IntHigh);
+            }, positions);
+        }
+        case Column::Rating: {
+            double low = op == Op::Less || op == Op::LessEqual ? -DBL_MAX : node.RealLow - kRatingTolerance;
+            double high = op == Op::Between ? node.RealHigh + kRatingTolerance
+                        : op == Op::Greater || op == Op::GreaterEqual ? DBL_MAX : node.RealLow + kRatingTolerance;
+            return store.IndexRange(LiteratureStore::kRating, low, high, [&](double rating) {
+                return CompareRating(op, rating, node.RealLow, node.RealHigh);
+            }, positions);
+        }
+        default:
+            return false;
+    }
+}
+
+std::vector<std::size_t> RecordPredicate::Find(const LiteratureStore& store) const {
+    std::vector<std::size_t> positions;
+    if (nodes.empty() || store.Empty() || Candidates(nodes.size() - 1, store, positions)) {
+        return positions;
+    }
+    positions.clear();  // A failed attempt may leave partial results
+    std::vector<bool> flags = Evaluate(store);
+    for (std::size_t i = 0; i < flags.size(); ++i) {
+        if (flags[i]) positions.push_back(i);
+    }
+    return positions;
+}
+
+std::vector<bool> RecordPredicate::Evaluate(const LiteratureStore& store) const {
+    std::vector<bool> result(store.Size(), false);
+    if (nodes.empty() || store.Empty()) {
+        return result;
+    }
+    if (store.IndexedFields() != 0) {
+        std::vector<std::size_t> positions;
+        if (Candidates(nodes.size() - 1, store, positions)) {
+            for (std::size_t i : positions) {
+                result[i] = true;
+            }
+            return result;
+        }
+    }
+    // Deleted records start rejected; narrowing keeps every comparison off them
+    std::vector<std::uint8_t> flags(store.Size(), 1);
+    const bool narrow = store.Deleted() > 0;
+    for (std::size_t i = 0; narrow && i < flags.size(); ++i) {
+        flags[i] = store.Live(i);
+    }
+    Apply(nodes.size() - 1, store, flags, narrow);
+    for (std::size_t i = 0; i < flags.size(); ++i) {
+        result[i] = flags[i] != 0;
+    }
+    return result;
+}
@@ -1,88 +1,123 @@
 #include "../inc/task.h"
+#include "../inc/literature_loader.h"
+#include "../inc/literature_writer.h"
+#include "../inc/literature_snapshot.h"
+#include "../inc/record_predicate.h"
+#include "../inc/literature_id.h"
+#include "../inc/literature_generator.h"
+#include "../inc/logger.h"
 #include <iostream>
 #include <fstream>
-#include <sstream>
 #include <algorithm>
 #include <random>
-#include <regex>
 #include <iomanip>
 #include <chrono>
 
-JSONHandler::JSONHandler() : idCounter(1) {
+JSONHandler::JSONHandler() : version(0), indexedFields(0), compactionRatio(kDefaultCompactionRatio),
+                             appendMark(0) {
     dataFilePath = "data.json";
 }
 
 JSONHandler::~JSONHandler() {}
 
-void JSONHandler::Input(const std::string& filename) {
-    std::ifstream file(filename);
-    if (!file.is_open()) {
-        std::cerr << "Error: Cannot open file " << filename << std::endl;
+void JSONHandler::Input(const std::string& filename, DataFormat format) {
+    LiteratureStore loaded;
+    LoadReport report;
+
+    if (!LoadLiteratureFile(filename, format, loaded, report)) {
+        Logger::Shared().Error("Error: Cannot open file ", filename);
         return;
     }
 
-    try {
-        file >> data;
-        std::cout << "Successfully loaded data from " << filename << std::endl;
-    } catch (const json::parse_error& e) {
-        std::cerr << "JSON parse error: " << e.what() << std::endl;
+    if (!report.Ok()) {
+        Logger::Shared().Error("JSON parse error: ", report.ParseError);
+    } else {
+        for (const auto& error : report.Errors) {
+            Logger::Shared().Warning("Skipped record ", error.Record, ": ", error.Message);
+        }
+        store = std::move(loaded);
+        store.IndexFields(indexedFields);
+        ids.Observe(store);
+        appendFile = filename;
+        appendMark = store.Size();
+        ++version;
+        if (report.Rejected > 0) {
+            Logger::Shared().Info("Successfully loaded ", report.Records, " items from ", filename, " (",
+                                  report.Rejected, " rejected)");
+        } else {
+            Logger::Shared().Info("Successfully loaded ", report.Records, " items from ", filename);
+        }
     }
-
-    file.close();
 }
 
 void JSONHandler::Print() const {
-    if (data.empty()) {
+    // Console output proper: queued log lines go first
+    Logger::Shared().Flush();
+    if (store.Empty()) {
         std::cout << "No data to display." << std::endl;
         return;
     }
 
-    std::cout << std::setw(4) << data << std::endl;
+    std::cout << std::setw(4) << store.ToJson() << std::endl;
 }
 
-void JSONHandler::Execute() {
-    // Task 1: Sort by rating and keep top 10% and bottom 10%
-    if (!data.is_array() || data.empty()) {
-        std::cerr << "Error: Invalid or empty data" << std::endl;
+void JSONHandler::Execute(const std::string& field, double lower, double upper) {
+    // Task 1: Keep the records with the lowest and highest ratings (10% each by default)
+    if (store.Empty()) {
+        Logger::Shared().Error("Error: Invalid or empty data");
         return;
     }
 
-    std::vector<json> items;
-    for (const auto& item : data) {
-        items.push_back(item);
+    // Rating bands come from the index, built here once after a snapshot open
+    store.IndexRatings();
+    std::vector<size_t> result;
+    if (!store.PercentileBand(field, lower, upper, result, pool ? *pool : ThreadPool::Shared())) {
+        Logger::Shared().Error("Error: Cannot filter by ", field, " with fractions ", lower, " and ", upper);
+        return;
     }
 
-    // Sort by Rating field
-    std::sort(items.begin(), items.end(), [](const json& a, const json& b) {
-        if (!a.contains("Rating") || !b.contains("Rating")) return false;
-        return a["Rating"].get<double>() < b["Rating"].get<double>();
-    });
-
-    // Calculate 10% of items
-    size_t tenPercent = std::max(size_t(1), items.size() / 10);
-
-    json result = json::array();
+    store = store.Select(result);
+    appendFile.clear();
+    ++version;
+    Logger::Shared().Info("Executed: Kept ", result.size(), " books with the lowest ", lower * 100.0,
+                          "% and highest ", upper * 100.0, "% ", field);
+}
 
-    // Add bottom 10% (lowest ratings)
-    for (size_t i = 0; i < tenPercent && i < items.size(); ++i) {
-        result.push_back(items[i]);
+std::shared_ptr<const BandView> JSONHandler::ExecuteView(const std::string& field, double lower,
+                                                         double upper) const {
+    std::lock_guard<std::mutex> lock(viewMutex);
+    if (!views.empty() && views.front()->Version != version) {
+        views.clear();
     }
-
-    // Add top 10% (highest ratings)
-    size_t startIdx = items.size() > tenPercent ? items.size() - tenPercent : 0;
-    for (size_t i = startIdx; i < items.size(); ++i) {
-        if (std::find(result.begin(), result.end(), items[i]) == result.end()) {
-            result.push_back(items[i]);
+    for (const auto& view : views) {
+        if (view->Field == field && view->Lower == lower && view->Upper == upper) {
+            return view;
         }
     }
 
-    data = result;
-    std::cout << "Executed: Kept 10% books with highest and lowest ratings" << std::endl;
+    auto view = std::make_shared<BandView>();
+    view->Version = version;
+    view->Field = field;
+    view->Lower = lower;
+    view->Upper = upper;
+    if (!store.PercentileBand(field, lower, upper, view->Indices, pool ? *pool : ThreadPool::Shared())) {
+        return nullptr;
+    }
+    if (views.size() == kMaxCachedViews) {
+        views.erase(views.begin());
+    }
+    views.push_back(view);
+    return view;
+}
+
+void JSONHandler::SetThreads(std::size_t threads) {
+    pool = threads == 0 ? nullptr : std::make_shared<ThreadPool>(threads);
 }
 
 void JSONHandler::Add() {
     json newItem;
 
+    Logger::Shared().Flush();
     std::cout << "Adding new Literature item:" << std::endl;
 
     // Get Authors
@@ -121,166 +156,246 @@ void JSONHandler::Add() {
     newItem["Rating"] = rating;
 
     // Generate and add ID
-    newItem["ID"] = GenerateID(name);
+    std::string id = GenerateID(name);
+    newItem["ID"] = id;
 
-    if (!data.is_array()) {
-        data = json::array();
-    }
-
-    data.push_back(newItem);
-    std::cout << "Item added successfully with ID: " << newItem["ID"] << std::endl;
+    store.AppendJson(newItem);
+    ++version;
+    Logger::Shared().Info("Item added successfully with ID: \"", id, '"');
 }
 
 void JSONHandler::Delete(const std::string& field, const std::string& value) {
-    if (!data.is_array()) {
-        std::cerr << "Error: Data is not an array" << std::endl;
-        return;
-    }
-
-    auto it = std::remove_if(data.begin(), data.end(), [&](const json& item) {
-        if (!item.contains(field)) return false;
-
-        if (item[field].is_string()) {
-            return item[field].get<std::string>() == value;
-        } else if (item[field].is_number_integer()) {
-            try {
-                return item[field].get<int>() == std::stoi(value);
-            } catch(...) {
-                return false;
-            }
-        } else if (item[field].is_number_float()) {
-            try {
-                return std::abs(item[field].get<double>() - std::stod(value)) < 0.001;
-            } catch(...) {
-                return false;
-            }
-        }
-        return false;
-    });
-
-    if (it != data.end()) {
-        data.erase(it, data.end());
-        std::cout << "Deleted items where " << field << " = " << value << std::endl;
+    if (DeleteRecords(RecordPredicate::Equals(field, value).Find(store)) > 0) {
+        Logger::Shared().Info("Deleted items where ", field, " = ", value);
     } else {
-        std::cout << "No items found with " << field << " = " << value << std::endl;
+        Logger::Shared().Info("No items found with ", field, " = ", value);
     }
 }
 
-void JSONHandler::Generate() {
-    json newItem;
-
-    // Sample data for random generation
-    std::vector<std::string> sampleAuthors = {
-        "Leo Tolstoy", "Fyodor Dostoevsky", "Anton Chekhov",
-        "Alexander Pushkin", "Nikolai Gogol", "Ivan Turgenev",
-        "Vladimir Nabokov", "Mikhail Bulgakov"
-    };
-
-    std::vector<std::string> sampleNames = {
-        "War and Peace", "Crime and Punishment", "Anna Karenina",
-        "The Brothers Karamazov", "Dead Souls", "Fathers and Sons",
-        "The Master and Margarita", "Eugene Onegin"
-    };
+bool JSONHandler::DeleteWhere(const std::string& condition) {
+    RecordPredicate predicate;
+    std::string error;
+    if (!RecordPredicate::Compile(condition, predicate, error)) {
+        Logger::Shared().Error("Invalid condition: ", error);
+        return false;
+    }
 
-    std::vector<std::string> samplePublishers = {
-        "Penguin Classics", "Oxford University Press", "Vintage Books",
-        "Modern Library", "Everyman's Library", "Dover Publications"
-    };
+    std::size_t removed = DeleteRecords(predicate.Find(store));
+    Logger::Shared().Info("Deleted ", removed, " items where ", condition);
+    return true;
+}
 
-    std::random_device rd;
-    std::mt19937 gen(rd());
+std::size_t JSONHandler::DeleteByAuthors(const std::vector<std::string>& authors) {
+    std::size_t removed = DeleteRecords(RecordPredicate::Authors(authors).Find(store));
+    Logger::Shared().Info("Deleted ", removed, " items by ", authors.size(), " authors");
+    return removed;
+}
 
-    // Generate random authors (1-3)
-    std::uniform_int_distribution<> authorCountDist(1, 3);
-    std::uniform_int_distribution<> authorDist(0, sampleAuthors.size() - 1);
-    int authorCount = authorCountDist(gen);
-    std::vector<std::string> authors;
-    for (int i = 0; i < authorCount; ++i) {
-        authors.push_back(sampleAuthors[authorDist(gen)]);
+std::size_t JSONHandler::DeleteRecords(const std::vector<std::size_t>& positions) {
+    std::size_t removed = store.Delete(positions);
+    if (removed > 0) {
+        ++version;
+        // Compacting in bulk keeps the cost per deleted record constant
+        if (store.Deleted() >= compactionRatio * static_cast<double>(store.Size())) {
+            CompactStore();
+        }
     }
-    newItem["Author"] = authors;
-
-    // Generate random name
-    std::uniform_int_distribution<> nameDist(0, sampleNames.size() - 1);
-    std::string name = sampleNames[nameDist(gen)];
-    newItem["Name"] = name;
+    return removed;
+}
 
-    // Generate random year (1800-2024)
-    std::uniform_int_distribution<> yearDist(1800, 2024);
-    newItem["Year"] = yearDist(gen);
+std::size_t JSONHandler::CompactStore() {
+    // The append mark moves down past the deleted slots below it
+    std::size_t below = 0;
+    for (std::size_t i = 0; store.Deleted() > 0 && i < appendMark; ++i) {
+        below += !store.Live(i);
+    }
+    appendMark -= below;
+    return store.Compact();
+}
 
-    // Generate random publisher
-    std::uniform_int_distribution<> publisherDist(0, samplePublishers.size() - 1);
-    newItem["Publisher"] = samplePublishers[publisherDist(gen)];
+std::size_t JSONHandler::Compact() {
+    std::size_t reclaimed = CompactStore();
+    if (reclaimed > 0) {
+        ++version;  // Positions change
+    }
+    return reclaimed;
+}
 
-    // Generate random rating (0.0-10.0)
-    std::uniform_real_distribution<> ratingDist(0.0, 10.0);
-    newItem["Rating"] = std::round(ratingDist(gen) * 10.0) / 10.0;
+bool JSONHandler::Query(const std::string& condition, std::vector<std::size_t>& positions) const {
+    RecordPredicate predicate;
+    std::string error;
+    if (!RecordPredicate::Compile(condition, predicate, error)) {
+        Logger::Shared().Error("Invalid condition: ", error);
+        return false;
+    }
+    positions = predicate.Find(store);
+    return true;
+}
 
-    // Generate ID
-    newItem["ID"] = GenerateID(name);
+std::vector<std::size_t> JSONHandler::QueryAuthors(const std::vector<std::string>& authors) const {
+    return RecordPredicate::Authors(authors).Find(store);
+}
 
-    if (!data.is_array()) {
-        data = json::array();
+bool JSONHandler::IndexField(const std::string& field, bool enabled) {
+    std::uint8_t bit = LiteratureStore::FieldBit(field) & LiteratureStore::kIndexableFields;
+    if (bit == 0) {
+        return false;
     }
+    indexedFields = enabled ? (indexedFields | bit) : (indexedFields & ~bit);
+    store.IndexFields(indexedFields);
+    return true;
+}
 
-    data.push_back(newItem);
-    std::cout << "Generated item with ID: " << newItem["ID"] << std::endl;
+void JSONHandler::Generate() {
+    // One generator per thread, seeded once
+    thread_local FastRandom random((static_cast<std::uint64_t>(std::random_device{}()) << 32) ^ std::random_device{}());
+    Literature lit;
+    SampleLiterature(random, lit);
+    std::string id = NextID(lit.Name);
+
+    store.Append(lit, id);
+    ++version;
+    Logger::Shared().Info("Generated item with ID: \"", id, '"');
 }
 
 std::string JSONHandler::GenerateID(const std::string& name) {
-    std::stringstream ss;
-    ss << "LIT" << std::setfill('0') << std::setw(3) << idCounter++;
+    return NextID(name);
+}
+
+std::string JSONHandler::NextID(const std::string& name) {
+    // Every ID observed so far lies below the counter; the lookup is a cheap
+    // guard against records that reached the store some other way
+    std::string id;
+    do {
+        id = FormatLiteratureID(ids.Next(), name);
+    } while (store.FindID(id) != IdIndex::kNotFound);
 
-    // Add first 3 letters of name (or less if name is shorter)
-    std::string namePrefix = name.substr(0, std::min(size_t(3), name.length()));
-    std::transform(namePrefix.begin(), namePrefix.end(), namePrefix.begin(), ::toupper);
-    ss << namePrefix;
+    return id;
+}
 
-    return ss.str();
+bool JSONHandler::PersistIDs(const std::string& path) {
+    std::string error;
+    if (!ids.Persist(path, error)) {
+        Logger::Shared().Error("Error: ", error);
+        return false;
+    }
+    return true;
 }
 
 bool JSONHandler::ValidateID(const std::string& id) const {
-    // Pattern: LIT + 3 digits + 3 letters
-    std::regex pattern("^LIT\\d{3}[A-Z]{1,3}$");
-    return std::regex_match(id, pattern);
+    return IsLiteratureID(id);
 }
 
 json JSONHandler::GetByID(const std::string& id) const {
     if (!ValidateID(id)) {
-        std::cerr << "Invalid ID format: " << id << std::endl;
+        Logger::Shared().Warning("Invalid ID format: ", id);
         return json();
     }
 
-    for (const auto& item : data) {
-        if (item.contains("ID") && item["ID"] == id) {
-            return item;
-        }
+    std::size_t position = store.FindID(id);
+    return position == IdIndex::kNotFound ? json() : store.RecordToJson(position);
+}
+
+json JSONHandler::GetByIDs(const std::vector<std::string>& ids) const {
+    json items = json::array();
+    for (const auto& id : ids) {
+        std::size_t position = ValidateID(id) ? store.FindID(id) : IdIndex::kNotFound;
+        items.push_back(position == IdIndex::kNotFound ? json() : store.RecordToJson(position));
     }
+    return items;
+}
 
-    return json();
+std::size_t JSONHandler::ResolveIDs(const std::vector<std::string>& ids, std::vector<std::size_t>& positions) const {
+    std::size_t valid = 0;
+    positions.assign(ids.size(), IdIndex::kNotFound);
+    for (std::size_t k = 0; k < ids.size(); ++k) {
+        if (IsLiteratureID(ids[k])) {
+            ++valid;
+            positions[k] = store.FindID(ids[k]);
+        }
+    }
+    return valid;
 }
 
 void JSONHandler::Generate_ex(int count) {
-    std::cout << "Generating " << count << " items..." << std::endl;
+    Logger::Shared().Info("Generating ", count, " items...");
 
-    for (int i = 0; i < count; ++i) {
-        Generate();
-    }
+    std::uint64_t seed = (static_cast<std::uint64_t>(std::random_device{}()) << 32) ^ std::random_device{}();
+    GenerateLiterature(count > 0 ? count : 0, seed, ids, store, pool ? *pool : ThreadPool::Shared());
+    ++version;
 
-    std::cout << "Successfully generated " << count << " items" << std::endl;
+    Logger::Shared().Info("Successfully generated ", count, " items");
 }
 
-void JSONHandler::SaveToFile(const std::string& filename) const {
-    std::ofstream file(filename);
+void JSONHandler::GenerateWorkload(const WorkloadSpec& spec, std::size_t count) {
+    Logger::Shared().Info("Generating ", count, " items with seed ", spec.Seed, "...");
+
+    ::GenerateWorkload(WorkloadGenerator(spec), count, ids, store, pool ? *pool : ThreadPool::Shared());
+    ++version;
+
+    Logger::Shared().Info("Successfully generated ", count, " items");
+}
+
+void JSONHandler::AddItem(const json& item) {
+    store.AppendJson(item);
+    if (store.Has(store.Size() - 1, LiteratureStore::kID)) {
+        ids.Observe(store.ID(store.Size() - 1));
+    }
+    ++version;
+}
+
+void JSONHandler::SaveToFile(const std::string& filename, DataFormat format, bool append) const {
+    if (format == DataFormat::Auto) {
+        format = FormatFromExtension(filename);
+        if (format == DataFormat::Auto) {
+            format = DataFormat::Json;
+        }
+    }
+    if (append && format != DataFormat::NDJSON) {
+        Logger::Shared().Error("Error: Only NDJSON files can be appended to");
+        return;
+    }
+
+    std::ofstream file(filename, std::ios::binary | (append ? std::ios::app : std::ios::trunc));
     if (!file.is_open()) {
-        std::cerr << "Error: Cannot open file " << filename << " for writing" << std::endl;
+        Logger::Shared().Error("Error: Cannot open file ", filename, " for writing");
         return;
     }
 
-    file << std::setw(4) << data << std::endl;
+    if (append) {
+        // Records the file already holds are not written again
+        WriteLiteratureLines(file, store, filename == appendFile ? appendMark : 0);
+    } else {
+        WriteLiterature(file, store, format);
+    }
     file.close();
-    std::cout << "Data saved to " << filename << std::endl;
+    appendFile = filename;
+    appendMark = store.Size();
+    Logger::Shared().Info("Data saved to ", filename);
+}
+
+void JSONHandler::SaveSnapshot(const std::string& filename) const {
+    std::string error;
+    if (!LiteratureSnapshot::Save(filename, store, error)) {
+        Logger::Shared().Error("Error: ", error);
+        return;
+    }
+    Logger::Shared().Info("Snapshot saved to ", filename);
+}
+
+void JSONHandler::LoadSnapshot(const std::string& filename, bool verify) {
+    std::string error;
+    if (!LiteratureSnapshot::Open(filename, store, error, verify)) {
+        Logger::Shared().Error("Error: ", error);
+        return;
+    }
+    // Snapshots open without the ID index; lookups would scan until the first change
+    store.IndexIDs();
+    store.IndexFields(indexedFields);
+    ids.Observe(store);
+    appendFile.clear();
+    ++version;
+    Logger::Shared().Info("Opened snapshot with ", store.Size(), " items from ", filename);
 }
 
 void JSONHandler::to_json(json& j, const Literature& lit) const {
@@ -0,0 +1,267 @@
+#include "../inc/workload_generator.h"
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <fstream>
+
+namespace {
+
+const double kPi = 3.14159265358979323846;
+
+// Table over explicit weights; false if one is negative or none is positive
+bool CumulativeWeights(const std::vector<double>& weights, std::vector<double>& cumulative) {
+    double total = 0.0;
+    cumulative.clear();
+    for (double weight : weights) {
+        if (!(weight >= 0.0)) {
+            return false;
+        }
+        total += weight;
+        cumulative.push_back(total);
+    }
+    return total > 0.0;
+}
+
+bool ReadVocabulary(const json& config, const char* key, WorkloadSpec::Vocabulary& vocabulary, std::string& error) {
+    auto entry = config.find(key);
+    if (entry == config.end()) {
+        return true;
+    }
+    vocabulary.Count = entry->value("Count", vocabulary.Count);
+    vocabulary.Skew = entry->value("Skew", vocabulary.Skew);
+    vocabulary.Prefix = entry->value("Prefix", vocabulary.Prefix);
+    std::string file = entry->value("File", std::string());
+    if (!file.empty() && !WorkloadSpec::LoadWords(file, vocabulary.Words)) {
+        error = std::string(key) + ": cannot read words from " + file;
+        return false;
+    }
+    if (vocabulary.Words.empty() && vocabulary.Count == 0) {
+        error = std::string(key) + ": needs a Count above 0 or a File";
+        return false;
+    }
+    if (!(vocabulary.Skew >= 0.0)) {
+        error = std::string(key) + ": Skew must not be negative";
+        return false;
+    }
+    // Words are drawn with 32 random bits, and a skewed vocabulary keeps one weight per word
+    std::size_t size = vocabulary.Words.empty() ? vocabulary.Count : vocabulary.Words.size();
+    std::size_t limit = vocabulary.Skew > 0.0 ? WorkloadSpec::kMaxSkewedWords : WorkloadSpec::kMaxWords;
+    if (size > limit) {
+        error = std::string(key) + ": at most " + std::to_string(limit) + " words" +
+                (vocabulary.Skew > 0.0 ? " with a Skew" : "");
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+bool WorkloadSpec::FromJson(const json& config, WorkloadSpec& spec, std::string& error) {
+    if (!config.is_object()) {
+        error = "Workload spec must be an object";
+        return false;
+    }
+    WorkloadSpec result;
+    try {
+        result.Seed = config.value("Seed", result.Seed);
+        if (!ReadVocabulary(config, "Authors", result.Authors, error) ||
+            !ReadVocabulary(config, "Publishers", result.Publishers, error) ||
+            !ReadVocabulary(config, "Names", result.Names, error)) {
+            return false;
+        }
+
+        result.AuthorsPerRecord = config.value("AuthorsPerRecord", result.AuthorsPerRecord);
+        std::vector<double> cumulative;
+        if (!CumulativeWeights(result.AuthorsPerRecord, cumulative)) {
+            error = "AuthorsPerRecord needs non-negative weights, one of them positive";
+            return false;
+        }
+
+        auto years = config.find("Years");
+        if (years != config.end()) {
+            result.Years.clear();
+            for (const auto& range : *years) {
+                YearRange parsed;
+                parsed.Min = range.value("Min", parsed.Min);
+                parsed.Max = range.value("Max", parsed.Max);
+                parsed.Weight = range.value("Weight", parsed.Weight);
+                if (parsed.Min > parsed.Max) {
+                    error = "Years: Min above Max";
+                    return false;
+                }
+                result.Years.push_back(parsed);
+            }
+        }
+        std::vector<double> weights;
+        for (const auto& range : result.Years) {
+            weights.push_back(range.Weight);
+        }
+        if (!CumulativeWeights(weights, cumulative)) {
+            error = "Years needs non-negative weights, one of them positive";
+            return false;
+        }
+
+        auto rating = config.find("Rating");
+        if (rating != config.end()) {
+            std::string shape = rating->value("Shape", std::string("normal"));
+            if (shape == "uniform") {
+                result.Rating = RatingShape::Uniform;
+            } else if (shape == "normal") {
+                result.Rating = RatingShape::Normal;
+            } else if (shape == "bimodal") {
+                result.Rating = RatingShape::Bimodal;
+            } else {
+                error = "Unknown rating shape '" + shape + "'";
+                return false;
+            }
+            result.RatingMean = rating->value("Mean", result.RatingMean);
+            result.RatingStdDev = rating->value("StdDev", result.RatingStdDev);
+            result.RatingMean2 = rating->value("Mean2", result.RatingMean2);
+            result.RatingStdDev2 = rating->value("StdDev2", result.RatingStdDev2);
+            result.RatingWeight2 = rating->value("Weight2", result.RatingWeight2);
+        }
+        if (!(result.RatingStdDev >= 0.0) || !(result.RatingStdDev2 >= 0.0) ||
+            !(result.RatingWeight2 >= 0.0 && result.RatingWeight2 <= 1.0)) {
+            error = "Rating needs StdDev >= 0 and Weight2 in 0..1";
+            return false;
+        }
+    } catch (const json::exception& e) {
+        error = std::string("Workload spec: ") + e.what();
+        return false;
+    }
+    spec = std::move(result);
+    return true;
+}
+
+bool WorkloadSpec::Load(const std::string& filename, WorkloadSpec& spec, std::string& error) {
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        error = "Cannot open " + filename;
+        return false;
+    }
+    json config = json::parse(file, nullptr, false);
+    if (config.is_discarded()) {
+        error = filename + " is not valid JSON";
+        return false;
+    }
+    return FromJson(config, spec, error);
+}
+
+bool WorkloadSpec::LoadWords(const std::string& filename, std::vector<std::string>& words) {
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        return false;
+    }
+    std::vector<std::string> loaded;
+    std::string line;
+    while (std::getline(file, line)) {
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        if (!line.empty()) {
+            loaded.push_back(line);
+        }
+    }
+    if (loaded.empty()) {
+        return false;
+    }
+    words = std::move(loaded);
+    return true;
+}
+
+std::size_t WorkloadGenerator::Table::Pick(FastRandom& random) const {
+    if (Cumulative.empty()) {
+        return random.Below(static_cast<std::uint32_t>(Size));
+    }
+    double target = random.Unit() * Cumulative.back();
+    std::size_t found = std::upper_bound(Cumulative.begin(), Cumulative.end(), target) - Cumulative.begin();
+    return std::min(found, Size - 1);
+}
+
+WorkloadGenerator::WorkloadGenerator(const WorkloadSpec& workload) : spec(workload) {
+    auto zipf = [](const WorkloadSpec::Vocabulary& vocabulary, Table& table) {
+        table.Size = vocabulary.Words.empty() ? vocabulary.Count : vocabulary.Words.size();
+        if (vocabulary.Skew > 0.0) {
+            std::vector<double> weights(table.Size);
+            for (std::size_t k = 0; k < table.Size; ++k) {
+                weights[k] = 1.0 / std::pow(static_cast<double>(k + 1), vocabulary.Skew);
+            }
+            CumulativeWeights(weights, table.Cumulative);
+        }
+    };
+    zipf(spec.Authors, authors);
+    zipf(spec.Publishers, publishers);
+    zipf(spec.Names, names);
+
+    authorCounts.Size = spec.AuthorsPerRecord.size();
+    CumulativeWeights(spec.AuthorsPerRecord, authorCounts.Cumulative);
+    std::vector<double> weights;
+    for (const auto& range : spec.Years) {
+        weights.push_back(range.Weight);
+    }
+    years.Size = spec.Years.size();
+    CumulativeWeights(weights, years.Cumulative);
+}
+
+void WorkloadGenerator::Word(const WorkloadSpec::Vocabulary& vocabulary, const Table& table, FastRandom& random,
+                             std::string& out) const {
+    std::size_t k = table.Pick(random);
+    if (!vocabulary.Words.empty()) {
+        out = vocabulary.Words[k];
+        return;
+    }
+    char digits[24];
+    char* end = std::to_chars(digits, digits + sizeof(digits), k + 1).ptr;
+    out.assign(vocabulary.Prefix);
+    out += ' ';
+    out.append(digits, end);
+}
+
+double WorkloadGenerator::Normal(FastRandom& random, double mean, double deviation) const {
+    // Box-Muller; 1 - Unit() keeps the logarithm finite
+    double radius = std::sqrt(-2.0 * std::log(1.0 - random.Unit()));
+    return mean + deviation * radius * std::cos(2.0 * kPi * random.Unit());
+}
+
+void WorkloadGenerator::Record(std::uint64_t index, Literature& lit) const {
+    FastRandom random(spec.Seed, index);
+
+    lit.Author.resize(authorCounts.Pick(random) + 1);
+    for (std::string& author : lit.Author) {
+        Word(spec.Authors, authors, random, author);
+    }
+    Word(spec.Names, names, random, lit.Name);
+    Word(spec.Publishers, publishers, random, lit.Publisher);
+
+    const WorkloadSpec::YearRange& range = spec.Years[years.Pick(random)];
+    // The span of a range reaching from INT_MIN to INT_MAX only fits 32 unsigned bits
+    const std::uint32_t span = static_cast<std::uint32_t>(static_cast<std::int64_t>(range.Max) - range.Min);
+    const std::uint32_t offset = span == UINT32_MAX ? static_cast<std::uint32_t>(random.Next() >> 32)
+                                                    : random.Below(span + 1);
+    lit.Year = static_cast<int>(range.Min + static_cast<std::int64_t>(offset));
+
+    double rating;
+    switch (spec.Rating) {
+        case WorkloadSpec::RatingShape::Uniform:
+            rating = random.Unit() * 10.0;
+            break;
+        case WorkloadSpec::RatingShape::Bimodal:
+            if (random.Unit() < spec.RatingWeight2) {
+                rating = Normal(random, spec.RatingMean2, spec.RatingStdDev2);
+                break;
+            }
+            rating = Normal(random, spec.RatingMean, spec.RatingStdDev);
+            break;
+        default:
+            rating = Normal(random, spec.RatingMean, spec.RatingStdDev);
+            break;
+    }
+    lit.Rating = std::round(std::min(10.0, std::max(0.0, rating)) * 10.0) / 10.0;
+}
+
+void GenerateWorkload(const WorkloadGenerator& workload, std::size_t count, IdAllocator& ids, LiteratureStore& store,
+                      ThreadPool& pool) {
+    GenerateLiterature(count, workload.Spec().Seed, [&workload](std::size_t index, FastRandom&, Literature& lit) {
+        workload.Record(index, lit);
+    }, ids, store, pool);
+}
@@ -0,0 +1,361 @@
+#include "../inc/write_ahead_log.h"
+#include "../inc/checksum.h"
+#include "../inc/mapped_file.h"
+#include "../inc/file_sync.h"
+#include <algorithm>
+#include <cstdio>
+#include <utility>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#include <sys/stat.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+void PutLittleEndian(char* out, std::uint64_t value, int bytes) {
+    for (int i = 0; i < bytes; ++i) {
+        out[i] = static_cast<char>((value >> (8 * i)) & 0xff);
+    }
+}
+
+std::uint64_t GetLittleEndian(const char* in, int bytes) {
+    std::uint64_t value = 0;
+    for (int i = bytes - 1; i >= 0; --i) {
+        value = (value << 8) | static_cast<unsigned char>(in[i]);
+    }
+    return value;
+}
+
+const std::size_t kFrameHeader = 20;
+
+std::uint64_t FrameChecksum(std::uint64_t payloadChecksum, std::uint64_t sequence) {
+    return (payloadChecksum ^ sequence) * 0x100000001b3ULL;
+}
+
+// Frame at offset, false if it is incomplete or corrupt
+bool ReadFrame(const char* data, std::uint64_t size, std::uint64_t offset, std::uint64_t& length,
+               std::uint64_t& sequence) {
+    if (size - offset < kFrameHeader) {
+        return false;
+    }
+    const char* frame = data + offset;
+    length = GetLittleEndian(frame, 4);
+    sequence = GetLittleEndian(frame + 4, 8);
+    std::uint64_t checksum = GetLittleEndian(frame + 12, 8);
+    return length <= size - offset - kFrameHeader &&
+           FrameChecksum(Checksum64(frame + kFrameHeader, length), sequence) == checksum;
+}
+
+int OpenForAppend(const std::string& path) {
+#ifdef _WIN32
+    return _open(path.c_str(), _O_WRONLY | _O_CREAT | _O_APPEND | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+    return ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+#endif
+}
+
+bool WriteAll(int fd, const char* data, std::size_t size) {
+    while (size > 0) {
+#ifdef _WIN32
+        int n = _write(fd, data, static_cast<unsigned int>(size));
+#else
+        ssize_t n = ::write(fd, data, size);
+#endif
+        if (n <= 0) {
+            return false;
+        }
+        data += n;
+        size -= static_cast<std::size_t>(n);
+    }
+    return true;
+}
+
+bool SyncFile(int fd) {
+#ifdef _WIN32
+    return _commit(fd) == 0;
+#elif defined(__APPLE__)
+    return ::fsync(fd) == 0;
+#else
+    return ::fdatasync(fd) == 0;
+#endif
+}
+
+bool Truncate(int fd, std::uint64_t size) {
+#ifdef _WIN32
+    return _chsize_s(fd, static_cast<long long>(size)) == 0;
+#else
+    return ::ftruncate(fd, static_cast<off_t>(size)) == 0;
+#endif
+}
+
+void CloseFile(int fd) {
+#ifdef _WIN32
+    _close(fd);
+#else
+    ::close(fd);
+#endif
+}
+
+} // namespace
+
+bool ParseWalSyncPolicy(const std::string& name, WalSyncPolicy& policy) {
+    if (name == "always") {
+        policy = WalSyncPolicy::Always;
+    } else if (name == "interval") {
+        policy = WalSyncPolicy::Interval;
+    } else if (name == "never" || name == "none") {
+        policy = WalSyncPolicy::Never;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+WriteAheadLog::WriteAheadLog(WalOptions walOptions) : options(walOptions) {}
+
+WriteAheadLog::~WriteAheadLog() {
+    Close();
+}
+
+bool WriteAheadLog::Open(const std::string& filename, const std::function<void(const json&)>& apply,
+                         std::string& error, std::uint64_t after) {
+    Close();
+
+    // Replay every complete, intact frame
+    std::uint64_t validBytes = 0;
+    std::uint64_t fileBytes = 0;
+    std::uint64_t lastSequence = after;
+    replayed = 0;
+    MappedFile existing;
+    if (existing.Open(filename)) {
+        const char* data = existing.Data();
+        fileBytes = existing.Size();
+        std::uint64_t length, sequence;
+        while (ReadFrame(data, fileBytes, validBytes, length, sequence)) {
+            const char* payload = data + validBytes + kFrameHeader;
+            if (sequence > after) {
+                json entry;
+                try {
+                    entry = json::from_msgpack(payload, payload + length);
+                } catch (const json::exception&) {
+                    break;
+                }
+                apply(entry);
+                ++replayed;
+            }
+            lastSequence = std::max(lastSequence, sequence);
+            validBytes += kFrameHeader + length;
+        }
+        existing.Close();
+    }
+
+    fd = OpenForAppend(filename);
+    if (fd < 0) {
+        error = "Cannot open log " + filename;
+        return false;
+    }
+    if (validBytes < fileBytes && (!Truncate(fd, validBytes) || !SyncFile(fd))) {
+        error = "Cannot cut the damaged tail of " + filename;
+        CloseFile(fd);
+        fd = -1;
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        path = filename;
+        pending.clear();
+        appended = written = synced = lastSequence;
+        writing = failed = stopping = false;
+        stats = Stats();
+    }
+    flusher = std::thread([this]() { FlushLoop(); });
+    return true;
+}
+
+std::uint64_t WriteAheadLog::Append(const json& entry) {
+    std::vector<std::uint8_t> payload = json::to_msgpack(entry);
+    if (payload.size() > std::min<std::uint64_t>(options.MaxEntryBytes, kMaxEntryBytes)) {
+        std::lock_guard<std::mutex> lock(mutex);
+        failed = true;
+        durable.notify_all();
+        return 0;
+    }
+    std::uint64_t payloadChecksum = Checksum64(payload.data(), payload.size());
+    char header[kFrameHeader];
+    PutLittleEndian(header, payload.size(), 4);
+
+    std::uint64_t sequence;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        sequence = ++appended;
+        PutLittleEndian(header + 4, sequence, 8);
+        PutLittleEndian(header + 12, FrameChecksum(payloadChecksum, sequence), 8);
+        pending.insert(pending.end(), header, header + kFrameHeader);
+        pending.insert(pending.end(), payload.begin(), payload.end());
+        ++stats.Entries;
+    }
+    if (options.Sync != WalSyncPolicy::Interval) {
+        work.notify_one();
+    }
+    return sequence;
+}
+
+bool WriteAheadLog::WaitDurable(std::uint64_t sequence) {
+    std::unique_lock<std::mutex> lock(mutex);
+    if (options.Sync != WalSyncPolicy::Always) {
+        return !failed;
+    }
+    durable.wait(lock, [this, sequence]() { return synced >= sequence || failed; });
+    return synced >= sequence;
+}
+
+bool WriteAheadLog::Flush() {
+    std::unique_lock<std::mutex> lock(mutex);
+    if (fd < 0) {
+        return false;
+    }
+    return WriteBatch(lock, true);
+}
+
+bool WriteAheadLog::TrimThrough(std::uint64_t sequence, std::string& error) {
+    std::unique_lock<std::mutex> lock(mutex);
+    if (fd < 0) {
+        error = "Log is not open";
+        return false;
+    }
+    // Everything appended so far goes to the file first; the lock then stays
+    // held so that no batch is written to the old file behind our back
+    if (!WriteBatch(lock, true)) {
+        error = "Write to " + path + " failed";
+        return false;
+    }
+
+    MappedFile current;
+    if (!current.Open(path)) {
+        error = "Cannot read " + path;
+        return false;
+    }
+    std::uint64_t keepFrom = 0;
+    std::uint64_t length, frameSequence;
+    while (ReadFrame(current.Data(), current.Size(), keepFrom, length, frameSequence) &&
+           frameSequence <= sequence) {
+        keepFrom += kFrameHeader + length;
+    }
+    if (keepFrom == 0) {
+        return true;
+    }
+
+    const std::string temporary = path + ".tmp";
+    int trimmed = OpenForAppend(temporary);
+    bool ok = trimmed >= 0 && Truncate(trimmed, 0) &&
+              WriteAll(trimmed, current.Data() + keepFrom, static_cast<std::size_t>(current.Size() - keepFrom));
+    if (trimmed >= 0) {
+        CloseFile(trimmed);
+    }
+    current.Close();
+    if (!ok || !DurableReplace(temporary, path)) {
+        std::remove(temporary.c_str());
+        error = "Cannot rewrite " + path;
+        return false;
+    }
+
+    int reopened = OpenForAppend(path);
+    if (reopened < 0) {
+        failed = true;
+        error = "Cannot reopen " + path;
+        return false;
+    }
+    CloseFile(fd);
+    fd = reopened;
+    return true;
+}
+
+bool WriteAheadLog::Failed() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return failed;
+}
+
+std::uint64_t WriteAheadLog::LastSequence() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return appended;
+}
+
+WriteAheadLog::Stats WriteAheadLog::GetStats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return stats;
+}
+
+void WriteAheadLog::FlushLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        if (options.Sync == WalSyncPolicy::Interval) {
+            work.wait_for(lock, options.Interval, [this]() { return stopping; });
+        } else {
+            work.wait(lock, [this]() { return stopping || !pending.empty(); });
+        }
+        if (stopping) {
+            break;
+        }
+        WriteBatch(lock, options.Sync != WalSyncPolicy::Never);
+    }
+}
+
+bool WriteAheadLog::WriteBatch(std::unique_lock<std::mutex>& lock, bool sync) {
+    // One batch at a time; a caller arriving mid-write takes the next one
+    durable.wait(lock, [this]() { return !writing; });
+    if (failed) {
+        return false;
+    }
+    if (pending.empty() && (!sync || synced == written)) {
+        return true;
+    }
+
+    std::vector<char> batch;
+    batch.swap(pending);
+    std::uint64_t last = appended;
+    writing = true;
+    lock.unlock();
+
+    bool ok = WriteAll(fd, batch.data(), batch.size()) && (!sync || SyncFile(fd));
+
+    lock.lock();
+    writing = false;
+    if (ok) {
+        written = last;
+        stats.Bytes += batch.size();
+        if (sync) {
+            synced = last;
+            ++stats.Syncs;
+        }
+    } else {
+        failed = true;
+    }
+    durable.notify_all();
+    return ok;
+}
+
+void WriteAheadLog::Close() {
+    if (fd < 0) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    work.notify_one();
+    if (flusher.joinable()) {
+        flusher.join();
+    }
+
+    std::unique_lock<std::mutex> lock(mutex);
+    WriteBatch(lock, options.Sync != WalSyncPolicy::Never);
+    lock.unlock();
+    CloseFile(fd);
+    fd = -1;
+}
@@ -5,10 +5,36 @@
  */
 
 #include "../inc/task.h"
+#include "../inc/literature_loader.h"
+#include "../inc/mapped_file.h"
+#include "../inc/literature_writer.h"
+#include "../inc/literature_snapshot.h"
+#include "../inc/write_ahead_log.h"
+#include "../inc/checkpointer.h"
+#include "../inc/thread_pool.h"
+#include "../inc/record_predicate.h"
+#include "../inc/id_index.h"
+#include "../inc/literature_id.h"
+#include "../inc/id_allocator.h"
+#include "../inc/literature_generator.h"
+#include "../inc/workload_generator.h"
+#include "../inc/logger.h"
+#include "server.h"
 #include <iostream>
 #include <fstream>
+#include <sstream>
+#include <iomanip>
 #include <cassert>
+#include <cmath>
+#include <algorithm>
 #include <cstdio>
+#include <thread>
+#include <set>
+#include <atomic>
+#ifdef __linux__
+#include <csignal>
+#include <sys/resource.h>
+#endif
 
 // Test helper function to create sample data file
 void createTestDataFile(const std::string& filename) {
@@ -147,7 +173,7 @@ void testIDFunctions() {
     assert(handler.ValidateID("LIT999Z") == true);
     assert(handler.ValidateID("INVALID") == false);
     assert(handler.ValidateID("ABC123DEF") == false);
-    assert(handler.ValidateID("LIT1234AB") == false); // Too many digits
+    assert(handler.ValidateID("LIT01234AB") == false); // Non-canonical leading zero
 
     // Test GetByID
     handler.Generate();
@@ -243,6 +269,1714 @@ void testLiteratureConversion() {
     std::cout << " PASSED" << std::endl;
 }
 
+// Test 9: Columnar record store
+void testLiteratureStore() {
+    std::cout << "Test 9: Literature store...";
+
+    LiteratureStore store;
+    for (int i = 0; i < 5; ++i) {
+        Literature lit;
+        lit.Author = std::vector<std::string>(i % 3 + 1, "Author " + std::to_string(i));
+        lit.Name = "Book " + std::to_string(i);
+        lit.Year = 1900 + i;
+        lit.Publisher = i % 2 ? "Odd Press" : "Even Press";
+        lit.Rating = i + 0.5;
+        store.Append(lit, "LIT00" + std::to_string(i + 1) + "BOO");
+    }
+    store.AppendJson({{"Name", "Partial"}, {"Rating", 5.0}});
+    assert(store.Size() == 6);
+
+    // Records without a field round-trip without it
+    json partial = store.RecordToJson(5);
+    assert(partial.size() == 2);
+    assert(!partial.contains("Author"));
+
+    // Erase keeps the order and the strings of the remaining records
+    size_t removed = store.Erase(store.Match("Publisher", "Odd Press"));
+    assert(removed == 2);
+    assert(store.Size() == 4);
+    assert(store.Name(1) == "Book 2");
+    assert(store.AuthorCount(1) == 3);
+    assert(store.Author(1, 2) == "Author 2");
+    assert(store.ID(2) == "LIT005BOO");
+    assert(store.Name(3) == "Partial");
+
+    // JSON round trip
+    LiteratureStore copy = LiteratureStore::FromJson(store.ToJson());
+    assert(copy.ToJson() == store.ToJson());
+    assert(copy.MemoryUsage() > 0);
+
+    std::cout << " PASSED" << std::endl;
+}
+
+// Test 10: Streaming SAX loader
+void testSaxLoader() {
+    std::cout << "Test 10: SAX loader...";
+
+    std::ofstream file("test_sax.json");
+    file << R"([
+        {"Author": ["A", "B"], "Name": "Good", "Year": 2001, "Rating": 7.5, "Extra": {"x": [1, 2]}},
+        {"Name": "Bad year", "Year": "soon"},
+        42,
+        {"Author": "Single", "Name": "Lone author", "ID": "LIT001LON"}
+    ])";
+    file.close();
+
+    LiteratureStore store;
+    std::ifstream input("test_sax.json");
+    LoadReport report = LoadLiterature(input, store);
+    input.close();
+
+    assert(report.Ok());
+    assert(report.Records == 2);
+    assert(report.Rejected == 2);
+    assert(report.Errors.size() == 2);
+    assert(report.Errors[0].Record == 1);
+    assert(report.Errors[1].Record == 2);
+    assert(store.AuthorCount(0) == 2);
+    assert(store.Author(1, 0) == "Single");
+    assert(!store.Has(1, LiteratureStore::kYear));
+    assert(store.ID(1) == "LIT001LON");
+
+    // A syntax error keeps the previously loaded data
+    file.open("test_sax.json");
+    file << "[{\"Name\": \"Broken\"";
+    file.close();
+
+    JSONHandler handler;
+    handler.Input("test_data.json");
+    handler.Input("test_sax.json");
+    assert(handler.GetData().size() == 10);
+
+    std::remove("test_sax.json");
+    std::cout << " PASSED" << std::endl;
+}
+
+// Test 11: Memory-mapped input
+void testMappedFile() {
+    std::cout << "Test 11: Mapped file...";
+
+    MappedFile file;
+    assert(!file.Open("non_existent_file.json"));
+    assert(file.Open("test_data.json"));
+
+    std::ifstream stream("test_data.json", std::ios::binary | std::ios::ate);
+    assert(file.Size() == static_cast<size_t>(stream.tellg()));
+    assert(file.View().front() == '[');
+
+    LiteratureStore store;
+    LoadReport report = LoadLiterature(file.Data(), file.Data() + file.Size(), store);
+    assert(report.Ok());
+    assert(store.Size() == 10);
+
+    // Moving keeps the view valid
+    MappedFile moved = std::move(file);
+    assert(!file.IsOpen());
+    assert(moved.View().front() == '[');
+
+    std::cout << " PASSED" << std::endl;
+}
+
+// Test 12: Parallel chunked loader
+void testParallelLoader() {
+    std::cout << "Test 12: Parallel loader...";
+
+    // About 4 MB so the input is split into several chunks
+    std::string text = "[";
+    for (int i = 0; i < 40000; ++i) {
+        if (i > 0) text += ",\n";
+        if (i == 25000) {
+            text += "{\"Name\": \"Bad \\\"quoted\\\" [name]\", \"Rating\": \"high\"}";
+            continue;
+        }
+        text += "{\"Author\": [\"Author " + std::to_string(i % 7) + "\"], \"Name\": \"Book, {" +
+                std::to_string(i) + "}\", \"Year\": " + std::to_string(1900 + i % 100) +
+                ", \"Publisher\": \"Publisher padding padding padding\", \"Rating\": " +
+                std::to_string(i % 100 / 10.0) + "}";
+    }
+    text += "]";
+
+    LiteratureStore serial;
+    LoadReport serialReport = LoadLiterature(text.data(), text.data() + text.size(), serial);
+
+    ThreadPool pool(4);
+    LiteratureStore parallel;
+    LoadReport parallelReport = LoadLiteratureParallel(text.data(), text.data() + text.size(), parallel, pool);
+
+    assert(parallelReport.Ok());
+    assert(parallelReport.Records == 39999);
+    assert(parallelReport.Rejected == 1);
+    assert(parallelReport.Errors[0].Record == serialReport.Errors[0].Record);
+    assert(parallel.ToJson() == serial.ToJson());
+
+    // Broken input falls back to the serial path and reports the syntax error
+    std::string broken = text.substr(0, text.size() - 1);
+    LiteratureStore failed;
+    assert(!LoadLiteratureParallel(broken.data(), broken.data() + broken.size(), failed, pool).Ok());
+
+    std::cout << " PASSED" << std::endl;
+}
+
+// Test 13: NDJSON import/export and streaming JSON writer
+void testNdjson() {
+    std::cout << "Test 13: NDJSON...";
+
+    JSONHandler handler;
+    handler.Input("test_data.json");
+
+    // The streaming writer matches the DOM pretty-printer byte for byte
+    std::ostringstream streamed, dom;
+    WriteLiteratureJson(streamed, handler.GetStore());
+    dom << std::setw(4) << handler.GetData();
+    assert(streamed.str() == dom.str());
+
+    // Appends write only the records added since the last save, also
+    // when a compaction moved them
+    handler.SetCompactionRatio(0.0);
+    handler.SaveToFile("test_lines.ndjson", DataFormat::NDJSON);
+    handler.SaveToFile("test_lines.ndjson", DataFormat::NDJSON, true);
+    handler.AddItem({{"Name", "Appended 1"}});
+    handler.Delete("Name", "Test Book 3");
+    handler.AddItem({{"Name", "Appended 2"}});
+    handler.SaveToFile("test_lines.ndjson", DataFormat::NDJSON, true);
+
+    // One record per line, each written once
+    std::ifstream lines("test_lines.ndjson");
+    std::string line;
+    std::set<std::string> names;
+    size_t count = 0;
+    while (std::getline(lines, line)) {
+        json record = json::parse(line);
+        assert(record.is_object());
+        names.insert(record["Name"].get<std::string>());
+        ++count;
+    }
+    lines.close();
+    assert(count == 12 && names.size() == 12);
+    assert(names.count("Appended 2") == 1);
+
+    // A loaded file is not appended to again either
+    JSONHandler reloaded;
+    reloaded.Input("test_lines.ndjson", FormatFromExtension("test_lines.ndjson"));
+    assert(reloaded.GetData().size() == 12);
+    reloaded.AddItem({{"Name", "Appended 3"}});
+    reloaded.SaveToFile("test_lines.ndjson", DataFormat::NDJSON, true);
+    JSONHandler appended;
+    appended.Input("test_lines.ndjson", FormatFromExtension("test_lines.ndjson"));
+    assert(appended.GetData().size() == 13);
+
+    // Bad lines are rejected individually, reading continues in batches
+    std::istringstream mixed("{\"Name\": \"A\"}\n\nnot json\n{\"Name\": \"B\"} trailing\n{\"Name\": \"C\"}\n");
+    LiteratureLineReader reader(mixed);
+    LiteratureStore batch;
+    assert(reader.ReadBatch(batch, 1) == 1);
+    assert(reader.ReadBatch(batch, 10) == 1);
+    assert(reader.Done());
+    assert(batch.Size() == 2 && batch.Name(1) == "C");
+    assert(reader.Report().Rejected == 2);
+    assert(reader.Report().Errors[0].Record == 2);
+
+    std::remove("test_lines.ndjson");
+    std::cout << " PASSED" << std::endl;
+}
+
+void testBinaryFormats() {
+    std::cout << "Test 14: Binary formats...";
+
+    JSONHandler handler;
+    handler.Input("test_data.json");
+    handler.Generate_ex(300);
+    json expected = handler.GetData();
+
+    // Streaming writers produce the same bytes as the DOM encoders
+    std::ostringstream cbor, msgpack, ubjson;
+    WriteLiteratureBinary(cbor, handler.GetStore(), DataFormat::Cbor);
+    WriteLiteratureBinary(msgpack, handler.GetStore(), DataFormat::MessagePack);
+    WriteLiteratureBinary(ubjson, handler.GetStore(), DataFormat::Ubjson);
+    std::vector<std::uint8_t> bytes = json::to_cbor(expected);
+    assert(cbor.str() == std::string(bytes.begin(), bytes.end()));
+    bytes = json::to_msgpack(expected);
+    assert(msgpack.str() == std::string(bytes.begin(), bytes.end()));
+    bytes = json::to_ubjson(expected, true);
+    assert(ubjson.str() == std::string(bytes.begin(), bytes.end()));
+
+    const DataFormat formats[] = {DataFormat::Cbor, DataFormat::MessagePack, DataFormat::Ubjson,
+                                  DataFormat::NDJSON, DataFormat::Json};
+    for (DataFormat format : formats) {
+        // No extension: the loader has to recognize the leading bytes
+        handler.SaveToFile("test_binary.dat", format);
+        std::ifstream file("test_binary.dat", std::ios::binary);
+        std::string head(4096, '\0');
+        file.read(&head[0], head.size());
+        head.resize(static_cast<size_t>(file.gcount()));
+        file.close();
+        assert(DetectDataFormat("test_binary.dat", head) == format);
+
+        JSONHandler reloaded;
+        reloaded.Input("test_binary.dat");
+        assert(reloaded.GetData() == expected);
+    }
+
+    // Small arrays use the short headers
+    LiteratureStore single;
+    single.AppendJson(expected[0]);
+    std::ostringstream small;
+    WriteLiteratureBinary(small, single, DataFormat::MessagePack);
+    assert(DetectDataFormat("", small.str()) == DataFormat::MessagePack);
+    small.str("");
+    WriteLiteratureBinary(small, single, DataFormat::Cbor);
+    assert(DetectDataFormat("", small.str()) == DataFormat::Cbor);
+
+    DataFormat parsed = DataFormat::Json;
+    assert(ParseDataFormat("MsgPack", parsed) && parsed == DataFormat::MessagePack);
+    assert(!ParseDataFormat("bson", parsed));
+    assert(FormatFromExtension("dir.v2/data") == DataFormat::Auto);
+    assert(FormatFromExtension("data.cbor") == DataFormat::Cbor);
+
+    std::remove("test_binary.dat");
+    std::cout << " PASSED" << std::endl;
+}
+
+void testSnapshot() {
+    std::cout << "Test 15: Columnar snapshot...";
+
+    JSONHandler handler;
+    handler.Input("test_data.json");
+    handler.Generate_ex(50);
+    json expected = handler.GetData();
+    handler.SaveSnapshot("test_snapshot.lsnap");
+
+    // Opened in place: all columns point into the mapping, only the ID
+    // index (8-byte slots, at most half full) is on the heap
+    JSONHandler mapped;
+    mapped.LoadSnapshot("test_snapshot.lsnap", true);
+    assert(mapped.GetStore().Mapped());
+    assert(mapped.GetStore().MemoryUsage() <= 4 * 8 * expected.size());
+    assert(mapped.GetData() == expected);
+    assert(mapped.GetStore().IDsIndexed());
+    assert(mapped.GetByID(expected.back()["ID"].get<std::string>()) == expected.back());
+
+    // Copies share the mapping; mutations copy the columns first
+    LiteratureStore copy = mapped.GetStore();
+    mapped.Delete("Name", "Test Book 1");
+    assert(mapped.GetData().size() == expected.size() - 1);
+    assert(copy.ToJson() == expected);
+
+    // Replacing the file keeps the old mapping readable
+    mapped.SaveSnapshot("test_snapshot.lsnap");
+    assert(copy.ToJson() == expected);
+    LiteratureStore reopened;
+    std::string error;
+    assert(LiteratureSnapshot::Open("test_snapshot.lsnap", reopened, error));
+    assert(reopened.ToJson() == mapped.GetData());
+
+    // Empty stores round-trip too
+    LiteratureStore empty;
+    assert(LiteratureSnapshot::Save("test_snapshot.lsnap", empty, error));
+    assert(LiteratureSnapshot::Open("test_snapshot.lsnap", reopened, error, true) && reopened.Empty());
+
+    // Corruption in a section is caught by verification, in the header always
+    handler.SaveSnapshot("test_snapshot.lsnap");
+    std::fstream file("test_snapshot.lsnap", std::ios::in | std::ios::out | std::ios::binary);
+    file.seekp(sizeof(LiteratureSnapshot::SnapshotHeader) + 2);
+    file.put('\x7f');
+    file.close();
+    assert(LiteratureSnapshot::Open("test_snapshot.lsnap", reopened, error));
+    assert(!LiteratureSnapshot::Open("test_snapshot.lsnap", reopened, error, true));
+    file.open("test_snapshot.lsnap", std::ios::in | std::ios::out | std::ios::binary);
+    file.seekp(20);
+    file.put('\x7f');
+    file.close();
+    assert(!LiteratureSnapshot::Open("test_snapshot.lsnap", reopened, error));
+    assert(!LiteratureSnapshot::Open("test_data.json", reopened, error));
+
+    std::remove("test_snapshot.lsnap");
+    std::cout << " PASSED" << std::endl;
+}
+
+void testWriteAheadLog() {
+    std::cout << "Test 16: Write-ahead log...";
+
+    std::remove("test_wal.log");
+    std::string error;
+    {
+        WriteAheadLog wal;
+        assert(wal.Open("test_wal.log", [](const json&) { assert(false); }, error));
+
+        // Concurrent committers; each waits for its own entry to be synced
+        std::vector<std::thread> writers;
+        for (int t = 0; t < 4; ++t) {
+            writers.emplace_back([&wal, t]() {
+                for (int i = 0; i < 25; ++i) {
+                    assert(wal.WaitDurable(wal.Append({{"Op", "append"}, {"Thread", t}, {"Seq", i}})));
+                }
+            });
+        }
+        for (auto& writer : writers) writer.join();
+
+        WriteAheadLog::Stats stats = wal.GetStats();
+        assert(stats.Entries == 100);
+        assert(stats.Syncs >= 1 && stats.Syncs <= stats.Entries);
+    }
+
+    // Replay returns every entry, in per-writer order
+    std::vector<int> next(4, 0);
+    size_t replayed = 0;
+    auto check = [&](const json& entry) {
+        int thread = entry.at("Thread").get<int>();
+        assert(entry.at("Seq").get<int>() == next[thread]++);
+        ++replayed;
+    };
+    {
+        WriteAheadLog wal;
+        assert(wal.Open("test_wal.log", check, error));
+        assert(replayed == 100 && wal.Replayed() == 100);
+    }
+
+    // A torn frame at the end is ignored and cut off before new appends
+    {
+        std::ofstream file("test_wal.log", std::ios::binary | std::ios::app);
+        file.write("\x40\x00\x00\x00garbage", 11);
+    }
+    {
+        WalOptions options;
+        options.Sync = WalSyncPolicy::Never;
+        WriteAheadLog wal(options);
+        assert(wal.Open("test_wal.log", [](const json&) {}, error));
+        assert(wal.Replayed() == 100);
+        wal.Append({{"Op", "execute"}});
+    }
+    {
+        WriteAheadLog wal;
+        json last;
+        assert(wal.Open("test_wal.log", [&last](const json& entry) { last = entry; }, error));
+        assert(wal.Replayed() == 101 && last["Op"] == "execute");
+    }
+
+    WalSyncPolicy policy = WalSyncPolicy::Always;
+    assert(ParseWalSyncPolicy("interval", policy) && policy == WalSyncPolicy::Interval);
+    assert(!ParseWalSyncPolicy("sometimes", policy));
+
+    std::remove("test_wal.log");
+    std::cout << " PASSED" << std::endl;
+}
+
+void testCheckpoint() {
+    std::cout << "Test 17: Background checkpoint...";
+
+    JSONHandler handler;
+    handler.Input("test_data.json");
+    LiteratureStore live = handler.GetStore();
+
+    // A frozen version keeps its records while the live store changes
+    LiteratureStore frozen = live.Freeze();
+    json expected = frozen.ToJson();
+    live.Reserve(live.Size() + 8);
+    for (int i = 0; i < 8; ++i) {
+        live.AppendJson({{"Name", "Added " + std::to_string(i)}, {"Year", 2020}, {"Rating", 5.0}});
+    }
+    assert(frozen.ToJson() == expected);
+    assert(live.Size() == expected.size() + 8);
+    live.Erase(live.Match("Name", "Test Book 1"));
+    assert(frozen.ToJson() == expected);
+    LiteratureStore unchanged = live.Freeze();
+    live.Clear();
+    assert(frozen.ToJson() == expected && unchanged.Size() == expected.size() + 7);
+
+    // Log trimmed up to a sequence; reopening skips what a snapshot holds
+    std::remove("test_checkpoint.log");
+    std::string error;
+    {
+        WriteAheadLog wal;
+        assert(wal.Open("test_checkpoint.log", [](const json&) {}, error));
+        for (int i = 0; i < 10; ++i) wal.Append({{"Op", "execute"}, {"Seq", i}});
+        assert(wal.LastSequence() == 10);
+        assert(wal.TrimThrough(6, error));
+        wal.Append({{"Op", "execute"}, {"Seq", 10}});
+    }
+    std::vector<int> seen;
+    auto collect = [&seen](const json& entry) { seen.push_back(entry.at("Seq").get<int>()); };
+    {
+        WriteAheadLog wal;
+        assert(wal.Open("test_checkpoint.log", collect, error, 8));
+        assert((seen == std::vector<int>{8, 9, 10}));
+        assert(wal.Append({{"Op", "execute"}}) == 12);
+    }
+
+    // Checkpoints on the background thread while the owner keeps writing
+    std::mutex mutex;
+    std::uint64_t trimmed = 0;
+    CheckpointOptions options;
+    options.Path = "test_checkpoint.lsnap";
+    options.Interval = std::chrono::milliseconds(0);
+    std::uint64_t version = 0;
+    Checkpointer checkpointer(
+        options,
+        [&]() {
+            std::lock_guard<std::mutex> lock(mutex);
+            return Checkpointer::Version{handler.GetStore().Freeze(), ++version};
+        },
+        [&trimmed](std::uint64_t sequence) { trimmed = sequence; });
+    checkpointer.Start();
+    checkpointer.Trigger();
+    for (int i = 0; i < 200; ++i) {
+        std::lock_guard<std::mutex> lock(mutex);
+        handler.AddItem({{"Name", "Concurrent " + std::to_string(i)}, {"Year", 2000}});
+    }
+    assert(checkpointer.RunNow());
+    checkpointer.Stop();
+
+    CheckpointStats stats = checkpointer.GetStats();
+    assert(stats.Completed >= 1 && stats.Failed == 0);
+    assert(stats.LastSequence == version && trimmed == version);
+    assert(stats.LastRecords == handler.GetStore().Size() && stats.LastBytes > 0);
+
+    LiteratureStore reopened;
+    std::uint64_t sequence = 0;
+    assert(LiteratureSnapshot::Open("test_checkpoint.lsnap", reopened, error, true, &sequence));
+    assert(sequence == version && reopened.ToJson() == handler.GetData());
+
+    std::remove("test_checkpoint.log");
+    std::remove("test_checkpoint.lsnap");
+    std::cout << " PASSED" << std::endl;
+}
+
+void testPercentileBand() {
+    std::cout << "Test 18: Percentile band selection...";
+
+    // Few distinct values, so ties are everywhere
+    LiteratureStore store;
+    for (int i = 0; i < 503; ++i) {
+        store.AppendJson({{"Name", "Book " + std::to_string(i)}, {"Year", 1990 + (i * 7) % 13},
+                          {"Rating", ((i * 37) % 11) / 2.0}});
+    }
+
+    // Reference: full stable sort, bottom ranks then the top ranks not already taken
+    auto reference = [&store](bool byYear, double lower, double upper) {
+        std::vector<size_t> order(store.Size());
+        for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+        std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+            return byYear ? store.Year(a) < store.Year(b) : store.Rating(a) < store.Rating(b);
+        });
+        auto band = [&](double f) {
+            return f <= 0.0 ? size_t(0)
+                            : std::min(order.size(), std::max(size_t(1), size_t(order.size() * f + 1e-9)));
+        };
+        size_t low = band(lower);
+        size_t highStart = std::max(order.size() - band(upper), low);
+        std::vector<size_t> expected(order.begin(), order.begin() + low);
+        expected.insert(expected.end(), order.begin() + highStart, order.end());
+        return expected;
+    };
+
+    const double fractions[][2] = {{0.1, 0.1}, {0.0, 0.25}, {0.3, 0.0}, {0.001, 0.001}, {0.6, 0.6}, {1.0, 0.5}};
+    std::vector<size_t> indices;
+    for (const auto& f : fractions) {
+        assert(store.PercentileBand("Rating", f[0], f[1], indices));
+        assert(indices == reference(false, f[0], f[1]));
+        assert(store.PercentileBand("Year", f[0], f[1], indices));
+        assert(indices == reference(true, f[0], f[1]));
+    }
+    // Large enough to be split across threads; the result must not depend on the pool
+    LiteratureStore large;
+    for (size_t i = 0; i < 200000; ++i) {
+        Literature lit;
+        lit.Year = 1900 + static_cast<int>((i * 7919) % 120);
+        lit.Rating = static_cast<double>((i * 104729) % 101) / 10.0;
+        large.Append(lit);
+    }
+    LiteratureStore sortedLarge = large.Select([&large]() {
+        std::vector<size_t> band;
+        large.PercentileBand("Rating", 1.0, 0.0, band);
+        return band;
+    }());
+    ThreadPool single(1), three(3);
+    const double largeFractions[][2] = {{0.1, 0.1}, {0.0, 0.01}, {0.5, 0.5}, {0.9, 0.05}};
+    for (const LiteratureStore* data : {&large, &sortedLarge}) {
+        for (const auto& f : largeFractions) {
+            std::vector<size_t> serial, parallel;
+            assert(data->PercentileBand("Rating", f[0], f[1], serial, single));
+            assert(data->PercentileBand("Rating", f[0], f[1], parallel, three));
+            assert(parallel == serial);
+            assert(data->PercentileBand("Year", f[0], f[1], serial, single));
+            assert(data->PercentileBand("Year", f[0], f[1], parallel, three));
+            assert(parallel == serial);
+        }
+    }
+
+    assert(!store.PercentileBand("Name", 0.1, 0.1, indices));
+    assert(!store.PercentileBand("Rating", -0.1, 0.1, indices));
+    assert(!store.PercentileBand("Rating", 0.1, 1.5, indices));
+
+    // Execute applies the band; invalid arguments leave the data alone
+    JSONHandler handler;
+    handler.SetStore(store);
+    handler.Execute("Rating", 0.2, 0.0);
+    assert(handler.GetStore().Size() == 100);
+    for (size_t i = 0; i < handler.GetStore().Size(); ++i) {
+        assert(handler.GetStore().Rating(i) <= 1.0);
+    }
+    handler.Execute("Publisher", 0.1, 0.1);
+    assert(handler.GetStore().Size() == 100);
+    handler.SetThreads(2);
+    handler.Execute("Rating", 0.5, 0.0);
+    assert(handler.GetStore().Size() == 50);
+
+    std::cout << " PASSED" << std::endl;
+}
+
+void testRatingIndex() {
+    std::cout << "Test 19: Rating index...";
+
+    assert(RatingIndex::Bucket(0.0) == 0 && RatingIndex::Bucket(7.3) == 73 && RatingIndex::Bucket(10.0) == 100);
+    assert(RatingIndex::Bucket(std::round(7.26 * 10.0) / 10.0) == 73);
+    assert(RatingIndex::Bucket(7.25) == -1 && RatingIndex::Bucket(-0.1) == -1 && RatingIndex::Bucket(10.1) == -1);
+
+    // Indexed and unindexed copies must select the same records after every mutation
+    LiteratureStore indexed;
+    for (int i = 0; i < 3000; ++i) {
+        indexed.AppendJson({{"Name", "Book " + std::to_string(i)}, {"Rating", ((i * 7919) % 101) / 10.0}});
+    }
+    auto agree = [](const LiteratureStore& store) {
+        assert(store.RatingsIndexed());
+        LiteratureStore plain = store;
+        plain.IndexRatings(false);
+        const double fractions[][2] = {{0.1, 0.1}, {0.0, 0.3}, {0.25, 0.0}, {0.7, 0.7}, {1.0, 1.0}};
+        for (const auto& f : fractions) {
+            std::vector<size_t> fromIndex, fromSelection;
+            assert(store.PercentileBand("Rating", f[0], f[1], fromIndex));
+            assert(plain.PercentileBand("Rating", f[0], f[1], fromSelection));
+            assert(fromIndex == fromSelection);
+        }
+    };
+    agree(indexed);
+    size_t before = indexed.MemoryUsage();
+    indexed.PopBack();
+    indexed.PopBack();
+    agree(indexed);
+    indexed.Erase(indexed.Match("Rating", "5.5"));
+    agree(indexed);
+    indexed.AppendAll(indexed.Select({0, 1, 2}));
+    agree(indexed);
+    indexed.IndexRatings(false);
+    assert(indexed.MemoryUsage() < before);
+    indexed.IndexRatings(true);
+    agree(indexed);
+
+    // Off-grid ratings fall back to selection until they are gone
+    indexed.AppendJson({{"Name", "Odd"}, {"Rating", 7.25}});
+    agree(indexed);
+    indexed.PopBack();
+    agree(indexed);
+
+    // Snapshots open without the index; Execute builds it
+    std::string error;
+    assert(LiteratureSnapshot::Save("test_index.lsnap", indexed, error));
+    LiteratureStore mapped;
+    assert(LiteratureSnapshot::Open("test_index.lsnap", mapped, error));
+    assert(!mapped.RatingsIndexed() && !mapped.Freeze().RatingsIndexed());
+    JSONHandler handler;
+    handler.SetStore(mapped);
+    assert(handler.GetStore().IDsIndexed());
+    handler.Execute();
+    assert(handler.GetStore().RatingsIndexed());
+    agree(handler.GetStore());
+
+    std::remove("test_index.lsnap");
+    std::cout << " PASSED" << std::endl;
+}
+
+void testExecuteView() {
+    std::cout << "Test 20: Execute view...";
+
+    JSONHandler handler;
+    handler.Input("test_data.json");
+    handler.Generate_ex(40);
+    json before = handler.GetData();
+
+    // The view selects what Execute keeps, leaving the data alone
+    std::shared_ptr<const BandView> view = handler.ExecuteView("Rating", 0.2, 0.1);
+    assert(view && view->Version == handler.Version());
+    assert(handler.GetData() == before);
+    JSONHandler executed;
+    executed.SetData(before);
+    executed.Execute("Rating", 0.2, 0.1);
+    assert(handler.GetStore().Select(view->Indices).ToJson() == executed.GetData());
+
+    // Cached until the records change, per arguments
+    assert(handler.ExecuteView("Rating", 0.2, 0.1) == view);
+    assert(handler.ExecuteView("Year", 0.2, 0.1) != view);
+    assert(handler.ExecuteView("Name", 0.1, 0.1) == nullptr);
+
+    std::uint64_t version = handler.Version();
+    handler.AddItem({{"Name", "Fresh"}, {"Rating", 10.0}});
+    assert(handler.Version() > version);
+    std::shared_ptr<const BandView> fresh = handler.ExecuteView("Rating", 0.2, 0.1);
+    assert(fresh != view && fresh->Version == handler.Version());
+    assert(handler.GetStore().Name(fresh->Indices.back()) == "Fresh");
+    handler.Delete("Name", "Fresh");
+    assert(handler.ExecuteView("Rating", 0.2, 0.1) != fresh);
+    assert(view->Indices.size() == executed.GetStore().Size());  // Old views stay usable
+
+    // Concurrent readers share one cached view
+    std::vector<std::thread> readers;
+    std::vector<std::shared_ptr<const BandView>> seen(4);
+    for (int t = 0; t < 4; ++t) {
+        readers.emplace_back([&handler, &seen, t]() { seen[t] = handler.ExecuteView(); });
+    }
+    for (auto& reader : readers) reader.join();
+    for (const auto& result : seen) assert(result == seen[0]);
+
+    std::cout << " PASSED" << std::endl;
+}
+
+void testRecordPredicate() {
+    std::cout << "Test 21: Record predicates...";
+
+    LiteratureStore store = LiteratureStore::FromJson(json::array({
+        {{"Author", {"Leo Tolstoy"}}, {"Name", "War and Peace"}, {"Year", 1869}, {"Publisher", "Penguin"}, {"Rating", 9.1}},
+        {{"Author", {"Ilf", "Petrov"}}, {"Name", "The Twelve Chairs"}, {"Year", 1928}, {"Publisher", "Dover"}, {"Rating", 7.0}},
+        {{"Name", "Untitled"}, {"Rating", 3.0}},
+        {{"Author", {"Nikolai Gogol"}}, {"Name", "Dead Souls"}, {"Year", 1842}, {"Publisher", "Dover"}, {"Rating", 8.5}}
+    }));
+    auto run = [&store](const std::string& condition) {
+        RecordPredicate predicate;
+        std::string error;
+        bool compiled = RecordPredicate::Compile(condition, predicate, error);
+        assert(compiled);
+        std::vector<bool> flags = predicate.Evaluate(store);
+        std::string pattern;
+        for (std::size_t i = 0; i < flags.size(); ++i) {
+            assert(flags[i] == predicate.Matches(store, i));
+            pattern += flags[i] ? '1' : '0';
+        }
+        return pattern;
+    };
+
+    // Typed comparisons; records without the field never match
+    assert(run("Year = 1869") == "1000");
+    assert(run("Year != 1869") == "0101");
+    assert(run("Year<1900") == "1001");
+    assert(run("Rating >= 8.5") == "1001");
+    assert(run("Rating > 8.5") == "1000");
+    assert(run("Rating = 7.0004") == "0100");
+    assert(run("Publisher = \"Dover\"") == "0101");
+    assert(run("Name < 'E'") == "0001");
+    assert(run("Author = Petrov") == "0100");
+    assert(run("Author != 'Leo Tolstoy'") == "0101");
+
+    // Ranges and compound conditions
+    assert(run("Year BETWEEN 1842 AND 1869") == "1001");
+    assert(run("Rating between 3 and 7") == "0110");
+    assert(run("Publisher = Dover AND Rating > 8") == "0001");
+    assert(run("Year < 1850 OR Rating < 5") == "0011");
+    assert(run("(Year = 1869 || Year = 1928) && Rating > 8") == "1000");
+    assert(run("Name = Untitled OR Publisher = Dover AND Year > 1900") == "0110");
+
+    // Errors are reported while compiling
+    RecordPredicate predicate;
+    std::string error;
+    assert(!RecordPredicate::Compile("Year = soon", predicate, error) && !error.empty());
+    assert(!RecordPredicate::Compile("Colour = red", predicate, error));
+    assert(!RecordPredicate::Compile("Author < B", predicate, error));
+    assert(!RecordPredicate::Compile("Year > 1900 AND", predicate, error));
+    assert(!RecordPredicate::Compile("(Year > 1900", predicate, error));
+    assert(!RecordPredicate::Compile("Name = 'open", predicate, error));
+    // Nesting is bounded, so a hostile condition cannot exhaust the stack
+    const std::size_t limit = RecordPredicate::kMaxNesting;
+    assert(RecordPredicate::Compile(std::string(limit, '(') + "Year = 1" + std::string(limit, ')'), predicate, error));
+    error.clear();
+    assert(!RecordPredicate::Compile(std::string(200000, '(') + "Year = 1" + std::string(200000, ')'), predicate,
+                                     error) && error.find("nested") != std::string::npos);
+    assert(RecordPredicate::Equals("Year", "abc").Evaluate(store) == std::vector<bool>(4, false));
+    assert(store.Match("Author", "Ilf") == std::vector<bool>({false, true, false, false}));
+
+    // Delete through the handler
+    JSONHandler handler;
+    handler.SetData(store.ToJson());
+    assert(!handler.DeleteWhere("Year >"));
+    assert(handler.GetStore().Size() == 4);
+    assert(handler.DeleteWhere("Publisher = Dover AND Rating < 8"));
+    assert(handler.GetStore().Size() == 3 && handler.GetStore().Name(1) == "Untitled");
+    handler.Delete("Author", "Leo Tolstoy");
+    assert(handler.GetStore().Size() == 2);
+
+    std::cout << " PASSED" << std::endl;
+}
+
+void testSecondaryIndexes() {
+    std::cout << "Test 22: Secondary indexes...";
+
+    LiteratureStore plain;
+    for (int i = 0; i < 3000; ++i) {
+        Literature lit;
+        lit.Author = {"Author " + std::to_string(i % 17)};
+        lit.Name = "Book " + std::to_string(i % 500);
+        lit.Year = 1800 + (i * 7) % 225;
+        lit.Publisher = "Publisher " + std::to_string(i % 13);
+        lit.Rating = (i * 31 % 101) / 10.0;
+        plain.Append(lit, "", i % 50 == 0 ? LiteratureStore::kName : LiteratureStore::kLiteratureFields);
+    }
+    LiteratureStore indexed = plain;
+    indexed.IndexFields(LiteratureStore::kIndexableFields | LiteratureStore::kID);
+    assert(indexed.IndexedFields() == LiteratureStore::kIndexableFields);
+    assert(indexed.IndexMemoryUsage() > 0 && plain.IndexMemoryUsage() == 0);
+
+    // Positions past the 32-bit posting entries stay out of the lists instead of wrapping
+    TextIndex text;
+    OrderedIndex<int> years;
+    text.Add(3, "Near");
+    text.Add(kMaxPostingRecord + 1, "Far");
+    years.Add(kMaxPostingRecord + 4, 1900);
+    std::vector<std::size_t> far;
+    years.Collect(0, 3000, [](int) { return true; }, far);
+    assert(text.Find("Far") == nullptr && text.Find("Near")->size() == 1 && far.empty());
+    text.RemoveLast(kMaxPostingRecord + 1, "Far");
+    assert(text.Find("Near")->size() == 1);
+    AuthorIndex people;
+    people.Add(5, "Gogol");
+    people.Add(kMaxPostingRecord + 2, "Gogol");
+    people.RemoveLast(kMaxPostingRecord + 2, "Gogol");
+    assert(people.Find("Gogol")->size() == 1 && people.Find("Gogol")->back() == 5);
+
+    // Indexed answers equal the scans, whichever path a condition takes
+    const char* conditions[] = {
+        "Publisher = 'Publisher 3'", "Name = 'Book 42'", "Name = missing", "Year = 1850", "Year < 1810",
+        "Year >= 2020", "Year BETWEEN 1900 AND 1910", "Rating = 5", "Rating > 9.5", "Rating <= 0.2",
+        "Rating BETWEEN 2.95 AND 3.05", "Publisher = 'Publisher 1' AND Year > 1900",
+        "Year = 1850 OR Publisher = 'Publisher 2'", "Publisher = 'Publisher 1' OR Year != 1900",
+        "Year > 2000 AND Author = 'Author 3'", "Year != 1900",
+    };
+    auto check = [&conditions](const LiteratureStore& a, const LiteratureStore& b) {
+        for (const char* condition : conditions) {
+            RecordPredicate predicate;
+            std::string error;
+            bool compiled = RecordPredicate::Compile(condition, predicate, error);
+            assert(compiled);
+            assert(predicate.Evaluate(a) == predicate.Evaluate(b));
+            assert(predicate.Find(a) == predicate.Find(b));
+        }
+    };
+    check(plain, indexed);
+
+    // Every mutation keeps the indexes current
+    Literature extra;
+    extra.Name = "Book 42";
+    extra.Year = 1850;
+    extra.Publisher = "Publisher 3";
+    extra.Rating = 5.0;
+    plain.Append(extra);
+    indexed.Append(extra);
+    check(plain, indexed);
+    plain.PopBack();
+    indexed.PopBack();
+    check(plain, indexed);
+    plain.Erase(plain.Match("Publisher", "Publisher 4"));
+    indexed.Erase(indexed.Match("Publisher", "Publisher 4"));
+    check(plain, indexed);
+    std::vector<std::size_t> picked;
+    for (std::size_t i = 0; i < plain.Size(); i += 3) picked.push_back(i);
+    LiteratureStore plainPicked = plain.Select(picked);
+    LiteratureStore indexedPicked = indexed.Select(picked);
+    assert(indexedPicked.IndexedFields() == indexed.IndexedFields());
+    check(plainPicked, indexedPicked);
+    plainPicked.AppendAll(plain);
+    indexedPicked.AppendAll(plain);
+    check(plainPicked, indexedPicked);
+    assert(indexed.Freeze().IndexedFields() == 0);
+    indexed.IndexFields(LiteratureStore::kYear);
+    check(plain, indexed);
+    indexed.IndexFields(0);
+    assert(indexed.IndexMemoryUsage() == 0);
+
+    // The handler keeps its choice across loads and answers queries from it
+    JSONHandler handler;
+    assert(handler.IndexField("Publisher") && handler.IndexField("Year"));
+    assert(!handler.IndexField("ID") && !handler.IndexField("Colour"));
+    handler.SetData(plain.ToJson());
+    assert(handler.GetStore().IndexedFields() == (LiteratureStore::kPublisher | LiteratureStore::kYear));
+    std::vector<std::size_t> positions;
+    assert(handler.Query("Publisher = 'Publisher 5' AND Year < 1900", positions));
+    std::vector<std::size_t> expected;
+    for (std::size_t i = 0; i < plain.Size(); ++i) {
+        if (plain.Has(i, LiteratureStore::kPublisher) && plain.Publisher(i) == "Publisher 5" && plain.Year(i) < 1900) {
+            expected.push_back(i);
+        }
+    }
+    assert(!expected.empty() && positions == expected);
+    assert(handler.DeleteWhere("Year < 1900"));
+    assert(handler.Query("Year < 1900", positions) && positions.empty());
+    assert(!handler.Query("Year <", positions));
+    handler.IndexField("Year", false);
+    assert(handler.GetStore().IndexedFields() == LiteratureStore::kPublisher);
+
+    std::cout << " PASSED" << std::endl;
+}
+
+void testIdIndex() {
+    std::cout << "Test 23: ID hash index...";
+
+    // Raw table: duplicates resolve to the first record, removals keep chains intact
+    std::vector<std::string> keys;
+    for (int i = 0; i < 5000; ++i) {
+        keys.push_back("LIT" + std::to_string(i % 3700) + "AB");
+    }
+    auto key = [&keys](std::size_t i) { return std::string_view(keys[i]); };
+    auto scan = [&keys](std::size_t size, const std::string& id) {
+        for (std::size_t i = 0; i < size; ++i) {
+            if (keys[i] == id) return i;
+        }
+        return IdIndex::kNotFound;
+    };
+    IdIndex table;
+    for (std::size_t i = 0; i < keys.size(); ++i) table.Add(i, keys[i]);
+    std::size_t size = keys.size();
+    while (size > 1000) {
+        for (int probe = 0; probe < 3700; probe += 97) {
+            std::string id = "LIT" + std::to_string(probe) + "AB";
+            assert(table.Find(id, key) == scan(size, id));
+        }
+        for (int k = 0; k < 700; ++k) {
+            --size;
+            table.RemoveLast(size, keys[size]);
+        }
+    }
+    assert(table.Size() == size && table.Find("missing", key) == IdIndex::kNotFound);
+
+    // Positions past the 32-bit slots are scanned rather than truncated
+    IdIndex wide;
+    const std::size_t far = IdIndex::kMaxRecord + 3;
+    auto farKey = [far](std::size_t i) { return std::string_view(i == far ? "LIT001FAR" : i == 7 ? "LIT007AB" : ""); };
+    wide.Add(7, "LIT007AB");
+    wide.Add(far, "LIT001FAR");
+    assert(wide.Size() == 1 && wide.Find("LIT001FAR", farKey) == far && wide.Find("LIT007AB", farKey) == 7);
+    wide.RemoveLast(far, "LIT001FAR");
+    assert(wide.Find("LIT001FAR", farKey) == IdIndex::kNotFound);
+
+    // The store keeps the index through every mutation
+    JSONHandler handler;
+    handler.Input("test_data.json");
+    handler.Generate_ex(30);
+    LiteratureStore store = handler.GetStore();
+    auto check = [](const LiteratureStore& s) {
+        assert(s.IDsIndexed());
+        for (std::size_t i = 0; i < s.Size(); ++i) {
+            if (s.Has(i, LiteratureStore::kID)) {
+                std::size_t found = s.FindID(s.ID(i));
+                assert(found <= i && s.ID(found) == s.ID(i));
+            }
+        }
+    };
+    check(store);
+    std::size_t first = 0;
+    while (!store.Has(first, LiteratureStore::kID)) ++first;  // test_data.json records carry no ID
+    store.AppendJson({{"Name", "Twin"}, {"ID", std::string(store.ID(first))}});
+    assert(store.FindID(store.ID(first)) == first);
+    store.PopBack();
+    store.Erase(store.Match("ID", std::string(store.ID(first + 3))));
+    check(store);
+    LiteratureStore picked = store.Select({first + 5, first + 1, first + 7});
+    check(picked);
+    assert(picked.FindID(store.ID(first + 7)) == 2);
+    picked.AppendAll(store);
+    check(picked);
+
+    // Snapshots open without it, look up by scanning, and build it on the first change
+    handler.SaveSnapshot("test_ids.lsnap");
+    LiteratureStore mapped;
+    std::string error;
+    assert(LiteratureSnapshot::Open("test_ids.lsnap", mapped, error));
+    assert(!mapped.IDsIndexed() && mapped.FindID(store.ID(first + 2)) != IdIndex::kNotFound);
+    mapped.AppendJson({{"Name", "Late"}, {"ID", "LIT999LAT"}});
+    check(mapped);
+    assert(mapped.FindID("LIT999LAT") == mapped.Size() - 1);
+    std::remove("test_ids.lsnap");
+
+    // Multi-get and collision-free generated IDs
+    std::string known(handler.GetStore().ID(first));
+    json items = handler.GetByIDs({known, "LIT000ZZZ", "bad id", known});
+    assert(items.size() == 4 && items[0]["ID"] == known && items[1].is_null() && items[2].is_null());
+    assert(items[3] == items[0]);
+    JSONHandler fresh;
+    fresh.SetData(json::array({{{"Name", "War"}, {"ID", "LIT001WAR"}}, {{"Name", "War"}, {"ID", "LIT002WAR"}}}));
+    assert(fresh.GenerateID("War") == "LIT003WAR");
+
+    std::cout << " PASSED" << std::endl;
+}
+
+void testIdValidation() {
+    std::cout << "Test 24: ID validation and batch resolve...";
+
+    // Every boundary of the format: digits, canonical spelling, suffix
+    for (const char* id : {"LIT000A", "LIT999ZZZ", "LIT123AB", "LIT1234AB", "LIT9999999999999999999Z"}) {
+        assert(IsLiteratureID(id));
+    }
+    for (const char* id : {"", "LIT", "LIT001", "LIT01A", "LIT01234AB", "LIT001ABCD", "LIT0a1AB", "LIT001aB",
+                           "LIT10000000000000000000A", "lit001AB", "LIX001AB", "LIT001A1", "LIT001@", "LIT001["}) {
+        assert(!IsLiteratureID(id));
+    }
+    assert(!IsLiteratureID(std::string_view("LIT001AB\0", 9)));
+
+    JSONHandler handler;
+    handler.SetData(json::array({{{"Name", "War"}, {"ID", "LIT001WAR"}}, {{"Name", "Anna"}, {"ID", "LIT002ANN"}}}));
+    std::vector<std::size_t> positions;
+    std::size_t valid = handler.ResolveIDs({"LIT002ANN", "LIT003XYZ", "nope", "LIT001WAR"}, positions);
+    assert(valid == 3 && positions.size() == 4);
+    assert(positions[0] == 1 && positions[1] == IdIndex::kNotFound && positions[2] == IdIndex::kNotFound);
+    assert(positions[3] == 0);
+    assert(handler.ResolveIDs({}, positions) == 0 && positions.empty());
+
+    std::cout << " PASSED" << std::endl;
+}
+
+void testIdAllocator() {
+    std::cout << "Test 25: ID allocator...";
+
+    // Stream-free formatting, wider than three digits, always valid
+    assert(FormatLiteratureID(7, "War and Peace") == "LIT007WAR");
+    assert(FormatLiteratureID(1234, "anna") == "LIT1234ANN");
+    assert(FormatLiteratureID(5, "1984") == "LIT005X" && FormatLiteratureID(5, "A Tale") == "LIT005ATA");
+    for (std::uint64_t number : {0ULL, 999ULL, 1000ULL, 123456789ULL, 9999999999999999999ULL}) {
+        std::uint64_t parsed = 0;
+        assert(ParseLiteratureID(FormatLiteratureID(number, "Dead Souls"), parsed) && parsed == number);
+    }
+
+    // Concurrent single numbers and leased blocks never overlap
+    IdAllocator allocator;
+    std::vector<std::vector<std::uint64_t>> taken(4);
+    std::vector<std::thread> threads;
+    for (std::size_t t = 0; t < taken.size(); ++t) {
+        threads.emplace_back([&allocator, &taken, t]() {
+            for (int round = 0; round < 200; ++round) {
+                taken[t].push_back(allocator.Next());
+                IdAllocator::Block block = allocator.Lease(16);
+                while (!block.Empty()) taken[t].push_back(block.Take());
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    std::vector<std::uint64_t> all;
+    for (const auto& numbers : taken) all.insert(all.end(), numbers.begin(), numbers.end());
+    std::sort(all.begin(), all.end());
+    assert(all.size() == 4 * 200 * 17 && std::adjacent_find(all.begin(), all.end()) == all.end());
+    assert(all.front() == 1 && allocator.Peek() == all.back() + 1);
+
+    // The counter never leaves the range FormatLiteratureID() can write
+    IdAllocator top;
+    top.Observe("LIT9999999999999999999WAR");
+    assert(top.Peek() == 1);
+    top.Observe("LIT9999999999999999998WAR");
+    assert(top.Peek() == kMaxIdNumber && IsLiteratureID(FormatLiteratureID(top.Next(), "War")));
+
+    // Loaded and added IDs are skipped, past 999 the IDs stay valid and unique
+    JSONHandler handler;
+    handler.SetData(json::array({{{"Name", "War"}, {"ID", "LIT500WAR"}}}));
+    assert(handler.GenerateID("War") == "LIT501WAR");
+    handler.AddItem({{"Name", "Anna"}, {"ID", "LIT998ANN"}});
+    handler.Generate_ex(1200);
+    std::set<std::string> unique;
+    const LiteratureStore& store = handler.GetStore();
+    for (std::size_t i = 0; i < store.Size(); ++i) {
+        assert(handler.ValidateID(std::string(store.ID(i))));
+        unique.insert(std::string(store.ID(i)));
+    }
+    assert(unique.size() == store.Size());
+
+    // The persisted mark survives a restart even when the records are gone
+    std::remove("test_ids.state");
+    std::uint64_t last = 0;
+    {
+        IdAllocator first;
+        std::string error;
+        assert(first.Persist("test_ids.state", error));
+        for (int i = 0; i < 5000; ++i) last = first.Next();
+        assert(first.LastError().empty());
+    }
+    IdAllocator restarted;
+    std::string error;
+    assert(restarted.Persist("test_ids.state", error) && restarted.Next() > last);
+    std::ofstream("test_ids.state") << "garbage";
+    IdAllocator broken;
+    assert(!broken.Persist("test_ids.state", error) && !error.empty());
+    std::ofstream("test_ids.state") << "18446744073709551615";
+    IdAllocator beyond;
+    assert(!beyond.Persist("test_ids.state", error));
+    std::remove("test_ids.state");
+
+    std::cout << " PASSED" << std::endl;
+}
+
+void testTombstones() {
+    std::cout << "Test 26: Tombstone deletes...";
+
+    LiteratureStore store;
+    for (int i = 0; i < 100; ++i) {
+        Literature lit;
+        lit.Author = {"Author " + std::to_string(i % 7)};
+        lit.Name = "Book " + std::to_string(i);
+        lit.Year = 1900 + i;
+        lit.Publisher = "Publisher " + std::to_string(i % 5);
+        lit.Rating = (i % 11) / 1.0;
+        store.Append(lit, FormatLiteratureID(i + 1, lit.Name));
+    }
+    store.IndexFields(LiteratureStore::kIndexableFields);
+
+    // Deleting only marks: slots, positions and the other records stay put
+    std::vector<std::size_t> doomed;
+    for (std::size_t i = 0; i < 100; i += 4) doomed.push_back(i);
+    assert(store.Delete(doomed) == 25 && store.Delete({0, 4}) == 0);
+    assert(store.Size() == 100 && store.Count() == 75 && store.Deleted() == 25);
+    assert(!store.Live(0) && store.Live(1) && store.Name(1) == "Book 1");
+
+    // Every reader skips the deleted records
+    assert(store.ToJson().size() == 75);
+    assert(store.FindID(FormatLiteratureID(1, "Book 0")) == IdIndex::kNotFound);
+    assert(store.FindID(FormatLiteratureID(2, "Book 1")) == 1);
+    std::vector<std::size_t> positions;
+    assert(store.IndexLookup(LiteratureStore::kPublisher, "Publisher 0", positions));
+    for (std::size_t i : positions) assert(store.Live(i));
+    assert(positions.size() == 15);
+    RecordPredicate predicate;
+    std::string error;
+    assert(RecordPredicate::Compile("Year < 1910", predicate, error));
+    assert(predicate.Find(store).size() == 7);
+    std::vector<std::size_t> band;
+    assert(store.PercentileBand("Year", 0.1, 0.0, band));
+    assert(band.size() == 7 && band.front() == 1 && band.back() == 9);
+    for (std::size_t i : band) assert(store.Live(i));
+
+    // A snapshot holds only the live records
+    std::stringstream snapshot;
+    assert(LiteratureSnapshot::Write(snapshot, store));
+    std::string bytes = snapshot.str();
+    std::ofstream("test_tombstones.snap", std::ios::binary) << bytes;
+    LiteratureStore reopened;
+    assert(LiteratureSnapshot::Open("test_tombstones.snap", reopened, error, true));
+    assert(reopened.Size() == 75 && reopened.Deleted() == 0 && reopened.Name(0) == "Book 1");
+    std::remove("test_tombstones.snap");
+
+    // Compaction reclaims the slots in order and keeps the indexes right
+    assert(store.Compact() == 25 && store.Compact() == 0);
+    assert(store.Size() == 75 && store.Deleted() == 0 && store.Name(0) == "Book 1");
+    assert(store.FindID(FormatLiteratureID(2, "Book 1")) == 0);
+    positions.clear();
+    assert(store.IndexLookup(LiteratureStore::kPublisher, "Publisher 0", positions) && positions.size() == 15);
+
+    // Popping a deleted record takes its tombstone along
+    store.Delete({store.Size() - 1});
+    store.PopBack();
+    assert(store.Size() == 74 && store.Deleted() == 0);
+
+    // The handler compacts once the deleted share reaches its ratio
+    JSONHandler handler;
+    json data = json::array();
+    for (int i = 0; i < 10; ++i) {
+        data.push_back({{"Name", "Book " + std::to_string(i)}, {"Year", 1900 + i}, {"Rating", 5.0}});
+    }
+    handler.SetData(data);
+    handler.SetCompactionRatio(0.5);
+    assert(handler.DeleteWhere("Year < 1904"));
+    assert(handler.GetStore().Size() == 10 && handler.GetStore().Count() == 6);
+    handler.Delete("Name", "Book 4");
+    assert(handler.GetStore().Size() == 5 && handler.GetStore().Deleted() == 0);
+    handler.SetCompactionRatio(1.0);
+    handler.Delete("Year", "1905");
+    assert(handler.GetStore().Size() == 5 && handler.GetStore().Count() == 4);
+    assert(handler.GetData().size() == 4);
+    assert(handler.Compact() == 1 && handler.GetStore().Size() == 4);
+    handler.SetCompactionRatio(7.0);
+    assert(handler.CompactionRatio() == 1.0);
+
+    std::cout << " PASSED" << std::endl;
+}
+
+void testAuthorIndex() {
+    std::cout << "Test 27: Author index...";
+
+    LiteratureStore plain;
+    for (int i = 0; i < 2000; ++i) {
+        Literature lit;
+        lit.Author = {"Author " + std::to_string(i % 11)};
+        if (i % 3 == 0) lit.Author.push_back("Author " + std::to_string(i % 7));
+        if (i % 5 == 0) lit.Author.push_back(lit.Author[0]);  // Repeated name, listed once
+        lit.Name = "Book " + std::to_string(i);
+        lit.Year = 1900 + i % 100;
+        plain.Append(lit, "", i % 40 == 0 ? LiteratureStore::kName : LiteratureStore::kLiteratureFields);
+    }
+    LiteratureStore indexed = plain;
+    indexed.IndexFields(LiteratureStore::kAuthor);
+    assert(indexed.IndexedFields() == LiteratureStore::kAuthor && indexed.IndexMemoryUsage() > 0);
+
+    // Membership, intersections and mixed conditions agree with the scans
+    const char* conditions[] = {
+        "Author = 'Author 3'", "Author = 'Author 3' AND Author = 'Author 5'", "Author = 'Author 3' AND Author = 'Author 3'",
+        "Author = 'Author 3' AND Author = nobody", "Author = 'Author 2' AND Year < 1950",
+        "Author = 'Author 1' OR Author = 'Author 4'", "Author != 'Author 3'", "Author = nobody",
+    };
+    for (const char* condition : conditions) {
+        RecordPredicate predicate;
+        std::string error;
+        assert(RecordPredicate::Compile(condition, predicate, error));
+        std::vector<bool> flags = predicate.Evaluate(plain);
+        std::vector<std::size_t> scanned;
+        for (std::size_t i = 0; i < flags.size(); ++i) {
+            if (flags[i]) scanned.push_back(i);
+        }
+        assert(predicate.Find(indexed) == scanned && predicate.Evaluate(indexed) == flags);
+    }
+    std::vector<std::size_t> both;
+    assert(indexed.AuthorLookup({"Author 3", "Author 5"}, both) && !both.empty());
+    assert(!plain.AuthorLookup({"Author 3"}, both));
+    assert(RecordPredicate::Authors({"Author 3", "Author 5"}).Find(indexed) == both);
+    assert(RecordPredicate::Authors({}).Find(indexed).empty());
+
+    // Popping and deleting keep the posting lists exact
+    std::vector<std::size_t> before, after;
+    indexed.IndexLookup(LiteratureStore::kAuthor, "Author 9", before);
+    Literature extra;
+    extra.Author = {"Author 9", "Author 9", "Newcomer"};
+    indexed.Append(extra);
+    indexed.IndexLookup(LiteratureStore::kAuthor, "Author 9", after);
+    assert(after.size() == before.size() + 1 && after.back() == indexed.Size() - 1);
+    indexed.PopBack();
+    indexed.IndexLookup(LiteratureStore::kAuthor, "Author 9", after);
+    assert(after == before);
+    assert(indexed.IndexLookup(LiteratureStore::kAuthor, "Newcomer", after) && after.empty());
+    indexed.Delete({before[0]});
+    indexed.IndexLookup(LiteratureStore::kAuthor, "Author 9", after);
+    assert(after.size() == before.size() - 1 && after[0] == before[1]);
+
+    // Handler: takedowns and queries by author, indexed or not
+    for (bool index : {false, true}) {
+        JSONHandler handler;
+        json data = json::array();
+        for (int i = 0; i < 30; ++i) {
+            json authors = json::array({"Author " + std::to_string(i % 3)});
+            if (i % 2 == 0) authors.push_back("Editor");
+            data.push_back({{"Author", authors}, {"Name", "Book " + std::to_string(i)}, {"Year", 1900 + i}});
+        }
+        handler.SetData(data);
+        if (index) assert(handler.IndexField("Author"));
+        assert(handler.QueryAuthors({"Author 1", "Editor"}).size() == 5);
+        assert(handler.DeleteByAuthors({"Author 1", "Editor"}) == 5);
+        assert(handler.QueryAuthors({"Author 1"}).size() == 5);
+        assert(handler.DeleteByAuthors({"Author 0"}) == 10 && handler.GetData().size() == 15);
+        assert(handler.QueryAuthors({"Author 0"}).empty() && handler.DeleteByAuthors({}) == 0);
+    }
+
+    std::cout << " PASSED" << std::endl;
+}
+
+void testParallelGenerate() {
+    std::cout << "Test 28: Parallel generation...";
+
+    // The generator is deterministic per seed and stays in range
+    FastRandom a(99), b(99), c(100);
+    bool differs = false;
+    for (int i = 0; i < 1000; ++i) {
+        std::uint64_t x = a.Next();
+        assert(x == b.Next());
+        differs = differs || x != c.Next();
+        assert(a.Below(7) < 7 && b.Below(7) < 7);
+        double unit = a.Unit();
+        assert(unit >= 0.0 && unit < 1.0 && unit == b.Unit());
+    }
+    assert(differs);
+
+    // Chunks run in parallel; records and IDs do not depend on the thread count
+    ThreadPool one(1), four(4);
+    IdAllocator firstIds, secondIds;
+    LiteratureStore first, second;
+    GenerateLiterature(50000, 7, firstIds, first, one);
+    GenerateLiterature(50000, 7, secondIds, second, four);
+    assert(first.Size() == 50000 && first.ToJson() == second.ToJson());
+    std::uint64_t previous = 0;
+    for (std::size_t i = 0; i < first.Size(); ++i) {
+        std::uint64_t number = 0;
+        assert(ParseLiteratureID(first.ID(i), number) && number > previous);
+        previous = number;
+        assert(first.AuthorCount(i) >= 1 && first.AuthorCount(i) <= 3);
+        assert(first.Year(i) >= 1800 && first.Year(i) <= 2024);
+        assert(first.Rating(i) >= 0.0 && first.Rating(i) <= 10.0);
+        assert(first.FindID(first.ID(i)) == i);
+    }
+
+    // IDs already in the target are skipped even if the allocator never saw them
+    LiteratureStore taken;
+    Literature lit;
+    lit.Name = "War and Peace";
+    for (std::uint64_t number = 1; number <= 50; ++number) {
+        taken.Append(lit, FormatLiteratureID(number, lit.Name));
+    }
+    IdAllocator fresh;
+    GenerateLiterature(1000, 1, fresh, taken, four);
+    std::set<std::string> unique;
+    for (std::size_t i = 0; i < taken.Size(); ++i) {
+        unique.insert(std::string(taken.ID(i)));
+    }
+    assert(taken.Size() == 1050 && unique.size() == 1050);
+
+    // The handler appends the batch at once and keeps numbering above it
+    JSONHandler handler;
+    handler.SetThreads(3);
+    handler.Generate_ex(40000);
+    handler.Generate();
+    const LiteratureStore& store = handler.GetStore();
+    assert(store.Size() == 40001);
+    std::uint64_t last = 0, batchLast = 0;
+    assert(ParseLiteratureID(store.ID(40000), last) && ParseLiteratureID(store.ID(39999), batchLast));
+    assert(last > batchLast);
+
+    std::cout << " PASSED" << std::endl;
+}
+
+void testWorkloadGenerator() {
+    std::cout << "Test 29: Workload generator...";
+
+    // Defaults, overrides and rejected specs
+    WorkloadSpec spec;
+    std::string error;
+    std::ofstream("test_authors.txt") << "Leo Tolstoy\r\n\nAnton Chekhov\nIvan Bunin\n";
+    json config = {{"Seed", 2024},
+                   {"Authors", {{"File", "test_authors.txt"}, {"Skew", 1.2}}},
+                   {"Publishers", {{"Count", 50}, {"Skew", 1.5}}},
+                   {"AuthorsPerRecord", {0.0, 1.0}},
+                   {"Years", {{{"Min", 1850}, {"Max", 1859}, {"Weight", 1}}, {{"Min", 2000}, {"Max", 2000}, {"Weight", 3}}}},
+                   {"Rating", {{"Shape", "bimodal"}, {"Mean", 8}, {"StdDev", 0.5}, {"Mean2", 2}, {"StdDev2", 0.5},
+                               {"Weight2", 0.3}}}};
+    assert(WorkloadSpec::FromJson(config, spec, error));
+    assert(spec.Seed == 2024 && spec.Authors.Words.size() == 3 && spec.Authors.Words[0] == "Leo Tolstoy");
+    assert(spec.Names.Count == 100000 && spec.Rating == WorkloadSpec::RatingShape::Bimodal);
+    WorkloadSpec untouched;
+    for (const char* bad : {R"({"Rating": {"Shape": "cauchy"}})", R"({"Years": [{"Min": 2000, "Max": 1990}]})",
+                            R"({"Names": {"Count": 4294967296}})", R"({"Authors": {"Count": 100000000, "Skew": 1}})",
+                            R"({"AuthorsPerRecord": [0, 0]})", R"({"Authors": {"File": "missing_words.txt"}})",
+                            R"({"Names": {"Count": 0}})", R"({"Seed": "x"})", "[1]"}) {
+        assert(!WorkloadSpec::FromJson(json::parse(bad), untouched, error) && !error.empty());
+        assert(untouched.Seed == 1);
+    }
+    std::remove("test_authors.txt");
+
+    // Every record depends only on (seed, index), and follows the distributions
+    WorkloadGenerator workload(spec);
+    Literature a, b;
+    workload.Record(12345, a);
+    workload.Record(7, b);
+    workload.Record(12345, b);
+    assert(a.Name == b.Name && a.Author == b.Author && a.Year == b.Year && a.Rating == b.Rating);
+    std::size_t tolstoy = 0, bunin = 0, recent = 0, low = 0, publisher1 = 0;
+    const int n = 20000;
+    for (int i = 0; i < n; ++i) {
+        workload.Record(i, a);
+        assert(a.Author.size() == 2 && (a.Year == 2000 || (a.Year >= 1850 && a.Year <= 1859)));
+        assert(a.Rating >= 0.0 && a.Rating <= 10.0 && std::abs(a.Rating * 10 - std::round(a.Rating * 10)) < 1e-9);
+        assert(a.Rating < 4.5 || a.Rating > 5.5);  // Two modes, nothing in between
+        tolstoy += a.Author[0] == "Leo Tolstoy";
+        bunin += a.Author[0] == "Ivan Bunin";
+        recent += a.Year == 2000;
+        low += a.Rating < 5.0;
+        publisher1 += a.Publisher == "Publisher 1";
+    }
+    assert(tolstoy > 2 * bunin && std::abs(static_cast<double>(recent) / n - 0.75) < 0.02);
+    assert(std::abs(static_cast<double>(low) / n - 0.3) < 0.02 && publisher1 > n / 5);
+
+    // The widest year range does not overflow into a single year
+    WorkloadSpec wide;
+    assert(WorkloadSpec::FromJson(json::parse(R"({"Years": [{"Min": -2147483648, "Max": 2147483647}]})"), wide, error));
+    WorkloadGenerator widest(wide);
+    std::set<int> spread;
+    for (int i = 0; i < 100; ++i) {
+        widest.Record(i, a);
+        spread.insert(a.Year);
+    }
+    assert(spread.size() > 90);
+
+    // Same spec, same dataset, whatever the threads; another seed differs
+    ThreadPool one(1), three(3);
+    IdAllocator firstIds, secondIds, thirdIds;
+    LiteratureStore first, second, third;
+    GenerateWorkload(workload, 40000, firstIds, first, one);
+    GenerateWorkload(WorkloadGenerator(spec), 40000, secondIds, second, three);
+    spec.Seed = 2025;
+    GenerateWorkload(WorkloadGenerator(spec), 40000, thirdIds, third, three);
+    assert(first.Size() == 40000 && first.ToJson() == second.ToJson() && first.ToJson() != third.ToJson());
+
+    JSONHandler handler;
+    handler.GenerateWorkload(WorkloadSpec(), 1000);
+    assert(handler.GetStore().Size() == 1000 && handler.GetStore().Name(0).rfind("Title ", 0) == 0);
+
+    std::cout << " PASSED" << std::endl;
+}
+
+void testStreamLiterature() {
+    std::cout << "Test 30: Streaming generator...";
+
+    // Every format streams the bytes WriteLiterature() gives for the same records in memory
+    ThreadPool two(2);
+    IdAllocator ids;
+    LiteratureStore generated;
+    GenerateLiterature(40000, 11, ids, generated, two);
+    auto sample = [](std::size_t, FastRandom& random, Literature& lit) { SampleLiterature(random, lit); };
+    for (DataFormat format : {DataFormat::Json, DataFormat::NDJSON, DataFormat::Cbor, DataFormat::MessagePack,
+                              DataFormat::Ubjson}) {
+        std::ostringstream expected, streamed;
+        WriteLiterature(expected, generated, format);
+        StreamOptions options;
+        options.Depth = 1;
+        std::size_t calls = 0;
+        options.Progress = [&calls](const StreamStats&) { ++calls; };
+        StreamStats stats = StreamLiterature(streamed, format, 40000, 11, sample, options, two);
+        assert(streamed.str() == expected.str());
+        assert(stats.Records == 40000 && stats.Bytes == expected.str().size() && calls == 3);
+        assert(stats.PeakChunks <= 1 && stats.RecordsPerSecond() > 0.0);
+    }
+    std::ostringstream empty;
+    assert(StreamLiterature(empty, DataFormat::Json, 0, 1, sample).Records == 0 && empty.str() == "[]\n");
+
+    // Small chunks and a workload: the file loads back with the requested IDs
+    WorkloadGenerator workload{WorkloadSpec()};
+    StreamOptions options;
+    options.ChunkRecords = 1000;
+    options.FirstNumber = 500;
+    {
+        std::ofstream file("test_stream.ndjson", std::ios::binary);
+        StreamLiterature(file, DataFormat::NDJSON, 5500, 3, [&workload](std::size_t index, FastRandom&,
+                                                                       Literature& lit) {
+            workload.Record(index, lit);
+        }, options, two);
+    }
+    JSONHandler handler;
+    handler.Input("test_stream.ndjson");
+    const LiteratureStore& loaded = handler.GetStore();
+    Literature expected;
+    workload.Record(5499, expected);
+    assert(loaded.Size() == 5500 && loaded.Get(5499).Name == expected.Name);
+    assert(loaded.ID(0) == FormatLiteratureID(500, loaded.Name(0)) && loaded.ID(5499).rfind("LIT5999", 0) == 0);
+    std::remove("test_stream.ndjson");
+
+    // A failing stream stops the pipeline; a failing filler is rethrown
+    std::ostringstream broken;
+    broken.setstate(std::ios::badbit);
+    assert(StreamLiterature(broken, DataFormat::NDJSON, 100000, 1, sample, StreamOptions(), two).Records == 0);
+    bool thrown = false;
+    try {
+        std::ostringstream sink;
+        StreamLiterature(sink, DataFormat::Json, 100000, 1, [](std::size_t index, FastRandom&, Literature&) {
+            if (index == 50000) throw std::runtime_error("fill failed");
+        }, StreamOptions(), two);
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    assert(thrown);
+
+    std::cout << " PASSED" << std::endl;
+}
+
+void testLogger() {
+    std::cout << "Test 31: Async logger...";
+
+    // Levels, formatting and destinations; order is kept across both streams
+    {
+        std::ostringstream out, err;
+        Logger log(out, err, 64, std::chrono::hours(1));
+        log.Debug("hidden");
+        log.Info("Kept ", std::size_t(42), " books with the lowest ", 0.1 * 100.0, "% and ", -7, ' ', 2.5);
+        log.Error("Error: ", std::string("bad"));
+        log.SetLevel(LogLevel::Debug);
+        log.Debug("shown");
+        log.Info(std::string(500, 'x'));
+        log.Flush();
+        assert(err.str() == "Error: bad\n");
+        std::string expected = "Kept 42 books with the lowest 10% and -7 2.5\nshown\n" +
+                               std::string(Logger::kMessageBytes - 3, 'x') + "...\n";
+        assert(out.str() == expected);
+
+        log.SetLevel(LogLevel::Off);
+        log.Error("silenced");
+        log.SetLevel(LogLevel::Info);
+        log.SetDecorate(true);
+        log.Warning("decorated");
+        log.Flush();
+        std::string line = err.str().substr(std::string("Error: bad\n").size());
+        assert(line.size() == 25 + std::string("WARNING decorated\n").size());
+        assert(line[4] == '-' && line[10] == 'T' && line[23] == 'Z' && line.substr(25) == "WARNING decorated\n");
+        LogLevel level;
+        assert(ParseLogLevel("Warning", level) && level == LogLevel::Warning && !ParseLogLevel("loud", level));
+    }
+
+    // A full buffer and the rate limit drop messages, counted and reported; errors pass the limit
+    {
+        std::ostringstream out, err;
+        Logger log(out, err, 8, std::chrono::hours(1));
+        for (int i = 0; i < 20; ++i) {
+            log.Info("message ", i);
+        }
+        assert(log.Dropped() == 12);
+        log.Flush();
+        assert(out.str().find("message 7\n") != std::string::npos && out.str().find("message 8") == std::string::npos);
+        assert(err.str() == "Logger: 12 messages dropped, buffer full\n");
+
+        log.SetRateLimit(3);
+        for (int i = 0; i < 6; ++i) {
+            log.Info("limited ", i);
+        }
+        log.Error("urgent");
+        log.Flush();
+        // A one-second window may start inside the loop
+        assert(log.Suppressed() <= 3 && err.str().find("urgent\n") != std::string::npos);
+        assert(log.Suppressed() == 0 || err.str().find("suppressed by the rate limit") != std::string::npos);
+    }
+
+    // Many producers, one flush thread: every message arrives whole or is counted as dropped
+    {
+        std::ostringstream out, err;
+        const int threads = 4, messages = 5000;
+        std::size_t lines = 0;
+        {
+            Logger log(out, err, 1024, std::chrono::milliseconds(1));
+            std::vector<std::thread> producers;
+            for (int t = 0; t < threads; ++t) {
+                producers.emplace_back([&log, t]() {
+                    for (int i = 0; i < messages; ++i) {
+                        log.Info("producer ", t, " message ", i);
+                    }
+                });
+            }
+            for (auto& producer : producers) {
+                producer.join();
+            }
+            log.Flush();
+            std::istringstream written(out.str());
+            std::string line;
+            std::vector<int> last(threads, -1);
+            while (std::getline(written, line)) {
+                int t = -1, i = -1;
+                assert(std::sscanf(line.c_str(), "producer %d message %d", &t, &i) == 2);
+                assert(t >= 0 && t < threads && i > last[t]);  // In order per producer
+                last[t] = i;
+                ++lines;
+            }
+            assert(lines + log.Dropped() == static_cast<std::size_t>(threads * messages));
+        }
+    }
+
+    std::cout << " PASSED" << std::endl;
+}
+
+void testServerConcurrency() {
+    std::cout << "Test 32: Server reader-writer locking...";
+
+    // Commands from many threads at once, as httplib's workers issue them
+    Logger::Shared().SetLevel(LogLevel::Warning);
+    auto server = std::make_unique<JSONServer>(0);
+    assert(server->IndexField("Year"));
+    auto command = [&server](const std::string& name, const std::vector<std::string>& params) {
+        return server->ProcessCommand({{"Command", name}, {"Param", params}});
+    };
+    assert(command("generate_workload", {"5000", R"({"Years": [{"Min": 1900, "Max": 1999}]})"})["Result"] == 1);
+    // Tombstones below the compaction ratio: save_snapshot then freezes the live store
+    std::size_t deleted = command("query", {"Year = 1950"})["Count"];
+    assert(deleted > 0 && command("delete_where", {"Year = 1950"})["Result"] == 1);
+    const std::size_t initial = 5000 - deleted;
+    json sample = command("query", {"Year >= 1900", "50"});
+    std::vector<std::string> ids;
+    for (const auto& item : sample["Items"]) {
+        ids.push_back(item["ID"]);
+    }
+    assert(JSONServer::IsReadOnly("query") && !JSONServer::IsReadOnly("add") && ids.size() == 50);
+    assert(!JSONServer::IsReadOnly("save_snapshot"));
+
+    const int writers = 2, readers = 4, adds = 150;
+    std::atomic<int> writing{writers};
+    std::atomic<int> failures{0};
+    std::atomic<std::size_t> reads{0};
+    std::vector<std::thread> threads;
+    for (int w = 0; w < writers; ++w) {
+        threads.emplace_back([&, w]() {
+            for (int i = 0; i < adds; ++i) {
+                std::string year = std::to_string(3000 + w);
+                bool ok = command("add", {"author:Stress " + std::to_string(w), "name:Stress", "year:" + year,
+                                          "publisher:Load", "rating:5"})["Result"] == 1;
+                // A delete of nothing, and generated records the readers' condition never matches
+                ok = ok && command("delete_where", {"Name = Nothing"})["Result"] == 1;
+                ok = ok && (i % 50 != 0 || command("generate_ex", {"100"})["Result"] == 1);
+                failures += !ok;
+            }
+            --writing;
+        });
+    }
+    threads.emplace_back([&]() {
+        while (writing > 0) {
+            failures += command("save_snapshot", {"test_server.snapshot"})["Result"] != 1;
+        }
+    });
+    for (int r = 0; r < readers; ++r) {
+        threads.emplace_back([&, r]() {
+            // Writers only add stress records, so every reader sees their count grow
+            std::size_t seen = 0;
+            while (writing > 0) {
+                json stress = command("query", {"Year >= 3000"});
+                std::size_t count = stress["Count"];
+                bool ok = stress["Result"] == 1 && count >= seen && stress["Items"].size() == count;
+                for (const auto& item : stress["Items"]) {
+                    ok = ok && item["Name"] == "Stress" && item["Year"] >= 3000 && item.contains("ID");
+                }
+                seen = count;
+                json found = command(r % 2 ? "get_by_id" : "resolve_ids", ids);
+                ok = ok && found["Result"] == 1 && found["Found"] == ids.size();
+                json view = command("execute_view", {"Rating", "0.1", "0.1", "5"});
+                ok = ok && view["Result"] == 1 && view["Items"].size() <= 5;
+                failures += !ok;
+                ++reads;
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    assert(failures == 0 && reads > 0);
+
+    // Every write landed exactly once
+    json stress = command("query", {"Year >= 3000"});
+    assert(stress["Count"] == writers * adds);
+    std::set<std::string> unique;
+    for (const auto& item : stress["Items"]) {
+        unique.insert(item["ID"].get<std::string>());
+    }
+    assert(unique.size() == static_cast<std::size_t>(writers * adds));
+    std::size_t total = initial + writers * adds + writers * (adds / 50) * 100;
+    assert(command("query", {"Year >= 0"})["Count"] == total);
+    assert(command("save_snapshot", {"test_server.snapshot"})["Result"] == 1);
+    LiteratureStore saved;
+    std::string error;
+    assert(LiteratureSnapshot::Open("test_server.snapshot", saved, error, true) && saved.Count() == total);
+    std::remove("test_server.snapshot");
+    server.reset();
+    Logger::Shared().Flush();
+    Logger::Shared().SetLevel(LogLevel::Info);
+
+    std::cout << " PASSED" << std::endl;
+}
+
+// Test 33: Server write-ahead logging
+void testServerWal() {
+    std::cout << "Test 33: Server write-ahead log...";
+
+    Logger::Shared().SetLevel(LogLevel::Warning);
+    std::remove("test_server.wal");
+    auto command = [](JSONServer& server, const std::string& name, const std::vector<std::string>& params) {
+        return server.ProcessCommand({{"Command", name}, {"Param", params}});
+    };
+    {
+        JSONServer server(0);
+        assert(server.EnableWal("test_server.wal", WalOptions()));
+        assert(command(server, "generate_ex", {"10000"})["Result"] == 1);
+        assert(command(server, "add", {"name:Logged", "year:1999"})["Result"] == 1);
+    }
+
+    // Generated records are logged by value in bounded entries
+    std::size_t entries = 0, largest = 0, records = 0;
+    {
+        WriteAheadLog wal;
+        std::string error;
+        assert(wal.Open("test_server.wal", [&](const json& entry) {
+            ++entries;
+            largest = std::max(largest, entry["Items"].size());
+            records += entry["Items"].size();
+        }, error));
+    }
+    assert(entries > 2 && records == 10001 && largest < 10000);
+
+    {
+        JSONServer replayed(0);
+        assert(replayed.EnableWal("test_server.wal", WalOptions()));
+        assert(command(replayed, "compact", {})["Records"] == 10001);
+        assert(command(replayed, "query", {"Name = Logged"})["Count"] == 1);
+
+        // An input is logged by value: the replay does not need the file
+        createTestDataFile("test_server_input.json");
+        assert(command(replayed, "input", {"test_server_input.json"})["Result"] == 1);
+        assert(command(replayed, "add", {"name:After input"})["Result"] == 1);
+        std::remove("test_server_input.json");
+    }
+    {
+        JSONServer replayed(0);
+        assert(replayed.EnableWal("test_server.wal", WalOptions()));
+        assert(command(replayed, "compact", {})["Records"] == 11);
+        assert(command(replayed, "query", {"Name = Logged"})["Count"] == 0);
+
+        // load_snapshot verifies the checksums, so a damaged name is not served
+        assert(command(replayed, "save_snapshot", {"test_server.snapshot"})["Result"] == 1);
+        std::fstream damaged("test_server.snapshot", std::ios::in | std::ios::out | std::ios::binary);
+        std::string bytes((std::istreambuf_iterator<char>(damaged)), std::istreambuf_iterator<char>());
+        damaged.seekp(static_cast<std::streamoff>(bytes.find("Test Book 5")));
+        damaged.write("Fake", 4);
+        damaged.close();
+        Logger::Shared().SetLevel(LogLevel::Off);
+        assert(command(replayed, "load_snapshot", {"test_server.snapshot"})["Result"] == 1);
+        Logger::Shared().SetLevel(LogLevel::Warning);
+        assert(command(replayed, "query", {"Name = 'Test Book 5'"})["Count"] == 1);
+        assert(command(replayed, "compact", {})["Records"] == 11);
+        std::remove("test_server.snapshot");
+    }
+
+    {
+        // An entry too large for the log is not applied silently: the log
+        // fails and later changes are rejected
+        std::remove("test_server.wal");
+        WalOptions small;
+        small.MaxEntryBytes = 256;
+        JSONServer limited(0);
+        assert(limited.EnableWal("test_server.wal", small));
+        Logger::Shared().SetLevel(LogLevel::Off);
+        assert(command(limited, "add", {"name:Short"})["Result"] == 1);
+        assert(command(limited, "add", {"name:" + std::string(1000, 'L')})["Result"] == 0);
+        assert(command(limited, "add", {"name:Rejected"})["Result"] == 0);
+        assert(command(limited, "query", {"Name = Rejected"})["Count"] == 0);
+        Logger::Shared().Flush();
+        Logger::Shared().SetLevel(LogLevel::Warning);
+    }
+    {
+        JSONServer replayed(0);
+        assert(replayed.EnableWal("test_server.wal", WalOptions()));
+        assert(command(replayed, "compact", {})["Records"] == 1);
+    }
+
+#ifdef __linux__
+    {
+        // Log writes fail past a file size limit: the change that hit the
+        // failure is reported, later changes are rejected instead of being
+        // applied unlogged
+        std::remove("test_server.wal");
+        JSONServer full(0);
+        assert(full.EnableWal("test_server.wal", WalOptions()));
+        Logger::Shared().SetLevel(LogLevel::Off);
+        rlimit saved;
+        getrlimit(RLIMIT_FSIZE, &saved);
+        rlimit limit = saved;
+        limit.rlim_cur = 1;
+        std::signal(SIGXFSZ, SIG_IGN);
+        setrlimit(RLIMIT_FSIZE, &limit);
+        bool unlogged = command(full, "add", {"name:Unlogged"})["Result"] == 0;
+        setrlimit(RLIMIT_FSIZE, &saved);
+        std::signal(SIGXFSZ, SIG_DFL);
+        assert(unlogged);
+        assert(command(full, "add", {"name:Rejected"})["Result"] == 0);
+        assert(command(full, "generate_ex", {"10"})["Result"] == 0);
+        assert(command(full, "query", {"Name = Rejected"})["Count"] == 0);
+        assert(command(full, "compact", {})["Records"] == 1);
+        Logger::Shared().Flush();
+        Logger::Shared().SetLevel(LogLevel::Warning);
+    }
+#endif
+
+    std::remove("test_server.wal");
+    Logger::Shared().Flush();
+    Logger::Shared().SetLevel(LogLevel::Info);
+
+    std::cout << " PASSED" << std::endl;
+}
+
 // Main test runner
 int main(int argc, char* argv[]) {
     std::cout << "=== Running JSONHandler Tests ===" << std::endl;
@@ -257,7 +1991,33 @@ int main(int argc, char* argv[]) {
         testSaveLoad();
         testEdgeCases();
         testLiteratureConversion();
-
+        testLiteratureStore();
+        testSaxLoader();
+        testMappedFile();
+        testParallelLoader();
+        testNdjson();
+        testBinaryFormats();
+        testSnapshot();
+        testWriteAheadLog();
+        testCheckpoint();
+        testPercentileBand();
+        testRatingIndex();
+        testExecuteView();
+        testRecordPredicate();
+        testSecondaryIndexes();
+        testIdIndex();
+        testIdValidation();
+        testIdAllocator();
+        testTombstones();
+        testAuthorIndex();
+        testParallelGenerate();
+        testWorkloadGenerator();
+        testStreamLiterature();
+        testLogger();
+        testServerConcurrency();
+        testServerWal();
+
+        Logger::Shared().Flush();
         std::cout << std::endl << "=== All Tests PASSED ===" << std::endl;
         std::cout << "Ready for coverage analysis with gcov/lcov" << std::endl;
 
@@ -270,4 +2030,4 @@ int main(int argc, char* argv[]) {
         std::cerr << "Test failed with exception: " << e.what() << std::endl;
         return 1;
     }
-}
\ No newline at end of file
+}
@@ -0,0 +1,119 @@
+/**
+ * @file generate_dataset.cpp
+ * @brief Streams a synthetic dataset straight to a file
+ * @details Usage: generate_dataset OUTPUT COUNT [--format json|ndjson|cbor|msgpack|ubjson]
+ * [--spec FILE] [--seed N] [--threads N] [--chunk N] [--first-id N]
+ *
+ * Records follow a workload spec (defaults of WorkloadSpec without --spec)
+ * and are generated and written by StreamLiterature(), so memory stays at a
+ * few chunks however many records are written. The format defaults to the
+ * extension of OUTPUT, then to JSON.
+ */
+
+#include "../inc/literature_generator.h"
+#include "../inc/workload_generator.h"
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+
+void PrintUsage(const char* program) {
+    std::cerr << "Usage: " << program << " OUTPUT COUNT [--format json|ndjson|cbor|msgpack|ubjson]"
+              << " [--spec FILE] [--seed N] [--threads N] [--chunk N] [--first-id N]" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+    std::string output = argv[1];
+    std::uint64_t count = std::stoull(argv[2]);
+    DataFormat format = FormatFromExtension(output);
+    std::string specPath;
+    bool seedGiven = false;
+    std::uint64_t seed = 0;
+    std::size_t threads = 0;
+    StreamOptions options;
+
+    for (int i = 3; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--format" && hasValue) {
+            if (!ParseDataFormat(argv[++i], format)) {
+                PrintUsage(argv[0]);
+                return 1;
+            }
+        } else if (arg == "--spec" && hasValue) {
+            specPath = argv[++i];
+        } else if (arg == "--seed" && hasValue) {
+            seed = std::stoull(argv[++i]);
+            seedGiven = true;
+        } else if (arg == "--threads" && hasValue) {
+            threads = std::stoul(argv[++i]);
+        } else if (arg == "--chunk" && hasValue) {
+            options.ChunkRecords = std::stoul(argv[++i]);
+        } else if (arg == "--first-id" && hasValue) {
+            options.FirstNumber = std::stoull(argv[++i]);
+        } else {
+            PrintUsage(argv[0]);
+            return 1;
+        }
+    }
+    if (format == DataFormat::Auto) {
+        format = DataFormat::Json;
+    }
+
+    WorkloadSpec spec;
+    std::string error;
+    if (!specPath.empty() && !WorkloadSpec::Load(specPath, spec, error)) {
+        std::cerr << error << std::endl;
+        return 1;
+    }
+    if (seedGiven) {
+        spec.Seed = seed;
+    }
+    WorkloadGenerator workload(spec);
+
+    std::ofstream out(output, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        std::cerr << "Cannot open " << output << std::endl;
+        return 1;
+    }
+
+    // Progress about once a second on stderr, the summary on stdout
+    auto lastReport = std::chrono::steady_clock::now();
+    options.Progress = [&](const StreamStats& stats) {
+        auto now = std::chrono::steady_clock::now();
+        if (now - lastReport >= std::chrono::seconds(1)) {
+            lastReport = now;
+            std::cerr << "\r" << stats.Records << " / " << count << " records, " << std::fixed
+                      << std::setprecision(1) << stats.MegabytesPerSecond() << " MB/s" << std::flush;
+        }
+    };
+
+    std::unique_ptr<ThreadPool> ownPool;
+    if (threads > 0) {
+        ownPool = std::make_unique<ThreadPool>(threads);
+    }
+    ThreadPool& pool = ownPool ? *ownPool : ThreadPool::Shared();
+    StreamStats stats = StreamLiterature(out, format, count, spec.Seed, [&workload](std::size_t index, FastRandom&,
+                                                                                  Literature& lit) {
+        workload.Record(index, lit);
+    }, options, pool);
+    out.close();
+
+    std::cerr << "\r";
+    if (stats.Records != count || !out) {
+        std::cerr << "Write to " << output << " failed after " << stats.Records << " records" << std::endl;
+        return 1;
+    }
+    std::cout << "Wrote " << stats.Records << " records (" << DataFormatName(format) << ", " << std::fixed
+              << std::setprecision(1) << stats.Bytes / double(1 << 20) << " MB) to " << output << " in "
+              << std::setprecision(2) << stats.Seconds << " s: " << std::setprecision(0)
+              << stats.RecordsPerSecond() << " records/s, " << std::setprecision(1)
+              << stats.MegabytesPerSecond() << " MB/s, " << pool.Size() << " threads" << std::endl;
+    return 0;
+}